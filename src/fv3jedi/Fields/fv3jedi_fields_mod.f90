@@ -63,6 +63,7 @@ type :: fv3jedi_fields
     procedure, public :: to_fieldset
     procedure, public :: from_fieldset
     procedure, public :: update_fields
+    procedure, public :: swap_fields
     procedure, public :: synchronize_interface_fields  ! Update inteface-specific fields
 
     ! Public array/field accessor functions
@@ -405,29 +406,12 @@ type(fv3jedi_geom),    intent(in)    :: geom
 type(oops_variables),  intent(in)    :: vars
 type(atlas_fieldset),  intent(inout) :: afieldset
 
-integer :: jvar, jl
+integer :: jvar, jl, jn
 type(fv3jedi_field), pointer :: field
 real(kind=kind_real), pointer :: ptr(:,:)
 type(atlas_field) :: afield
 type(atlas_metadata) :: meta
 
-! Variables needed to handle boundary-condition grid points in a regional grid
-integer :: max_npz, ngrid, dummy_ntris, dummy_nquads
-real(kind=kind_real), allocatable :: tmp(:,:,:)
-
-! To allocate tmp just once, we need the max number of levels
-max_npz = -1
-do jvar = 1, vars%nvars()
-  call self%get_field(trim(vars%variable(jvar)), field)
-  max_npz = max(max_npz, field%npz)
-end do
-
-! Set up regional-grid variables
-if (geom%ntiles == 1) then
-  call geom%get_num_nodes_and_elements(ngrid, dummy_ntris, dummy_nquads)
-  allocate(tmp(geom%isd:geom%ied, geom%jsd:geom%jed, max_npz))
-end if
-
 do jvar = 1, vars%nvars()
 
   ! Get field
@@ -465,49 +449,15 @@ do jvar = 1, vars%nvars()
     end do
     ptr(:, geom%ngrid+1:) = 0.0_kind_real  ! Assign 0 at the atlas-generated halo points
   else if (geom%ntiles == 1) then
-    tmp = 0.0_kind_real
-    ! Fill the owned data at the center of the grid patch
-    tmp(geom%isc:geom%iec, geom%jsc:geom%jec, 1:field%npz) = field%array(:, :, :)
-    ! Manually extend data out into BC regions if BCs are detected. We do this by copying the
-    ! outermost row of points from the owned region into the BC region, filling the innermost row
-    ! of the BC region (1 point deep is enough for atlas).
-    ! TODO(): Long term, would be better to grab the actual BC's when running the model.
-    ! First, do the sides,
-    if (self%isc == 1) then  ! left edge
-      tmp(geom%isc-1, geom%jsc:geom%jec, 1:field%npz) = &
-        tmp(geom%isc, geom%jsc:geom%jec, 1:field%npz)
-    end if
-    if (self%iec == self%npx-1) then  ! right edge
-      tmp(geom%iec+1, geom%jsc:geom%jec, 1:field%npz) = &
-        tmp(geom%iec, geom%jsc:geom%jec, 1:field%npz)
-    end if
-    if (self%jsc == 1) then  ! bottom edge
-      tmp(geom%isc:geom%iec, geom%jsc-1, 1:field%npz) = &
-        tmp(geom%isc:geom%iec, geom%jsc, 1:field%npz)
-    end if
-    if (self%jec == self%npy-1) then  ! top edge
-      tmp(geom%isc:geom%iec, geom%jec+1, 1:field%npz) = &
-        tmp(geom%isc:geom%iec, geom%jec, 1:field%npz)
-    end if
-    ! Then, propagate corners diagonally,
-    if (self%isc == 1 .and. self%jsc == 1) then  ! bottom-left corner
-      tmp(geom%isc-1, geom%jsc-1, 1:field%npz) = tmp(geom%isc, geom%jsc, 1:field%npz)
-    end if
-    if (self%iec == self%npx-1 .and. self%jsc == 1) then  ! bottom-right corner
-      tmp(geom%iec+1, geom%jsc-1, 1:field%npz) = tmp(geom%iec, geom%jsc, 1:field%npz)
-    end if
-    if (self%isc == 1 .and. self%jec == self%npy-1) then  ! top-left corner
-      tmp(geom%isc-1, geom%jec+1, 1:field%npz) = tmp(geom%isc, geom%jec, 1:field%npz)
-    end if
-    if (self%iec == self%npx-1 .and. self%jec == self%npy-1) then  ! top-right corner
-      tmp(geom%iec+1, geom%jec+1, 1:field%npz) = tmp(geom%iec, geom%jec, 1:field%npz)
-    end if
-
-    ! First, assign the entire atlas Field to 0. Then, use the subroutine fv3_nodes_to_atlas_nodes
-    ! to fill the owned and BC points into the atlas array in the correct order
+    ! The owned points and the boundary-condition points (filled by extending the outermost row
+    ! of owned data) are gathered with the map precomputed by the geometry. Atlas ghost points
+    ! are not in the map and are left at 0.
     ptr = 0.0_kind_real
     do jl=1, field%npz
-      call geom%fv3_nodes_to_atlas_nodes(tmp(:, :, jl), ptr(jl, 1:ngrid))
+      do jn=1, size(geom%atlas_gather_node)
+        ptr(jl, geom%atlas_gather_node(jn)) = &
+          field%array(geom%atlas_gather_i(jn), geom%atlas_gather_j(jn), jl)
+      end do
     end do
   end if
 
@@ -527,9 +477,6 @@ do jvar = 1, vars%nvars()
 
 enddo
 
-! Clean up
-if (allocated(tmp)) deallocate(tmp)
-
 end subroutine to_fieldset
 
 ! --------------------------------------------------------------------------------------------------
@@ -644,6 +591,42 @@ end subroutine update_fields
 
 ! --------------------------------------------------------------------------------------------------
 
+!> Exchange the fields of two objects without copying any field data
+subroutine swap_fields(self, other)
+
+implicit none
+
+class(fv3jedi_fields), intent(inout) :: self
+class(fv3jedi_fields), intent(inout) :: other
+
+type(fv3jedi_field), allocatable :: fields_tmp(:)
+integer :: itmp
+logical :: ltmp
+
+call move_alloc(self%fields, fields_tmp)
+call move_alloc(other%fields, self%fields)
+call move_alloc(fields_tmp, other%fields)
+
+itmp = self%nf
+self%nf = other%nf
+other%nf = itmp
+
+itmp = self%ntracers
+self%ntracers = other%ntracers
+other%ntracers = itmp
+
+itmp = self%ninterface_specific
+self%ninterface_specific = other%ninterface_specific
+other%ninterface_specific = itmp
+
+ltmp = self%interface_fields_are_out_of_date
+self%interface_fields_are_out_of_date = other%interface_fields_are_out_of_date
+other%interface_fields_are_out_of_date = ltmp
+
+end subroutine swap_fields
+
+! --------------------------------------------------------------------------------------------------
+
 logical function has_field_(self, field_name, field_index)
 
 class(fv3jedi_fields), intent(in)  :: self
@@ -6,6 +6,9 @@
  */
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <string>
 
 #include "atlas/field.h"
 #include "atlas/functionspace.h"
@@ -15,6 +18,8 @@
 #include "atlas/mesh/MeshBuilder.h"
 #include "atlas/output/Gmsh.h"
 
+#include "eckit/config/LocalConfiguration.h"
+
 #include "oops/mpi/mpi.h"
 #include "oops/util/abor1_cpp.h"
 #include "oops/util/Logger.h"
@@ -23,6 +28,8 @@
 #include "fv3jedi/Geometry/GeometryParameters.h"
 #include "fv3jedi/Geometry/TimeInvariantFieldsHelpers.h"
 #include "fv3jedi/GeometryIterator/GeometryIterator.interface.h"
+#include "fv3jedi/State/State.h"
+#include "fv3jedi/State/State.interface.h"
 
 // -------------------------------------------------------------------------------------------------
 
@@ -30,8 +37,20 @@ namespace fv3jedi {
 
 // -------------------------------------------------------------------------------------------------
 
+namespace {
+
+// Next Geometry instance identity
+std::uint64_t nextGeometryInstanceId() {
+  static std::atomic<std::uint64_t> next{0};
+  return ++next;
+}
+
+}  // namespace
+
+// -------------------------------------------------------------------------------------------------
+
 Geometry::Geometry(const eckit::Configuration & config, const eckit::mpi::Comm & comm) :
-                   comm_(comm), ak_(), bk_() {
+                   comm_(comm), ak_(), bk_(), instanceId_(nextGeometryInstanceId()) {
   GeometryParameters params;
   params.deserialize(config);
   // Call the initialize phase, done only once.
@@ -145,15 +164,9 @@ Geometry::Geometry(const eckit::Configuration & config, const eckit::mpi::Comm &
     }
   }
 
-  // Create function space without halo, for constructing the bump interpolator from fv3jedi
-  atlas::FieldSet fs;
-  fv3jedi_geom_fill_bump_lonlat_f90(keyGeom_, fs.get());
-  const atlas::Field lonlatFieldForBump = fs.field("bump_lonlat");
-  functionSpaceForBump_ = atlas::functionspace::PointCloud(lonlatFieldForBump);
-
-  // Set function space pointers in Fortran
-  fv3jedi_geom_set_functionspace_pointer_f90(keyGeom_, functionSpace_.get(),
-                                             functionSpaceForBump_.get());
+  // Set function space pointer in Fortran. The function space without halo needed by the bump
+  // interpolator is built on request (fv3jedi_geom_mod::functionspace_for_bump).
+  fv3jedi_geom_set_functionspace_pointer_f90(keyGeom_, functionSpace_.get());
 
   // Fill geometry fields. This contains both SABER-related fields and any fields requested to be
   // read from state files in the yamls.
@@ -161,21 +174,44 @@ Geometry::Geometry(const eckit::Configuration & config, const eckit::mpi::Comm &
   // Add SABER fields
   if (params.timeInvariantFields.value() != boost::none) {
     const auto & timeInvFieldsParams = params.timeInvariantFields.value().value();
-    State timeInvState(*this, timeInvFieldsParams.stateFields.value().toConfiguration());
-    // Add fields read directly from file
-    atlas::FieldSet timeInvFieldSet{};
-    timeInvState.toFieldSet(timeInvFieldSet);
-    // Populate the atlas halos of the background time-invariant fields. This allows these fields
-    // to be used in setting up halo values of derived fields (e.g. the halo of the JEDI sea mask
-    // depends on the halo of the UFS slmsk + sheleg).
-    timeInvFieldSet.haloExchange();
-    for (const auto & f : timeInvFieldSet) {
-      fields_.add(f);
+
+    // Reuse cached fields when every task has a valid cache
+    std::string cacheFile;
+    bool fromCache = false;
+    if (timeInvFieldsParams.cacheDirectory.value() != boost::none) {
+      cacheFile = timeInvariantFieldsCacheFile(timeInvFieldsParams.cacheDirectory.value().value(),
+                                               timeInvFieldsParams.toConfiguration(),
+                                               params.toConfiguration(), comm_);
+      atlas::FieldSet cachedFieldSet{};
+      int haveCache = readTimeInvariantFieldsCache(cacheFile, functionSpace_, cachedFieldSet);
+      comm_.allReduceInPlace(haveCache, eckit::mpi::min());
+      if (haveCache) {
+        oops::Log::info() << "Geometry: time invariant fields read from cache" << std::endl;
+        for (const auto & f : cachedFieldSet) {
+          fields_.add(f);
+        }
+        fromCache = true;
+      }
     }
-    // Compute and add derived time-invariant fields
-    if (timeInvFieldsParams.derivedFields.value() != boost::none) {
-      const oops::Variables derivedFields = timeInvFieldsParams.derivedFields.value().value();
-      insertDerivedTimeInvariantFields(fields_, derivedFields);
+
+    if (!fromCache) {
+      State timeInvState(*this, timeInvFieldsParams.stateFields.value().toConfiguration());
+      // Add fields read directly from file
+      atlas::FieldSet timeInvFieldSet{};
+      timeInvState.toFieldSet(timeInvFieldSet);
+      // Populate the atlas halos of the background time-invariant fields. This allows these fields
+      // to be used in setting up halo values of derived fields (e.g. the halo of the JEDI sea mask
+      // depends on the halo of the UFS slmsk + sheleg).
+      timeInvFieldSet.haloExchange();
+      for (const auto & f : timeInvFieldSet) {
+        fields_.add(f);
+      }
+      // Compute and add derived time-invariant fields
+      if (timeInvFieldsParams.derivedFields.value() != boost::none) {
+        const oops::Variables derivedFields = timeInvFieldsParams.derivedFields.value().value();
+        insertDerivedTimeInvariantFields(fields_, derivedFields);
+      }
+      if (!cacheFile.empty()) writeTimeInvariantFieldsCache(cacheFile, fields_);
     }
   }
   fv3jedi_geom_set_and_fill_geometry_fields_f90(keyGeom_, fields_.get());
@@ -189,13 +225,11 @@ Geometry::Geometry(const eckit::Configuration & config, const eckit::mpi::Comm &
 // -------------------------------------------------------------------------------------------------
 
 Geometry::Geometry(const Geometry & other) : comm_(other.comm_), ak_(other.ak_), bk_(other.bk_),
-nLevels_(other.nLevels_), pTop_(other.pTop_) {
+nLevels_(other.nLevels_), pTop_(other.pTop_), instanceId_(nextGeometryInstanceId()) {
   fieldsMeta_ = std::make_shared<FieldsMetadata>(*other.fieldsMeta_);
   fv3jedi_geom_clone_f90(keyGeom_, other.keyGeom_, fieldsMeta_.get());
   functionSpace_ = atlas::functionspace::NodeColumns(other.functionSpace_);
-  functionSpaceForBump_ = atlas::functionspace::PointCloud(other.functionSpaceForBump_.lonlat());
-  fv3jedi_geom_set_functionspace_pointer_f90(keyGeom_, functionSpace_.get(),
-                                             functionSpaceForBump_.get());
+  fv3jedi_geom_set_functionspace_pointer_f90(keyGeom_, functionSpace_.get());
   fields_ = atlas::FieldSet();
   for (auto & field : other.fields_) {
     fields_->add(field);
@@ -260,6 +294,25 @@ std::vector<double> Geometry::verticalCoord(std::string & vcUnits) const {
 
 // -------------------------------------------------------------------------------------------------
 
+const std::vector<double> & Geometry::verticalCoordColumns(const State & state,
+                                                           const std::string & vcUnits) const {
+  if (state.version() != vcColumnsVersion_ || vcUnits != vcColumnsUnits_) {
+    int ist, iend, jst, jend, kst, kend, npz;
+    fv3jedi_geom_start_end_f90(keyGeom_, ist, iend, jst, jend, kst, kend, npz);
+    const size_t size = static_cast<size_t>(npz) * (iend - ist + 1) * (jend - jst + 1);
+    vcColumns_.resize(size);
+    eckit::LocalConfiguration vcConfig;
+    vcConfig.set("vertical coordinate", vcUnits);
+    fv3jedi_state_vertical_coord_f90(state.toFortran(), keyGeom_, vcConfig, size,
+                                     vcColumns_.data());
+    vcColumnsVersion_ = state.version();
+    vcColumnsUnits_ = vcUnits;
+  }
+  return vcColumns_;
+}
+
+// -------------------------------------------------------------------------------------------------
+
 std::vector<size_t> Geometry::variableSizes(const oops::Variables & vars) const {
   // Array of level heights
   std::vector<size_t> varSizes;
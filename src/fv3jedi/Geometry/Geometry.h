@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <ostream>
 #include <string>
@@ -32,6 +33,7 @@ namespace oops {
 
 namespace fv3jedi {
   class GeometryIterator;
+  class State;
 
 // -------------------------------------------------------------------------------------------------
 /// Geometry handles geometry for FV3JEDI model.
@@ -49,12 +51,17 @@ class Geometry : public util::Printable,
 
   // For use by other fv3jedi code
   bool isEqual(const Geometry &) const;
+  // Process-unique identity of this instance, never reused by another Geometry
+  std::uint64_t instanceId() const {return instanceId_;}
 
   bool levelsAreTopDown() const {return true;}
 
   GeometryIterator begin() const;
   GeometryIterator end() const;
   std::vector<double> verticalCoord(std::string &) const;
+  // Vertical coordinate of every local column of a state, levels fastest. Recomputed only when the
+  // state version or the units differ from the last call.
+  const std::vector<double> & verticalCoordColumns(const State &, const std::string &) const;
 
   F90geom & toFortran() {return keyGeom_;}
   const F90geom & toFortran() const {return keyGeom_;}
@@ -93,8 +100,6 @@ class Geometry : public util::Printable,
   F90geom keyGeom_;
   const eckit::mpi::Comm & comm_;
   atlas::FunctionSpace functionSpace_;
-  // temporary hack: FunctionSpace without halos for calling BUMP interpolation from within fv3jedi
-  atlas::FunctionSpace functionSpaceForBump_;
   atlas::FieldSet fields_;
   std::shared_ptr<FieldsMetadata> fieldsMeta_;
   std::vector<double> ak_;
@@ -102,6 +107,10 @@ class Geometry : public util::Printable,
   int tileNum_;
   int nLevels_;
   double pTop_;
+  std::uint64_t instanceId_;
+  mutable size_t vcColumnsVersion_ = 0;
+  mutable std::string vcColumnsUnits_;
+  mutable std::vector<double> vcColumns_;
 };
 // -------------------------------------------------------------------------------------------------
 
@@ -33,9 +33,7 @@ extern "C" {
   void fv3jedi_geom_setup_f90(F90geom &, const eckit::Configuration &,
                              const eckit::mpi::Comm *, int &, int &);
   void fv3jedi_geom_addfmd_f90(F90geom &, FieldsMetadata *);
-  void fv3jedi_geom_fill_bump_lonlat_f90(const F90geom &, atlas::field::FieldSetImpl *);
   void fv3jedi_geom_set_functionspace_pointer_f90(const F90geom &,
-                                                  atlas::functionspace::FunctionSpaceImpl *,
                                                   atlas::functionspace::FunctionSpaceImpl *);
   void fv3jedi_geom_set_and_fill_geometry_fields_f90(const F90geom &, atlas::field::FieldSetImpl *);
   void fv3jedi_geom_clone_f90(F90geom &, const F90geom &, const FieldsMetadata *);
@@ -47,6 +45,8 @@ extern "C" {
   void fv3jedi_geom_verticalCoord_f90(const F90geom &, double &, int &, double &);
   int fv3jedi_geom_iterator_dimension_f90(const F90geom &, int &);
   void fv3jedi_geom_get_data_f90(const F90geom &, const int &, double *, double *, double &);
+  void fv3jedi_geom_halo_update_timing_f90(const F90geom &, const int &, const int *, const int &,
+                                           double &);
 
   void fv3jedi_geom_get_num_nodes_and_elements_f90(const F90geom &, int &, int &, int &);
   void fv3jedi_geom_get_coords_and_connectivities_f90(const F90geom &,
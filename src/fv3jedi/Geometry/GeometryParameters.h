@@ -46,6 +46,9 @@ class TimeInvariantFieldsParameters : public oops::Parameters {
  public:
   oops::RequiredParameter<StateParameters> stateFields{ "state fields", this };
   oops::OptionalParameter<oops::Variables> derivedFields{ "derived fields", this };
+  // Directory for a per-task cache of the (read and derived) fields, reused by later Geometry
+  // constructions with the same inputs
+  oops::OptionalParameter<std::string> cacheDirectory{ "cache directory", this };
 };
 
 // -------------------------------------------------------------------------------------------------
@@ -70,6 +73,8 @@ class GeometryParameters : public oops::Parameters {
   oops::OptionalParameter<int> npy{ "npy", this};
   oops::OptionalParameter<int> npz{ "npz", this};
   oops::Parameter<int> iterator_dimension{ "iterator dimension", 2, this};
+  // OpenMP threads per task for the column kernels of the variable change utilities
+  oops::Parameter<int> nthreads{ "number of threads", 1, this};
   oops::Parameter<int> nwat{ "nwat", 1, this};
   oops::OptionalParameter<TimeInvariantFieldsParameters> timeInvariantFields{
     "time invariant fields", this};
@@ -7,12 +7,28 @@
 
 #include "fv3jedi/Geometry/TimeInvariantFieldsHelpers.h"
 
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
 #include "atlas/field.h"
 #include "atlas/functionspace.h"
 
+#include "eckit/config/Configuration.h"
 #include "eckit/exception/Exceptions.h"
+#include "eckit/mpi/Comm.h"
 
 #include "oops/base/Variables.h"
+#include "oops/util/Logger.h"
 
 namespace fv3jedi {
 
@@ -129,4 +145,199 @@ void insertDerivedTimeInvariantFields(atlas::FieldSet & fset,
   }
 }
 
+// -------------------------------------------------------------------------------------------------
+
+namespace {
+
+constexpr char cacheMagic[8] = {'F', 'V', '3', 'J', 'T', 'I', 'F', '1'};
+
+// 64-bit FNV-1a, only used to label cache files
+void hashAppend(std::uint64_t & hash, const std::string & str) {
+  for (const char c : str) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+}
+
+// Fold in size and modification time of the files of datapath whose name contains fileName
+// (this also catches tiled and date-prepended files). Size and mtime are used rather than a
+// checksum of the contents so that a cache hit does not have to read the input files; an input
+// rewritten with the same size within the file system's mtime resolution is not detected.
+void hashInputFiles(std::uint64_t & hash, const std::string & datapath,
+                    const std::string & fileName) {
+  namespace fs = std::filesystem;
+  const std::string stem = fs::path(fileName).stem().string();
+  std::error_code ec;
+  for (const auto & entry : fs::directory_iterator(datapath, ec)) {
+    const std::string name = entry.path().filename().string();
+    if (!entry.is_regular_file(ec) || name.find(stem) == std::string::npos) continue;
+    hashAppend(hash, name);
+    hashAppend(hash, std::to_string(entry.file_size(ec)));
+    hashAppend(hash, std::to_string(entry.last_write_time(ec).time_since_epoch().count()));
+  }
+}
+
+void writeString(std::ofstream & out, const std::string & str) {
+  const std::uint64_t len = str.size();
+  out.write(reinterpret_cast<const char *>(&len), sizeof(len));
+  out.write(str.data(), len);
+}
+
+// Reader of the cache file that never reads past its end
+class CacheReader {
+ public:
+  CacheReader(std::ifstream & in, const size_t size) : in_(in), remaining_(size) {}
+  bool read(void * dest, const size_t nbytes) {
+    if (nbytes > remaining_) return false;
+    in_.read(static_cast<char *>(dest), nbytes);
+    remaining_ -= nbytes;
+    return static_cast<bool>(in_);
+  }
+  bool read(std::string & str) {
+    std::uint64_t len;
+    if (!read(&len, sizeof(len)) || len > remaining_) return false;
+    str.resize(len);
+    return read(&str[0], len);
+  }
+ private:
+  std::ifstream & in_;
+  size_t remaining_;
+};
+
+}  // namespace
+
+// -------------------------------------------------------------------------------------------------
+
+std::string timeInvariantFieldsCacheFile(const std::string & cacheDirectory,
+                                         const eckit::Configuration & timeInvConfig,
+                                         const eckit::Configuration & geomConfig,
+                                         const eckit::mpi::Comm & comm) {
+  std::uint64_t hash = 14695981039346656037ULL;
+
+  std::ostringstream configs;
+  configs << timeInvConfig << geomConfig;
+  hashAppend(hash, configs.str());
+  hashAppend(hash, std::to_string(comm.size()));
+
+  const eckit::LocalConfiguration stateConfig(timeInvConfig, "state fields");
+  const std::string datapath = stateConfig.getString("datapath", "./");
+  for (const std::string & key : stateConfig.keys()) {
+    if (key.rfind("filename", 0) == 0 && stateConfig.isString(key)) {
+      hashInputFiles(hash, datapath, stateConfig.getString(key));
+    }
+  }
+
+  std::ostringstream filename;
+  filename << cacheDirectory << "/fv3jedi_time_invariant_" << std::hex << std::setw(16)
+           << std::setfill('0') << hash << std::dec << "_" << std::setw(6) << comm.rank()
+           << ".bin";
+  return filename.str();
+}
+
+// -------------------------------------------------------------------------------------------------
+
+bool readTimeInvariantFieldsCache(const std::string & filename,
+                                  const atlas::FunctionSpace & fspace,
+                                  atlas::FieldSet & fset) {
+  std::error_code ec;
+  const std::uintmax_t size = std::filesystem::file_size(filename, ec);
+  if (ec || size == 0) return false;
+  std::ifstream in(filename, std::ios::binary);
+  if (!in.is_open()) return false;
+
+  // Field data is read straight into the atlas fields
+  CacheReader reader(in, size);
+  atlas::FieldSet cached;
+  bool valid = true;
+
+  char magic[8];
+  std::uint64_t nfields = 0;
+  valid = reader.read(magic, sizeof(magic)) && std::memcmp(magic, cacheMagic, sizeof(magic)) == 0
+          && reader.read(&nfields, sizeof(nfields));
+
+  for (std::uint64_t jf = 0; valid && jf < nfields; ++jf) {
+    std::string name, interpType, mask;
+    std::uint64_t npoints = 0, nlevels = 0;
+    valid = reader.read(name) && reader.read(interpType) && reader.read(mask)
+            && reader.read(&npoints, sizeof(npoints)) && reader.read(&nlevels, sizeof(nlevels))
+            && npoints == static_cast<std::uint64_t>(fspace.size());
+    if (!valid) break;
+
+    atlas::Field field = fspace.createField<double>(atlas::option::name(name)
+                                                   | atlas::option::levels(nlevels));
+    auto view = atlas::array::make_view<double, 2>(field);
+    valid = reader.read(view.data(), npoints*nlevels*sizeof(double));
+    if (!interpType.empty()) field.metadata().set("interp_type", interpType);
+    if (!mask.empty()) field.metadata().set("mask", mask);
+    // The halos were stored
+    field.set_dirty(false);
+    cached.add(field);
+  }
+
+  if (!valid) {
+    oops::Log::warning() << "Ignoring invalid time-invariant fields cache " << filename
+                         << std::endl;
+    return false;
+  }
+  for (const auto & field : cached) {
+    fset.add(field);
+  }
+  return true;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void writeTimeInvariantFieldsCache(const std::string & filename,
+                                   const atlas::FieldSet & fset) {
+  // Write to a temporary file of this process only and rename, so that a partial file is never
+  // picked up and jobs sharing the cache directory do not write to the same file
+  std::error_code ec;
+  std::string tmpname = filename + ".XXXXXX";
+  const int fd = ::mkstemp(&tmpname[0]);
+  if (fd < 0) {
+    oops::Log::warning() << "Unable to write time-invariant fields cache " << filename
+                         << std::endl;
+    return;
+  }
+  ::close(fd);
+  std::ofstream out(tmpname, std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    oops::Log::warning() << "Unable to write time-invariant fields cache " << filename
+                         << std::endl;
+    std::filesystem::remove(tmpname, ec);
+    return;
+  }
+
+  out.write(cacheMagic, sizeof(cacheMagic));
+  const std::uint64_t nfields = fset.size();
+  out.write(reinterpret_cast<const char *>(&nfields), sizeof(nfields));
+  for (const auto & field : fset) {
+    ASSERT(field.rank() == 2);
+    writeString(out, field.name());
+    writeString(out, field.metadata().getString("interp_type", ""));
+    writeString(out, field.metadata().getString("mask", ""));
+    const std::uint64_t npoints = field.shape(0);
+    const std::uint64_t nlevels = field.shape(1);
+    out.write(reinterpret_cast<const char *>(&npoints), sizeof(npoints));
+    out.write(reinterpret_cast<const char *>(&nlevels), sizeof(nlevels));
+    const auto view = atlas::array::make_view<const double, 2>(field);
+    out.write(reinterpret_cast<const char *>(view.data()), npoints*nlevels*sizeof(double));
+  }
+  out.close();
+  if (!out) {
+    oops::Log::warning() << "Unable to write time-invariant fields cache " << filename
+                         << std::endl;
+    std::filesystem::remove(tmpname, ec);
+    return;
+  }
+  std::filesystem::rename(tmpname, filename, ec);
+  if (ec) {
+    oops::Log::warning() << "Unable to write time-invariant fields cache " << filename << ": "
+                         << ec.message() << std::endl;
+    std::filesystem::remove(tmpname, ec);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
 }  // namespace fv3jedi
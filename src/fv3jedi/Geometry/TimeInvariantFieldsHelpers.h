@@ -7,10 +7,20 @@
 
 #pragma once
 
+#include <string>
+
 namespace atlas {
 class FieldSet;
+class FunctionSpace;
 }  // namespace atlas
 
+namespace eckit {
+class Configuration;
+namespace mpi {
+class Comm;
+}  // namespace mpi
+}  // namespace eckit
+
 namespace oops {
 class Variables;
 }  // namespace oops
@@ -23,5 +33,24 @@ namespace fv3jedi {
 /// contains the varsToAdd.
 void insertDerivedTimeInvariantFields(atlas::FieldSet & fset,
                                       const oops::Variables & varsToAdd);
+
+/// Returns the per-task cache file for the time-invariant fields
+///
+/// The name encodes a checksum of the time-invariant fields and geometry configurations, of the
+/// size and modification time of the input files they refer to, and of the task decomposition.
+std::string timeInvariantFieldsCacheFile(const std::string & cacheDirectory,
+                                         const eckit::Configuration & timeInvConfig,
+                                         const eckit::Configuration & geomConfig,
+                                         const eckit::mpi::Comm & comm);
+
+/// Fills fset from a cache file, returns false (leaving fset unchanged) if the file is missing or
+/// does not match the function space
+bool readTimeInvariantFieldsCache(const std::string & filename,
+                                  const atlas::FunctionSpace & fspace,
+                                  atlas::FieldSet & fset);
+
+/// Writes all the fields of fset (including halos) to a cache file
+void writeTimeInvariantFieldsCache(const std::string & filename,
+                                   const atlas::FieldSet & fset);
 }  // namespace fv3jedi
 
@@ -13,7 +13,8 @@ use string_f_c_mod
 
 ! atlas uses
 use atlas_module,               only: atlas_field, atlas_fieldset, &
-                                      atlas_integer, atlas_real, atlas_functionspace
+                                      atlas_integer, atlas_real, atlas_functionspace, &
+                                      atlas_functionspace_pointcloud
 
 ! fckit uses
 use fckit_mpi_module,           only: fckit_mpi_comm
@@ -41,7 +42,8 @@ use fv3jedi_fmsnamelist_mod,    only: fv3jedi_fmsnamelist
 
 implicit none
 private
-public :: fv3jedi_geom, getVerticalCoord, getVerticalCoordLogP, initialize, pedges2pmidlayer
+public :: fv3jedi_geom, getVerticalCoord, getVerticalCoordLogP, getVerticalCoordColumns, initialize, &
+          pedges2pmidlayer
 
 ! --------------------------------------------------------------------------------------------------
 
@@ -53,6 +55,7 @@ type :: fv3jedi_geom
   integer :: layout(2), io_layout(2)                                                !Processor layouts
   integer :: ntile, ntiles                                                          !Tile number and total
   integer :: iterator_dimension                                                     !iterator dimension
+  integer :: nthreads = 1                                                           !OpenMP threads for column kernels
   real(kind=kind_real) :: ptop                                                      !Pressure at top of domain
   type(domain2D) :: domain_fix                                                      !MPP domain
   type(domain2D), pointer :: domain                                                 !MPP domain
@@ -74,6 +77,7 @@ type :: fv3jedi_geom
   type(atlas_fieldset) :: geometry_fields
   ! Vertical Coordinate
   real(kind=kind_real), allocatable, dimension(:)       :: vCoord                   !Model vertical coordinate
+  real(kind=kind_real), allocatable, dimension(:,:)     :: iter_vcoord              !Per column pressure (iterator)
   ! For D to (A to) C grid
   real(kind=kind_real), allocatable, dimension(:,:)     :: rarea
   real(kind=kind_real), allocatable, dimension(:,:,:)   :: sin_sg
@@ -94,21 +98,21 @@ type :: fv3jedi_geom
   logical :: dord4 = .true.
   type(atlas_functionspace) :: afunctionspace
 
-  ! As a temporary hack to enable using the BUMP interpolator from fv3-jedi, make an additional
-  ! FunctionSpace without halos. This should be removed as soon as the interpolations can be made
-  ! more generic
-  type(atlas_functionspace) :: afunctionspace_for_bump
+  ! Regional grids: precomputed gather from fv3 compute domain to atlas nodes, including the
+  ! extension of owned data into the boundary-condition points (atlas ghost points not listed)
+  integer, allocatable, dimension(:) :: atlas_gather_node, atlas_gather_i, atlas_gather_j
 
   contains
     procedure, public :: create
     procedure, public :: clone
     procedure, public :: delete
     procedure, public :: is_equal
-    procedure, public :: fill_bump_lonlat
+    procedure, public :: functionspace_for_bump
     procedure, public :: set_and_fill_geometry_fields
     procedure, public :: get_data
     procedure, public :: get_num_nodes_and_elements
     procedure, public :: get_coords_and_connectivities
+    procedure, public :: halo_update_timing
 
     generic, public :: fv3_nodes_to_atlas_nodes => fv3_nodes_to_atlas_nodes_r, &
                                                    fv3_nodes_to_atlas_nodes_i
@@ -119,6 +123,7 @@ type :: fv3jedi_geom
     procedure, private :: get_coords_and_connectivities_regional
     procedure, private :: fv3_nodes_to_atlas_nodes_i
     procedure, private :: fv3_nodes_to_atlas_nodes_r
+    procedure, private :: set_regional_atlas_gather
 
 end type fv3jedi_geom
 
@@ -184,6 +189,7 @@ character(len=:), allocatable :: str
 real(kind=kind_real) :: sf, t_lon, t_lat
 logical :: do_write_geom = .false.
 integer :: iterator_dimension = 2
+integer :: nthreads = 1
 
 type(fv3jedi_fmsnamelist) :: fmsnamelist
 
@@ -203,6 +209,12 @@ self%target_lat = t_lat
 call conf%get_or_die("iterator dimension", iterator_dimension)
 self%iterator_dimension = iterator_dimension
 
+! Number of OpenMP threads used by the column kernels of the variable change utilities
+! ------------------------------------------------------------------------------------
+call conf%get_or_die("number of threads", nthreads)
+if (nthreads < 1) call abor1_ftn("fv3jedi_geom_mod.create: number of threads must be positive")
+self%nthreads = nthreads
+
 ! Update the fms namelist with this Geometry
 ! ------------------------------------------
 call fmsnamelist%replace_namelist(conf)
@@ -405,6 +417,10 @@ call setup_domain( self%domain_fix, self%npx-1, self%npy-1, &
 
 self%domain => self%domain_fix
 
+! For regional grids precompute the fv3 to atlas node ordering
+! ------------------------------------------------------------
+if (self%ntiles == 1) call self%set_regional_atlas_gather()
+
 ! Optionally write the geometry to file
 ! -------------------------------------
 call conf%get_or_die("write geom",do_write_geom)
@@ -488,6 +504,7 @@ self%jed             = other%jed
 self%ntile           = other%ntile
 self%ntiles          = other%ntiles
 self%iterator_dimension = other%iterator_dimension
+self%nthreads = other%nthreads
 
 self%ptop            = other%ptop
 self%ak              = other%ak
@@ -537,7 +554,6 @@ self%nw_corner = other%nw_corner
 self%domain => other%domain
 
 self%afunctionspace = atlas_functionspace(other%afunctionspace%c_ptr())
-self%afunctionspace_for_bump = atlas_functionspace(other%afunctionspace_for_bump%c_ptr())
 
 self%geometry_fields = atlas_fieldset(other%geometry_fields%c_ptr())
 
@@ -551,6 +567,14 @@ self%bounded_domain = other%bounded_domain
 
 self%vertcoord_type = other%vertcoord_type
 
+if (allocated(other%iter_vcoord)) allocate(self%iter_vcoord, source=other%iter_vcoord)
+
+if (allocated(other%atlas_gather_node)) then
+  allocate(self%atlas_gather_node, source=other%atlas_gather_node)
+  allocate(self%atlas_gather_i, source=other%atlas_gather_i)
+  allocate(self%atlas_gather_j, source=other%atlas_gather_j)
+endif
+
 end subroutine clone
 
 ! --------------------------------------------------------------------------------------------------
@@ -599,11 +623,15 @@ deallocate(self%dya   )
 deallocate(self%lat_us)
 deallocate(self%lon_us)
 
+if (allocated(self%iter_vcoord)) deallocate(self%iter_vcoord)
+if (allocated(self%atlas_gather_node)) deallocate(self%atlas_gather_node)
+if (allocated(self%atlas_gather_i)) deallocate(self%atlas_gather_i)
+if (allocated(self%atlas_gather_j)) deallocate(self%atlas_gather_j)
+
 ! Required memory leak, since copying this causes problems
 !call mpp_deallocate_domain(self%domain_fix)
 
 call self%afunctionspace%final()
-call self%afunctionspace_for_bump%final()
 
 end subroutine delete
 
@@ -636,11 +664,16 @@ end subroutine is_equal
 
 ! --------------------------------------------------------------------------------------------------
 
-subroutine fill_bump_lonlat(self, afieldset)
+!> Function space without halo for the BUMP interpolator
+!!
+!! \details As a temporary hack to enable using the BUMP interpolator from fv3-jedi a PointCloud
+!! FunctionSpace without halos is needed. It is only used by a few applications so it is built on
+!! request rather than with every Geometry.
+function functionspace_for_bump(self) result(afunctionspace)
 
 !Arguments
-class(fv3jedi_geom),  intent(inout) :: self
-type(atlas_fieldset), intent(inout) :: afieldset
+class(fv3jedi_geom),  intent(in) :: self
+type(atlas_functionspace)        :: afunctionspace
 
 !Locals
 real(kind_real), pointer :: real_ptr(:,:)
@@ -654,9 +687,11 @@ afield = atlas_field(name="bump_lonlat", kind=atlas_real(kind_real), shape=(/2,n
 call afield%data(real_ptr)
 real_ptr(1,:) = constant('rad2deg')*reshape(self%grid_lon(self%isc:self%iec, self%jsc:self%jec),(/ngrid/))
 real_ptr(2,:) = constant('rad2deg')*reshape(self%grid_lat(self%isc:self%iec, self%jsc:self%jec),(/ngrid/))
-call afieldset%add(afield)
 
-end subroutine fill_bump_lonlat
+afunctionspace = atlas_functionspace_pointcloud(afield)
+call afield%final()
+
+end function functionspace_for_bump
 
 ! --------------------------------------------------------------------------------------------------
 
@@ -673,6 +708,7 @@ integer, pointer :: int_ptr(:,:)
 real(kind=kind_real), pointer :: real_ptr(:,:), real_ptr2(:,:)
 real(kind=kind_real) :: sigmaup, sigmadn, ps
 real(kind=kind_real) :: logp(self%npz)
+real(kind=kind_real) :: psurf(self%ngrid)
 
 ! Assign geometry_fields variable
 self%geometry_fields = afieldset
@@ -724,6 +760,22 @@ endif
 call afieldset%add(afield)
 call afield%final()
 
+! Pressure of every local column for the 3D iterator, using the nominal surface pressure when
+! available. Note: the owned points are the first ngrid values of the atlas fields.
+if (self%iterator_dimension == 3) then
+  if (afieldset%has_field('nominal_surface_pressure')) then
+    afield = afieldset%field('nominal_surface_pressure')
+    call afield%data(real_ptr)
+    psurf = real_ptr(1, 1:self%ngrid)
+    call afield%final()
+  else
+    psurf = 100000.0_kind_real
+  endif
+  if (allocated(self%iter_vcoord)) deallocate(self%iter_vcoord)
+  allocate(self%iter_vcoord(self%npz, self%ngrid))
+  call getVerticalCoordColumns(self, self%ngrid, psurf, self%iter_vcoord)
+endif
+
 end subroutine set_and_fill_geometry_fields
 
 ! --------------------------------------------------------------------------------------------------
@@ -1047,6 +1099,37 @@ subroutine getVerticalCoordLogP(self, vc, npz, psurf)
 
 end subroutine getVerticalCoordLogP
 
+!--------------------------------------------------------------------------------------------------
+subroutine getVerticalCoordColumns(self, ncol, psurf, p)
+  ! returns pressure at mid level for ncol columns at once, same as getVerticalCoord per column
+  ! but with the loop over columns innermost
+
+  type(fv3jedi_geom),   intent(in)  :: self
+  integer,              intent(in)  :: ncol
+  real(kind=kind_real), intent(in)  :: psurf(ncol)
+  real(kind=kind_real), intent(out) :: p(self%npz, ncol)
+
+  real(kind=kind_real) :: pe_up(ncol), pe_dn(ncol), pk_up(ncol), pk_dn(ncol)
+  real(kind=kind_real) :: kappa, kap1, kapr
+  integer :: k
+
+  kappa = constant('kappa')
+  kap1 = kappa + 1.0_kind_real
+  kapr = 1.0_kind_real/kappa
+
+  pe_up = self%ak(1) + self%bk(1)*psurf
+  pk_up = pe_up**kap1
+  do k = 1, self%npz
+    pe_dn = self%ak(k+1) + self%bk(k+1)*psurf
+    pk_dn = pe_dn**kap1
+    ! Philips mid-layer pressure, as in pedges2pmidlayer
+    p(k,:) = ((pk_dn - pk_up)/(kap1*(pe_dn - pe_up)))**kapr
+    pe_up = pe_dn
+    pk_up = pk_dn
+  enddo
+
+end subroutine getVerticalCoordColumns
+
 ! --------------------------------------------------------------------------------------------------
 
 subroutine get_data(self, ak, bk, ptop)
@@ -1066,6 +1149,47 @@ end subroutine get_data
 
 ! --------------------------------------------------------------------------------------------------
 
+subroutine halo_update_timing(self, nlevs, iterations, seconds)
+
+! Time the FMS halo update that the model applies to fields with the given numbers of levels
+
+use mpp_domains_mod, only: mpp_update_domains
+
+!Arguments
+class(fv3jedi_geom),  intent(in)  :: self
+integer,              intent(in)  :: nlevs(:)
+integer,              intent(in)  :: iterations
+real(kind=kind_real), intent(out) :: seconds
+
+type :: halo_field
+  real(kind=kind_real), allocatable :: array(:,:,:)
+end type halo_field
+
+type(halo_field), allocatable :: fields(:)
+integer :: n, it
+real(kind=kind_real) :: start
+
+allocate(fields(size(nlevs)))
+do n = 1, size(nlevs)
+  allocate(fields(n)%array(self%isd:self%ied,self%jsd:self%jed,nlevs(n)))
+  fields(n)%array = 0.0_kind_real
+  fields(n)%array(self%isc:self%iec,self%jsc:self%jec,:) = real(self%f_comm%rank()+1, kind_real)
+enddo
+
+start = MPI_Wtime()
+do it = 1, iterations
+  do n = 1, size(nlevs)
+    call mpp_update_domains(fields(n)%array, self%domain)
+  enddo
+enddo
+seconds = MPI_Wtime() - start
+
+deallocate(fields)
+
+end subroutine halo_update_timing
+
+! --------------------------------------------------------------------------------------------------
+
 subroutine get_num_nodes_and_elements(self, num_nodes, num_tris, num_quads)
 
   class(fv3jedi_geom),  intent(in)  :: self
@@ -1731,4 +1855,59 @@ end subroutine fv3_nodes_to_atlas_nodes_i
 
 ! --------------------------------------------------------------------------------------------------
 
+! For a regional grid, atlas treats the boundary-condition points around the patch as owned nodes,
+! while in fv3 they are halo points. When filling atlas fields these points are given the value of
+! the outermost row of owned points (corners are propagated diagonally). This routine records, for
+! every atlas node that receives data, the compute-domain (i,j) it is copied from, so that the
+! atlas interface reduces to a single indexed copy per level. Atlas ghost points are not listed.
+! TODO(): Long term, would be better to grab the actual BC's when running the model.
+subroutine set_regional_atlas_gather(self)
+
+  class(fv3jedi_geom), intent(inout) :: self
+
+  integer :: i, j, ii, jj, nx, jn, num_nodes, num_tris, num_quads
+  integer, allocatable :: fv3_index(:,:), atlas_index(:)
+
+  call self%get_num_nodes_and_elements(num_nodes, num_tris, num_quads)
+
+  ! Label fv3 points with the linear compute-domain index of the point providing their value
+  nx = self%iec - self%isc + 1
+  allocate(fv3_index(self%isd:self%ied, self%jsd:self%jed))
+  fv3_index = 0
+  do j = self%jsc-1, self%jec+1
+    if (j < self%jsc .and. self%jsc /= 1) cycle
+    if (j > self%jec .and. self%jec /= self%npy-1) cycle
+    jj = min(max(j, self%jsc), self%jec)
+    do i = self%isc-1, self%iec+1
+      if (i < self%isc .and. self%isc /= 1) cycle
+      if (i > self%iec .and. self%iec /= self%npx-1) cycle
+      ii = min(max(i, self%isc), self%iec)
+      fv3_index(i, j) = (ii - self%isc + 1) + (jj - self%jsc) * nx
+    enddo
+  enddo
+
+  ! Put the labels in atlas node order
+  allocate(atlas_index(num_nodes))
+  call self%fv3_nodes_to_atlas_nodes(fv3_index, atlas_index)
+
+  ! Keep only the nodes that receive data
+  allocate(self%atlas_gather_node(count(atlas_index > 0)))
+  allocate(self%atlas_gather_i(size(self%atlas_gather_node)))
+  allocate(self%atlas_gather_j(size(self%atlas_gather_node)))
+  jn = 0
+  do i = 1, num_nodes
+    if (atlas_index(i) > 0) then
+      jn = jn + 1
+      self%atlas_gather_node(jn) = i
+      self%atlas_gather_i(jn) = self%isc + mod(atlas_index(i) - 1, nx)
+      self%atlas_gather_j(jn) = self%jsc + (atlas_index(i) - 1) / nx
+    endif
+  enddo
+
+  deallocate(fv3_index, atlas_index)
+
+end subroutine set_regional_atlas_gather
+
+! --------------------------------------------------------------------------------------------------
+
 end module fv3jedi_geom_mod
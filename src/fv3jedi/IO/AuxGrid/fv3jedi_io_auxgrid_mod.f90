@@ -175,7 +175,7 @@ real(kind=kind_real),pointer :: lonlat_ptr(:,:)
 integer :: i, ierr, jmax
 character(len=48) :: debug_msg
 type(atlas_field) :: lonlat_field
-type(atlas_functionspace) :: afunctionspace_out
+type(atlas_functionspace) :: afunctionspace_in, afunctionspace_out
 
 ! Create output grid and interpolation object for going from cube to output grid
 ! -------------------------------------------------------------------------------
@@ -282,7 +282,11 @@ end do
 afunctionspace_out = atlas_functionspace_pointcloud(lonlat_field)
 
 ! Initialize bump interpolator
-call self%bumpinterp%init(self%comm, geom%afunctionspace_for_bump, afunctionspace_out, self%npz)
+afunctionspace_in = geom%functionspace_for_bump()
+call self%bumpinterp%init(self%comm, afunctionspace_in, afunctionspace_out, self%npz)
+call afunctionspace_in%final()
+call afunctionspace_out%final()
+call lonlat_field%final()
 
 !IO communicator
 !call MPI_Comm_split(self%comm%communicator(), color, self%comm%rank(), self%llcomm, ierr)
@@ -232,6 +232,11 @@ void Increment::fromFieldSet(const atlas::FieldSet & fset) {
   fv3jedi_increment_from_fieldset_f90(keyInc_, geom_.toFortran(), varsJedi_, fset.get());
 }
 // -------------------------------------------------------------------------------------------------
+void Increment::fromFieldSet(const oops::Variables & vars, const atlas::FieldSet & fset) {
+  const oops::Variables longVars = geom_.fieldsMetaData().getLongNameFromAnyName(vars);
+  fv3jedi_increment_from_fieldset_f90(keyInc_, geom_.toFortran(), longVars, fset.get());
+}
+// -------------------------------------------------------------------------------------------------
 void Increment::synchronizeInterfaceFields() const {
   fv3jedi_increment_synchronize_interface_fields_f90(keyInc_, geom_.toFortran());
 }
@@ -113,6 +113,8 @@ class Increment : public util::Printable,
 /// Accessors to the ATLAS fieldset
   void toFieldSet(atlas::FieldSet &) const;
   void fromFieldSet(const atlas::FieldSet &);
+  // Fill only the listed variables, leaving the other fields untouched
+  void fromFieldSet(const oops::Variables &, const atlas::FieldSet &);
 
 /// I/O and diagnostics
   void read(const eckit::Configuration &);
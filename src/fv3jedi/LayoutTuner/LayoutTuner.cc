@@ -0,0 +1,203 @@
+/*
+ * (C) Copyright 2024 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "boost/none_t.hpp"
+
+#include "atlas/field.h"
+
+#include "eckit/exception/Exceptions.h"
+
+#include "oops/util/abor1_cpp.h"
+#include "oops/util/Logger.h"
+
+#include "fv3jedi/Geometry/Geometry.h"
+#include "fv3jedi/Geometry/Geometry.interface.h"
+#include "fv3jedi/LayoutTuner/LayoutTuner.h"
+#include "fv3jedi/State/State.h"
+
+namespace fv3jedi {
+
+// -------------------------------------------------------------------------------------------------
+
+int LayoutTuner::execute(const eckit::Configuration & fullConfig) const {
+  LayoutTunerParameters params;
+  params.deserialize(fullConfig);
+
+  const eckit::LocalConfiguration geomConfig = params.geometry.value();
+  const int ntiles = geomConfig.getInt("ntiles", 6);
+  const int npx = geomConfig.getInt("npx", -1);
+
+  if (getComm().size() % ntiles != 0) {
+    ABORT("LayoutTuner: number of tasks must be a multiple of the number of tiles");
+  }
+  const int tasksPerTile = getComm().size() / ntiles;
+
+  // Time every valid layout/io layout combination
+  std::vector<Timings> timings;
+  for (const std::vector<int> & layout : candidateLayouts(params, tasksPerTile, npx)) {
+    for (const std::vector<int> & ioLayout : params.ioLayouts.value()) {
+      ASSERT(ioLayout.size() == 2);
+      if (layout[0] % ioLayout[0] != 0 || layout[1] % ioLayout[1] != 0) continue;
+      oops::Log::info() << "LayoutTuner: benchmarking layout [" << layout[0] << ", " << layout[1]
+                        << "], io_layout [" << ioLayout[0] << ", " << ioLayout[1] << "]"
+                        << std::endl;
+      timings.push_back(benchmark(params, layout, ioLayout));
+      oops::Log::info() << "LayoutTuner:   halo exchange " << timings.back().haloExchange
+                        << " s, to_fieldset " << timings.back().toFieldSet
+                        << " s, write " << timings.back().write
+                        << " s, read " << timings.back().read << " s" << std::endl;
+    }
+  }
+
+  if (timings.empty()) {
+    ABORT("LayoutTuner: no valid layout/io_layout candidates");
+  }
+
+  writeTable(params, npx, timings);
+  return 0;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+std::vector<std::vector<int>> LayoutTuner::candidateLayouts(const LayoutTunerParameters & params,
+                                                            const int & tasksPerTile,
+                                                            const int & npx) const {
+  std::vector<std::vector<int>> layouts;
+  if (params.layouts.value() != boost::none) {
+    for (const std::vector<int> & layout : *params.layouts.value()) {
+      ASSERT(layout.size() == 2);
+      if (layout[0]*layout[1] == tasksPerTile) {
+        layouts.push_back(layout);
+      } else {
+        oops::Log::warning() << "LayoutTuner: skipping layout [" << layout[0] << ", " << layout[1]
+                             << "], does not match " << tasksPerTile << " tasks per tile"
+                             << std::endl;
+      }
+    }
+  } else {
+    // All factorizations of the tasks per tile that leave at least one point per task
+    for (int lx = 1; lx <= tasksPerTile; ++lx) {
+      if (tasksPerTile % lx != 0) continue;
+      const int ly = tasksPerTile / lx;
+      if (npx > 0 && (lx > npx-1 || ly > npx-1)) continue;
+      layouts.push_back({lx, ly});
+    }
+  }
+  return layouts;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+LayoutTuner::Timings LayoutTuner::benchmark(const LayoutTunerParameters & params,
+                                            const std::vector<int> & layout,
+                                            const std::vector<int> & ioLayout) const {
+  typedef std::chrono::steady_clock Clock;
+  const eckit::mpi::Comm & comm = getComm();
+  const int iterations = params.iterations.value();
+
+  // Elapsed time of the slowest task, averaged over the iterations
+  auto elapsed = [&comm, &iterations](const Clock::time_point & start) {
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    comm.allReduceInPlace(seconds, eckit::mpi::max());
+    return seconds / iterations;
+  };
+
+  Timings timings;
+  timings.layout = layout;
+  timings.ioLayout = ioLayout;
+
+  eckit::LocalConfiguration geomConfig = params.geometry.value();
+  geomConfig.set("layout", layout);
+  geomConfig.set("io_layout", ioLayout);
+  const Geometry geom(geomConfig, comm);
+  State state(geom, params.state.value());
+
+  // State to FieldSet
+  atlas::FieldSet fset;
+  comm.barrier();
+  Clock::time_point start = Clock::now();
+  for (int it = 0; it < iterations; ++it) {
+    state.toFieldSet(fset);
+  }
+  timings.toFieldSet = elapsed(start);
+
+  // FMS halo update of the model fields, as done by the model on the fv3 domain
+  std::vector<int> nlevs;
+  for (const atlas::Field & field : fset) nlevs.push_back(field.levels());
+  const int nfields = nlevs.size();
+  double seconds = 0.0;
+  comm.barrier();
+  fv3jedi_geom_halo_update_timing_f90(geom.toFortran(), nfields, nlevs.data(), iterations,
+                                      seconds);
+  comm.allReduceInPlace(seconds, eckit::mpi::max());
+  timings.haloExchange = seconds / iterations;
+
+  // Write and read back
+  if (params.output.value() != boost::none) {
+    const eckit::LocalConfiguration outConfig = *params.output.value();
+    comm.barrier();
+    start = Clock::now();
+    for (int it = 0; it < iterations; ++it) {
+      state.write(outConfig);
+    }
+    timings.write = elapsed(start);
+
+    comm.barrier();
+    start = Clock::now();
+    for (int it = 0; it < iterations; ++it) {
+      state.read(outConfig);
+    }
+    timings.read = elapsed(start);
+  }
+
+  return timings;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void LayoutTuner::writeTable(const LayoutTunerParameters & params, const int & npx,
+                             const std::vector<Timings> & timings) const {
+  const auto best = std::min_element(timings.begin(), timings.end(),
+                                     [](const Timings & a, const Timings & b) {
+                                       return a.total() < b.total();});
+
+  oops::Log::info() << "LayoutTuner: recommended layout [" << best->layout[0] << ", "
+                    << best->layout[1] << "], io_layout [" << best->ioLayout[0] << ", "
+                    << best->ioLayout[1] << "]" << std::endl;
+
+  if (getComm().rank() != 0) return;
+
+  std::ofstream table(params.tableFilename.value());
+  if (!table.is_open()) {
+    ABORT("LayoutTuner: unable to open " + params.tableFilename.value());
+  }
+  table << "resolution: c" << (npx > 0 ? std::to_string(npx-1) : "unknown") << std::endl;
+  table << "tasks: " << getComm().size() << std::endl;
+  table << "recommended:" << std::endl;
+  table << "  layout: [" << best->layout[0] << ", " << best->layout[1] << "]" << std::endl;
+  table << "  io_layout: [" << best->ioLayout[0] << ", " << best->ioLayout[1] << "]" << std::endl;
+  table << "candidates:" << std::endl;
+  for (const Timings & t : timings) {
+    table << "- layout: [" << t.layout[0] << ", " << t.layout[1] << "]" << std::endl;
+    table << "  io_layout: [" << t.ioLayout[0] << ", " << t.ioLayout[1] << "]" << std::endl;
+    table << "  halo exchange: " << t.haloExchange << std::endl;
+    table << "  to fieldset: " << t.toFieldSet << std::endl;
+    table << "  write: " << t.write << std::endl;
+    table << "  read: " << t.read << std::endl;
+    table << "  total: " << t.total() << std::endl;
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+}  // namespace fv3jedi
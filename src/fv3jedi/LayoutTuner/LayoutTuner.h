@@ -0,0 +1,85 @@
+/*
+ * (C) Copyright 2024 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "eckit/config/LocalConfiguration.h"
+#include "eckit/mpi/Comm.h"
+
+#include "oops/mpi/mpi.h"
+#include "oops/runs/Application.h"
+#include "oops/util/parameters/OptionalParameter.h"
+#include "oops/util/parameters/Parameter.h"
+#include "oops/util/parameters/Parameters.h"
+#include "oops/util/parameters/RequiredParameter.h"
+
+namespace eckit {
+  class Configuration;
+}
+
+namespace fv3jedi {
+
+// -------------------------------------------------------------------------------------------------
+
+class LayoutTunerParameters : public oops::Parameters {
+  OOPS_CONCRETE_PARAMETERS(LayoutTunerParameters, Parameters)
+
+ public:
+  // Base geometry; layout and io_layout are overwritten by each candidate
+  oops::RequiredParameter<eckit::LocalConfiguration> geometry{ "geometry", this};
+  // Synthetic state used in the benchmarks (typically an analytic init)
+  oops::RequiredParameter<eckit::LocalConfiguration> state{ "state", this};
+  // Optional output used to time writing and reading back the state
+  oops::OptionalParameter<eckit::LocalConfiguration> output{ "output", this};
+  // Candidate layouts; by default all factorizations of the number of tasks per tile
+  oops::OptionalParameter<std::vector<std::vector<int>>> layouts{ "layouts", this};
+  // Candidate io layouts; those not dividing the layout are skipped
+  oops::Parameter<std::vector<std::vector<int>>> ioLayouts{ "io_layouts", {{1, 1}}, this};
+  oops::Parameter<int> iterations{ "iterations", 5, this};
+  oops::Parameter<std::string> tableFilename{ "table filename", "fv3jedi_layouts.yaml", this};
+};
+
+// -------------------------------------------------------------------------------------------------
+
+/// Benchmarks candidate MPI layouts and io layouts for a Geometry and writes a recommendation
+/// table. Each candidate is timed on the FMS halo update of the State fields on the fv3 domain,
+/// the State to FieldSet conversion and (when an output is configured) the write and read back of
+/// a synthetic State.
+
+class LayoutTuner : public oops::Application {
+ public:
+  explicit LayoutTuner(const eckit::mpi::Comm & comm = oops::mpi::world())
+    : oops::Application(comm) {}
+  virtual ~LayoutTuner() {}
+
+  int execute(const eckit::Configuration &) const override;
+
+ private:
+  struct Timings {
+    std::vector<int> layout;
+    std::vector<int> ioLayout;
+    double haloExchange = 0.0;
+    double toFieldSet = 0.0;
+    double write = 0.0;
+    double read = 0.0;
+    double total() const {return haloExchange + toFieldSet + write + read;}
+  };
+
+  std::vector<std::vector<int>> candidateLayouts(const LayoutTunerParameters &, const int &,
+                                                 const int &) const;
+  Timings benchmark(const LayoutTunerParameters &, const std::vector<int> &,
+                    const std::vector<int> &) const;
+  void writeTable(const LayoutTunerParameters &, const int &, const std::vector<Timings> &) const;
+  std::string appname() const override {return "fv3jedi::LayoutTuner";}
+};
+
+// -------------------------------------------------------------------------------------------------
+
+}  // namespace fv3jedi
@@ -16,6 +16,7 @@ use fv3jedi_geom_mod,      only: fv3jedi_geom
 use fv3jedi_increment_mod, only: fv3jedi_increment
 use fv3jedi_kinds_mod,     only: kind_real
 use fv3jedi_state_mod,     only: fv3jedi_state
+use fv3jedi_trajectory_field_mod, only: fv3jedi_trajectory_field, trajectory_single_precision
 
 use pressure_vt_mod
 use temperature_vt_mod
@@ -35,10 +36,8 @@ public :: multiplyinverseadjoint
 
 !> Fortran derived type to hold configuration data for the B mat variable change
 type :: fv3jedi_linvarcha_c2a
- real(kind=kind_real), allocatable :: ttraj(:,:,:)
- real(kind=kind_real), allocatable :: tvtraj(:,:,:)
- real(kind=kind_real), allocatable :: qtraj(:,:,:)
- real(kind=kind_real), allocatable :: qsattraj(:,:,:)
+ type(fv3jedi_trajectory_field) :: tvtraj
+ type(fv3jedi_trajectory_field) :: qtraj
 end type fv3jedi_linvarcha_c2a
 
 ! --------------------------------------------------------------------------------------------------
@@ -59,8 +58,16 @@ type(fckit_configuration),   intent(in)    :: conf
 real(kind=kind_real), pointer :: t   (:,:,:)=>NULL()
 real(kind=kind_real), pointer :: tv  (:,:,:)=>NULL()
 real(kind=kind_real), pointer :: q   (:,:,:)=>NULL()
-real(kind=kind_real), allocatable :: delp(:,:,:)
-real(kind=kind_real), pointer :: ps  (:,:,:)=>NULL()
+real(kind=kind_real), allocatable :: tvbg(:,:,:)
+logical :: single
+
+!> Precision in which the trajectory is stored
+single = trajectory_single_precision(conf)
+
+!> Pressure
+if (.not. (bg%has_field('delp') .or. bg%has_field('ps'))) then
+  call abor1_ftn("fv3jedi_linvarcha_c2a_mod.create : delp or ps should be present")
+endif
 
 !> Pointers to the background state
 if ( bg%has_field('t') ) then
@@ -70,46 +77,19 @@ if ( bg%has_field('sphum') ) then
   call bg%get_field('sphum', q)
 endif
 
-!> Pressure
-if (bg%has_field('delp')) then
-  call bg%get_field('delp', delp)
-elseif (bg%has_field('ps')) then
-  call bg%get_field('ps', ps)
-  allocate(delp(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz))
-  call ps_to_delp(geom, ps, delp)
-else
-  call abor1_ftn("fv3jedi_linvarcha_c2a_mod.create : delp or ps should be present")
-endif
-
 !> Virtual temperature trajectory
-allocate(self%tvtraj(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz))
 if ( bg%has_field('tv')) then
   call bg%get_field('tv', tv)
-  self%tvtraj = tv
-else
-  if (associated(t).and.associated(q)) then
-    call T_to_Tv(geom,t,q,self%tvtraj)
-  endif
-endif
-
-!> Temperature trajectory
-if(associated(t)) then
-  allocate(self%ttraj   (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz))
-  self%ttraj = t
+  call self%tvtraj%set(geom, tv, single)
+elseif (associated(t).and.associated(q)) then
+  allocate(tvbg(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz))
+  call T_to_Tv(geom,t,q,tvbg)
+  call self%tvtraj%set(geom, tvbg, single)
 endif
 
 !> Specific humidity trajecotory
-if(associated(t)) then
-  allocate(self%qtraj   (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz))
-  self%qtraj = q
-endif
-
-if(associated(t).and.associated(q).and.allocated(delp)) then
-  !> Compute saturation specific humidity for q to RH transform
-  allocate(self%qsattraj(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz))
-
-  !> Compute saturation specific humidity
-  call get_qsat(geom,delp,t,q,self%qsattraj)
+if (associated(q)) then
+  call self%qtraj%set(geom, q, single)
 endif
 
 end subroutine create
@@ -121,10 +101,8 @@ subroutine delete(self)
 implicit none
 type(fv3jedi_linvarcha_c2a), intent(inout) :: self
 
-if (allocated(self%tvtraj)) deallocate(self%tvtraj)
-if (allocated(self%ttraj)) deallocate(self%ttraj)
-if (allocated(self%qtraj)) deallocate(self%qtraj)
-if (allocated(self%qsattraj)) deallocate(self%qsattraj)
+call self%tvtraj%delete()
+call self%qtraj%delete()
 
 end subroutine delete
 
@@ -159,6 +137,8 @@ real(kind=kind_real), pointer,     dimension(:,:,:) :: q
 logical :: have_t
 real(kind=kind_real), pointer,     dimension(:,:,:) :: tv
 real(kind=kind_real), allocatable, dimension(:,:,:) :: t
+real(kind=kind_real), pointer,     dimension(:,:,:) :: tvtraj => null()
+real(kind=kind_real), pointer,     dimension(:,:,:) :: qtraj => null()
 
 ! Surface Pressure
 logical :: have_ps
@@ -212,7 +192,11 @@ elseif (dxc%has_field('tv') .and. have_q) then
   allocate(t(geom%isc:geom%iec,geom%jsc:geom%jec,geom%npz))
   call dxc%get_field('sphum', q)
   call dxc%get_field('tv'  , tv)
-  call Tv_to_T_tl(geom, self%tvtraj, tv, self%qtraj, q, t)
+  call self%tvtraj%get(tvtraj)
+  call self%qtraj%get(qtraj)
+  call Tv_to_T_tl(geom, tvtraj, tv, qtraj, q, t)
+  call self%tvtraj%release(tvtraj)
+  call self%qtraj%release(qtraj)
   have_t = .true.
 endif
 
@@ -342,6 +326,8 @@ real(kind=kind_real), pointer,     dimension(:,:,:) :: q
 logical :: have_tv
 real(kind=kind_real), pointer,     dimension(:,:,:) :: t
 real(kind=kind_real), allocatable, dimension(:,:,:) :: tv
+real(kind=kind_real), pointer,     dimension(:,:,:) :: tvtraj => null()
+real(kind=kind_real), pointer,     dimension(:,:,:) :: qtraj => null()
 
 ! Surface pressure
 logical :: have_ps
@@ -373,7 +359,11 @@ if (dxa%has_field('t') .and. dxa%has_field('sphum')) then
   call dxa%get_field('sphum', q)
   allocate(tv(geom%isc:geom%iec,geom%jsc:geom%jec,geom%npz))
   tv = 0.0_kind_real
-  call Tv_to_T_ad(geom, self%tvtraj, tv, self%qtraj, q, t)
+  call self%tvtraj%get(tvtraj)
+  call self%qtraj%get(qtraj)
+  call Tv_to_T_ad(geom, tvtraj, tv, qtraj, q, t)
+  call self%tvtraj%release(tvtraj)
+  call self%qtraj%release(qtraj)
   have_tv = .true.
 endif
 
@@ -5,11 +5,21 @@
  * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
  */
 
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
 #include <ostream>
+#include <sstream>
 #include <string>
 #include <vector>
 
+#include "atlas/array.h"
+#include "atlas/field.h"
+
 #include "eckit/config/Configuration.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/mpi/Comm.h"
 
 #include "oops/util/Logger.h"
 
@@ -24,22 +34,82 @@ namespace fv3jedi {
 
 // -------------------------------------------------------------------------------------------------
 
+namespace {
+
+// Trajectories that are alive somewhere in the process, by trajectory key. The cache does not
+// extend their lifetime, a trajectory goes when the last linear variable change using it does.
+std::map<std::string, std::weak_ptr<LinearVariableChangeTrajectory>> & trajectoryCache() {
+  static std::map<std::string, std::weak_ptr<LinearVariableChangeTrajectory>> cache;
+  return cache;
+}
+
+const std::uint64_t fnvPrime = 1099511628211ULL;
+
+// Fold the bytes of a value into a 64-bit FNV-1a hash
+template <typename T>
+void hashBytes(const T & value, std::uint64_t & hash) {
+  unsigned char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  for (const unsigned char byte : bytes) {
+    hash = (hash ^ byte) * fnvPrime;
+  }
+}
+
+// Fold the values of a field at the points owned by this task into the hash. Halo points are
+// copies of points owned elsewhere and may be stale, so they are left out.
+template <typename T>
+void hashOwnedValues(const atlas::Field & field, const atlas::Field & ghost, std::uint64_t & hash) {
+  const auto ghostView = atlas::array::make_view<const int, 1>(ghost);
+  const auto view = atlas::array::make_view<const T, 2>(field);
+  for (atlas::idx_t jnode = 0; jnode < view.shape(0); ++jnode) {
+    if (ghostView(jnode)) continue;
+    for (atlas::idx_t jlev = 0; jlev < view.shape(1); ++jlev) {
+      hashBytes(view(jnode, jlev), hash);
+    }
+  }
+}
+
+// 64-bit FNV-1a hash of the names, data types and owned values of the fields
+std::uint64_t fieldSetFingerprint(const atlas::FieldSet & fset, const atlas::Field & ghost) {
+  std::uint64_t hash = 14695981039346656037ULL;
+  for (const auto & field : fset) {
+    for (const char c : field.name()) {
+      hash = (hash ^ static_cast<unsigned char>(c)) * fnvPrime;
+    }
+    ASSERT(field.rank() == 2);
+    ASSERT(field.shape(0) == ghost.shape(0));
+    const atlas::DataType::kind_t kind = field.datatype().kind();
+    hashBytes(kind, hash);
+    if (kind == atlas::DataType::KIND_REAL64) {
+      hashOwnedValues<double>(field, ghost, hash);
+    } else if (kind == atlas::DataType::KIND_REAL32) {
+      hashOwnedValues<float>(field, ghost, hash);
+    } else if (kind == atlas::DataType::KIND_INT32) {
+      hashOwnedValues<int>(field, ghost, hash);
+    } else if (kind == atlas::DataType::KIND_INT64) {
+      hashOwnedValues<long>(field, ghost, hash);
+    } else {
+      ABORT("fieldSetFingerprint: unsupported data type " + field.datatype().str() + " of field "
+            + field.name());
+    }
+  }
+  return hash;
+}
+
+}  // namespace
+
+// -------------------------------------------------------------------------------------------------
+
 LinearVariableChange::LinearVariableChange(const Geometry & geom,
                                            const eckit::Configuration & config)
-  : geom_(geom), linearVariableChange_(), fieldsMetadata_(geom.fieldsMetaData()),
-    vader_()
+  : geom_(geom), fieldsMetadata_(geom.fieldsMetaData()), vaderConfig_(), traj_()
 {
   params_.deserialize(config);
   eckit::LocalConfiguration variableChangeConfig = params_.toConfiguration();
   ModelData modelData{geom};
-  eckit::LocalConfiguration vaderConfig;
-  vaderConfig.set(vader::configCookbookKey,
-                  variableChangeConfig.getSubConfiguration("vader custom cookbook"));
-  vaderConfig.set(vader::configModelVarsKey, modelData.modelData());
-
-  // Create vader with fv3-jedi custom cookbook
-  vader_.reset(new vader::Vader(params_.linearVariableChangeParameters.value().vader,
-                                vaderConfig));
+  vaderConfig_.set(vader::configCookbookKey,
+                   variableChangeConfig.getSubConfiguration("vader custom cookbook"));
+  vaderConfig_.set(vader::configModelVarsKey, modelData.modelData());
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -54,35 +124,90 @@ void LinearVariableChange::changeVarTraj(const State & xfg, const oops::Variable
   // Make sure vars are longname
   const oops::Variables vars = fieldsMetadata_.getLongNameFromAnyName(vars_out);
 
-  // Call Vader's changeVarTraj to populate its trajectory
-  State vader_xfg(xfg);
+  atlas::FieldSet xfgfs;
+  xfg.toFieldSet(xfgfs);
+
+  // Reuse a trajectory computed from the same state with the same settings. Creating a trajectory
+  // can communicate so every task has to make the same choice.
+  const std::string key = trajectoryKey(xfg, xfgfs, vars);
+  std::map<std::string, std::weak_ptr<LinearVariableChangeTrajectory>> & cache = trajectoryCache();
+  std::shared_ptr<LinearVariableChangeTrajectory> cached;
+  const auto it = cache.find(key);
+  if (it != cache.end()) cached = it->second.lock();
+  int create = cached ? 0 : 1;
+  geom_.getComm().allReduceInPlace(create, eckit::mpi::max());
+  if (create == 0) {
+    traj_ = cached;
+    oops::Log::trace() << "LinearVariableChange::changeVarTraj done (reused)" << std::endl;
+    return;
+  }
+
+  // Create vader with fv3-jedi custom cookbook
+  std::shared_ptr<LinearVariableChangeTrajectory> traj =
+    std::make_shared<LinearVariableChangeTrajectory>();
+  traj->vader.reset(new vader::Vader(params_.linearVariableChangeParameters.value().vader,
+                                     vaderConfig_));
 
   // Record start variables
-  oops::Variables varsFilled = vader_xfg.variablesIncludingInterfaceFields();
+  oops::Variables varsFilled = xfg.variablesIncludingInterfaceFields();
 
   oops::Variables varsVader = vars;
   varsVader -= varsFilled;  // Pass only the needed variables
 
-  // Call Vader. On entry, varsVader holds the vars requested from Vader; on exit,
-  // it holds the vars NOT fullfilled by Vader, i.e., the vars still to be requested elsewhere.
-  // vader_.changeVarTraj also returns the variables fulfilled by Vader.
-  atlas::FieldSet xfgfs;
-  vader_xfg.toFieldSet(xfgfs);
-  varsVaderPopulates_ = vader_->changeVarTraj(xfgfs, varsVader);
-  if (varsVaderPopulates_.size() > 0) {
-    varsFilled += varsVaderPopulates_;
+  // Call Vader's changeVarTraj to populate its trajectory. On entry, varsVader holds the vars
+  // requested from Vader; on exit, it holds the vars NOT fullfilled by Vader, i.e., the vars still
+  // to be requested elsewhere. vader_.changeVarTraj also returns the variables fulfilled by Vader.
+  traj->varsVaderPopulates = traj->vader->changeVarTraj(xfgfs, varsVader);
+
+  // Create the model variable change, from a copy of the trajectory extended with the fields
+  // populated by Vader only when there are any
+  if (traj->varsVaderPopulates.size() > 0) {
+    State vader_xfg(xfg);
+    varsFilled += traj->varsVaderPopulates;
     vader_xfg.updateFields(varsFilled);
-    vader_xfg.fromFieldSet(xfgfs);
+    vader_xfg.fromFieldSet(traj->varsVaderPopulates, xfgfs);
+    traj->linearVariableChange.reset(LinearVariableChangeFactory::create(vader_xfg, vader_xfg,
+               geom_, params_.linearVariableChangeParameters.value()));
+  } else {
+    traj->linearVariableChange.reset(LinearVariableChangeFactory::create(xfg, xfg, geom_,
+               params_.linearVariableChangeParameters.value()));
+  }
+
+  // Forget trajectories that are no longer used and make this one available
+  for (auto jtraj = cache.begin(); jtraj != cache.end();) {
+    if (jtraj->second.expired()) {
+      jtraj = cache.erase(jtraj);
+    } else {
+      ++jtraj;
+    }
   }
+  cache[key] = traj;
+  traj_ = traj;
 
-  // Create the model variable change
-  linearVariableChange_.reset(LinearVariableChangeFactory::create(vader_xfg, vader_xfg, geom_,
-             params_.linearVariableChangeParameters.value()));
   oops::Log::trace() << "LinearVariableChange::changeVarTraj done" << std::endl;
 }
 
 // -------------------------------------------------------------------------------------------------
 
+std::string LinearVariableChange::trajectoryKey(const State & xfg, const atlas::FieldSet & xfgfs,
+                                                const oops::Variables & vars) const {
+  // The trajectory holds references to the geometry, so it is only shared between users of the
+  // same Geometry instance. The instance identity, unlike the address, is never reused.
+  std::ostringstream key;
+  key << params_.toConfiguration() << "|" << geom_.instanceId() << "|" << vars << "|"
+      << xfg.variablesIncludingInterfaceFields() << "|" << xfg.validTime() << "|"
+      << std::hex << fieldSetFingerprint(xfgfs, geom_.functionSpace().ghost());
+  return key.str();
+}
+
+// -------------------------------------------------------------------------------------------------
+
+bool LinearVariableChange::sharesTrajectoryWith(const LinearVariableChange & other) const {
+  return traj_ && traj_ == other.traj_;
+}
+
+// -------------------------------------------------------------------------------------------------
+
 void LinearVariableChange::changeVarTL(Increment & dx, const oops::Variables & vars_out) const {
   oops::Log::trace() << "LinearVariableChange::changeVarTL starting" << std::endl;
   // Make sure vars are longname
@@ -98,19 +223,19 @@ void LinearVariableChange::changeVarTL(Increment & dx, const oops::Variables & v
   // Call Vader. On entry, varsVaderWillPopulate holds the vars requested from Vader; on exit,
   // it should be empty, since we know which variables Vader will do from the changeVarTraj
   // call.
-  atlas::FieldSet dxfs;
-  dx.toFieldSet(dxfs);
-  oops::Variables varsVaderWillPopulate = varsVaderPopulates_;
+  oops::Variables varsVaderWillPopulate = traj_->varsVaderPopulates;
   if (varsVaderWillPopulate.size() > 0) {
-    vader_->changeVarTL(dxfs, varsVaderWillPopulate);
+    atlas::FieldSet dxfs;
+    dx.toFieldSet(dxfs);
+    traj_->vader->changeVarTL(dxfs, varsVaderWillPopulate);
     ASSERT(varsVaderWillPopulate.size() == 0);
 
     // Set intermediate state for the Increment containing original fields plus the ones
     // Vader has done
     oops::Variables varsVader = dx.variablesIncludingInterfaceFields();
-    varsVader += varsVaderPopulates_;
+    varsVader += traj_->varsVaderPopulates;
     dx.updateFields(varsVader);
-    dx.fromFieldSet(dxfs);
+    dx.fromFieldSet(traj_->varsVaderPopulates, dxfs);
   }
 
   // The to/fromFieldSet above is for a var change, so we know it's just adding/removing fields,
@@ -122,7 +247,7 @@ void LinearVariableChange::changeVarTL(Increment & dx, const oops::Variables & v
   Increment dxout(dx.geometry(), vars, dx.time());
 
   // Call fv3 linear variable change TL
-  linearVariableChange_->multiply(dx, dxout);
+  traj_->linearVariableChange->multiply(dx, dxout);
 
   // Allocate any extra fields and remove fields no longer needed
   dx.updateFields(vars);
@@ -154,7 +279,7 @@ void LinearVariableChange::changeVarInverseTL(Increment & dx,
   Increment dxout(dx.geometry(), vars, dx.time());
 
   // Call variable change
-  linearVariableChange_->multiplyInverse(dx, dxout);
+  traj_->linearVariableChange->multiplyInverse(dx, dxout);
 
   // Allocate any extra fields and remove fields no longer needed
   dx.updateFields(vars);
@@ -201,21 +326,21 @@ void LinearVariableChange::changeVarAD(Increment & dx, const oops::Variables & v
   // This way we ensure the model code will not be able to do the adjoint for these vars
   Increment dxin(dx, true);  // true => full copy
   oops::Variables varsVaderDidntPopulate = dx.variablesIncludingInterfaceFields();
-  varsVaderDidntPopulate -= varsVaderPopulates_;
+  varsVaderDidntPopulate -= traj_->varsVaderPopulates;
   dxin.updateFields(varsVaderDidntPopulate);
 
-  dx.updateFields(varsVaderPopulates_);
+  dx.updateFields(traj_->varsVaderPopulates);
   // Create empty output state
   Increment dxout(dx.geometry(), vars, dx.time());
 
   // Call model's adjoint variable change.
-  linearVariableChange_->multiplyAD(dxin, dxout);
+  traj_->linearVariableChange->multiplyAD(dxin, dxout);
 
   // dxout needs to temporarily have the variables that Vader populated put into it before
   // being passed into vader_.changeVarAD, so Vader can do its adjoints.
   atlas::FieldSet dxout_fs;
   dxout.toFieldSet(dxout_fs);
-  oops::Variables varsVaderWillAdjoint = varsVaderPopulates_;
+  oops::Variables varsVaderWillAdjoint = traj_->varsVaderPopulates;
   if (varsVaderWillAdjoint.size() > 0) {
     atlas::FieldSet dx_fs;
     dx.toFieldSet(dx_fs);
@@ -223,7 +348,7 @@ void LinearVariableChange::changeVarAD(Increment & dx, const oops::Variables & v
       dxout_fs.add(field);
     }
 
-    vader_->changeVarAD(dxout_fs, varsVaderWillAdjoint);
+    traj_->vader->changeVarAD(dxout_fs, varsVaderWillAdjoint);
 
     // After changeVarAD, vader should have removed everything from varsVaderWillAdjoint,
     // indicating it did all the adjoints we expected it to.
@@ -262,7 +387,7 @@ void LinearVariableChange::changeVarInverseAD(Increment & dx,
   Increment dxout(dx.geometry(), vars, dx.time());
 
   // Call variable change
-  linearVariableChange_->multiplyInverseAD(dx, dxout);
+  traj_->linearVariableChange->multiplyInverseAD(dx, dxout);
 
   // Allocate any extra fields and remove fields no longer needed
   dx.updateFields(vars);
@@ -13,9 +13,13 @@
 
 #include <boost/ptr_container/ptr_vector.hpp>
 
+#include "atlas/field/FieldSet.h"
+
 #include "eckit/config/Configuration.h"
+#include "eckit/config/LocalConfiguration.h"
 
 #include "oops/base/LinearVariableChangeParametersBase.h"
+#include "oops/base/Variables.h"
 #include "oops/util/parameters/OptionalParameter.h"
 #include "oops/util/parameters/Parameter.h"
 #include "oops/util/parameters/Parameters.h"
@@ -31,6 +35,17 @@ namespace fv3jedi {
 
 // -------------------------------------------------------------------------------------------------
 
+/// Trajectory of the linear variable change: Vader's trajectory and the fv3-jedi linear variable
+/// change created from it. Instances with the same parameters, geometry and trajectory state share
+/// one trajectory rather than recomputing it.
+struct LinearVariableChangeTrajectory {
+  std::unique_ptr<vader::Vader> vader;
+  std::unique_ptr<LinearVariableChangeBase> linearVariableChange;
+  oops::Variables varsVaderPopulates;
+};
+
+// -------------------------------------------------------------------------------------------------
+
 class LinearVariableChange : public util::Printable {
  public:
   static const std::string classname() {return "fv3jedi::LinearVariableChange";}
@@ -48,14 +63,17 @@ class LinearVariableChange : public util::Printable {
   void changeVarAD(Increment &, const oops::Variables &, bool force_varchange = false) const;
   void changeVarInverseAD(Increment &, const oops::Variables &) const;
 
+  // True when both linear variable changes use the same trajectory
+  bool sharesTrajectoryWith(const LinearVariableChange &) const;
+
  private:
   void print(std::ostream &) const override;
+  std::string trajectoryKey(const State &, const atlas::FieldSet &, const oops::Variables &) const;
   LinearVariableChangeParametersWrapper params_;
   const Geometry & geom_;
-  std::unique_ptr<LinearVariableChangeBase> linearVariableChange_;
   FieldsMetadata fieldsMetadata_;
-  std::unique_ptr<vader::Vader> vader_;
-  oops::Variables varsVaderPopulates_;
+  eckit::LocalConfiguration vaderConfig_;
+  std::shared_ptr<LinearVariableChangeTrajectory> traj_;
 };
 
 // -------------------------------------------------------------------------------------------------
@@ -19,6 +19,7 @@ use fv3jedi_field_mod,     only: copy_subset, field_clen
 use fv3jedi_increment_mod, only: fv3jedi_increment
 use fv3jedi_kinds_mod,     only: kind_real
 use fv3jedi_state_mod,     only: fv3jedi_state
+use fv3jedi_trajectory_field_mod, only: fv3jedi_trajectory_field, trajectory_single_precision
 
 use radii_vt_mod
 use height_vt_mod
@@ -35,15 +36,14 @@ public :: fv3jedi_lvc_model2geovals
 
 type :: fv3jedi_lvc_model2geovals
   integer :: isc, iec, jsc, jec, npz
-  real(kind=kind_real), allocatable ::      t(:,:,:)
-  real(kind=kind_real), allocatable ::      q(:,:,:)
-  real(kind=kind_real), allocatable ::     o3(:,:,:)
-  real(kind=kind_real), allocatable ::     ql(:,:,:)
-  real(kind=kind_real), allocatable ::     qi(:,:,:)
-  real(kind=kind_real), allocatable ::     qr(:,:,:)
-  real(kind=kind_real), allocatable ::     qs(:,:,:)
-  real(kind=kind_real), allocatable ::     qg(:,:,:)
-  real(kind=kind_real), allocatable ::   delp(:,:,:)
+  type(fv3jedi_trajectory_field) ::  q
+  type(fv3jedi_trajectory_field) ::  o3
+  type(fv3jedi_trajectory_field) ::  ql
+  type(fv3jedi_trajectory_field) ::  qi
+  type(fv3jedi_trajectory_field) ::  qr
+  type(fv3jedi_trajectory_field) ::  qs
+  type(fv3jedi_trajectory_field) ::  qg
+  type(fv3jedi_trajectory_field) ::  delp
   real(kind=kind_real), allocatable ::  slmsk(:,:,:)
   real(kind=kind_real), allocatable :: sheleg(:,:,:)
   real(kind=kind_real), allocatable :: frseaice(:,:,:)
@@ -65,22 +65,23 @@ contains
 
 ! --------------------------------------------------------------------------------------------------
 
-subroutine create(self, geom, bg, fg, dummyconf)
+subroutine create(self, geom, bg, fg, conf)
 
 class(fv3jedi_lvc_model2geovals), intent(inout) :: self
 type(fv3jedi_geom),               intent(in)    :: geom
-type(fv3jedi_state),              intent(in)    :: bg
+type(fv3jedi_state), target,      intent(in)    :: bg
 type(fv3jedi_state),              intent(in)    :: fg
-type(fckit_configuration),        intent(in)    :: dummyconf
+type(fckit_configuration),        intent(in)    :: conf
 
 integer :: i,j
-logical :: have_fractions,have_slmsk,have_ts
+logical :: have_fractions,have_slmsk,have_ts,single
 real(kind=kind_real), allocatable :: local_swe(:,:,:)
 
 !Locals
 real(kind=kind_real), parameter :: minswe = 1.0_kind_real / 10.0_kind_real
 
-!!! DO NOT USE CONF !!!
+! Only optional settings may be read from the configuration, it is usually empty
+single = trajectory_single_precision(conf)
 
 ! Grid convenience
 self%isc = geom%isc
@@ -90,16 +91,15 @@ self%jec = geom%jec
 self%npz = geom%npz
 
 ! Trajectory fields
-if (bg%has_field('t'     )) call bg%get_field('t'     , self%t )
-if (bg%has_field('sphum' )) call bg%get_field('sphum' , self%q )
-if (bg%has_field('o3mr'  )) call bg%get_field('o3mr'  , self%o3)
-if (bg%has_field('o3ppmv')) call bg%get_field('o3ppmv', self%o3)
-if (bg%has_field('delp'  )) call bg%get_field('delp'  , self%delp)
-if (bg%has_field('cloud_liquid_water')) call bg%get_field('cloud_liquid_water', self%ql)
-if (bg%has_field('cloud_liquid_ice'))   call bg%get_field('cloud_liquid_ice'  , self%qi)
-if (bg%has_field('rain_water'))         call bg%get_field('rain_water'        , self%qr)
-if (bg%has_field('snow_water'))         call bg%get_field('snow_water'        , self%qs)
-if (bg%has_field('graupel'))            call bg%get_field('graupel'           , self%qg)
+call set_trajectory('sphum' , self%q )
+call set_trajectory('o3mr'  , self%o3)
+call set_trajectory('o3ppmv', self%o3)
+call set_trajectory('delp'  , self%delp)
+call set_trajectory('cloud_liquid_water', self%ql)
+call set_trajectory('cloud_liquid_ice'  , self%qi)
+call set_trajectory('rain_water'        , self%qr)
+call set_trajectory('snow_water'        , self%qs)
+call set_trajectory('graupel'           , self%qg)
 if (bg%has_field('fraction_of_ice'))    call bg%get_field('fraction_of_ice'   , self%frseaice)
 if (bg%has_field('fraction_of_snow'))   call bg%get_field('fraction_of_snow'  , self%frsnow)
 if (bg%has_field('fraction_of_land'))   call bg%get_field('fraction_of_land'  , self%frland)
@@ -182,6 +182,18 @@ if (have_slmsk) then
 
 endif
 
+contains
+
+  subroutine set_trajectory(field_name, traj)
+    character(len=*),               intent(in)    :: field_name
+    type(fv3jedi_trajectory_field), intent(inout) :: traj
+    real(kind=kind_real), pointer :: field(:,:,:)
+    if (bg%has_field(field_name)) then
+      call bg%get_field(field_name, field)
+      call traj%set(geom, field, single)
+    endif
+  end subroutine set_trajectory
+
 end subroutine create
 
 ! --------------------------------------------------------------------------------------------------
@@ -197,15 +209,14 @@ if (allocated(self%frlake)) deallocate(self%frlake  )
 if (allocated(self%frland)) deallocate(self%frland  )
 if (allocated(self%frsnow)) deallocate(self%frsnow  )
 if (allocated(self%frseaice)) deallocate(self%frseaice  )
-if (allocated(self%qg  )) deallocate(self%qg  )
-if (allocated(self%qs  )) deallocate(self%qs  )
-if (allocated(self%qr  )) deallocate(self%qr  )
-if (allocated(self%qi  )) deallocate(self%qi  )
-if (allocated(self%ql  )) deallocate(self%ql  )
-if (allocated(self%delp)) deallocate(self%delp)
-if (allocated(self%o3  )) deallocate(self%o3  )
-if (allocated(self%q   )) deallocate(self%q   )
-if (allocated(self%t   )) deallocate(self%t   )
+call self%qg%delete()
+call self%qs%delete()
+call self%qr%delete()
+call self%qi%delete()
+call self%ql%delete()
+call self%delp%delete()
+call self%o3%delete()
+call self%q%delete()
 
 end subroutine delete
 
@@ -240,6 +251,12 @@ real(kind=kind_real), allocatable :: tv  (:,:,:)         !Virtual temperature
 logical :: have_qmr
 real(kind=kind_real), allocatable :: qmr (:,:,:)         !Humidity mixing ratio
 
+!Trajectory fields in double precision
+real(kind=kind_real), pointer     :: q_traj   (:,:,:)    !Specific humidity
+real(kind=kind_real), pointer     :: qx_traj  (:,:,:)    !Hydrometeor mixing ratio
+real(kind=kind_real), pointer     :: delp_traj(:,:,:)    !Pressure thickness
+real(kind=kind_real), pointer     :: o3_traj  (:,:,:)    !Ozone
+
 !Cloud liquid water mixing ratio
 logical :: have_ql,have_qi,have_qr,have_qs,have_qg
 real(kind=kind_real), allocatable :: clwpath (:,:,:)     !Cloud liquid  water path
@@ -322,65 +339,87 @@ endif
 ! Humidity mixing ratio
 ! ---------------------
 have_qmr = .false.
-if (allocated(self%q) .and. dxm%has_field('sphum')) then
+if (self%q%has() .and. dxm%has_field('sphum')) then
   call dxm%get_field('sphum', q)
   allocate(qmr(self%isc:self%iec,self%jsc:self%jec,self%npz))
-  call crtm_mixratio_tl(geom, self%q, q, qmr)
+  call self%q%get(q_traj)
+  call crtm_mixratio_tl(geom, q_traj, q, qmr)
+  call self%q%release(q_traj)
   have_qmr = .true.
 endif
 
 ! Cloud liquid water
 ! ------------------
 have_ql = .false.
-if (allocated(self%ql).and.allocated(self%delp).and.dxm%has_field('liq_wat').and.&
+if (self%ql%has().and.self%delp%has().and.dxm%has_field('liq_wat').and.&
    dxg%has_field('mass_content_of_cloud_liquid_water_in_atmosphere_layer')) then
   call dxm%get_field('liq_wat', cmxr)
   allocate(clwpath(self%isc:self%iec,self%jsc:self%jec,self%npz))
-  call hydro_mixr_to_wpath_tl (geom, self%delp, self%ql, cmxr, clwpath)
+  call self%delp%get(delp_traj)
+  call self%ql%get(qx_traj)
+  call hydro_mixr_to_wpath_tl (geom, delp_traj, qx_traj, cmxr, clwpath)
+  call self%ql%release(qx_traj)
+  call self%delp%release(delp_traj)
   have_ql = .true.
 endif
 
 ! Cloud ice water
 ! ---------------
 have_qi = .false.
-if (allocated(self%qi).and.allocated(self%delp).and.dxm%has_field('ice_wat').and.&
+if (self%qi%has().and.self%delp%has().and.dxm%has_field('ice_wat').and.&
    dxg%has_field('mass_content_of_cloud_ice_in_atmosphere_layer')) then
   call dxm%get_field('ice_wat', cmxr)
   allocate(ciwpath(self%isc:self%iec,self%jsc:self%jec,self%npz))
-  call hydro_mixr_to_wpath_tl (geom, self%delp, self%qi, cmxr, ciwpath)
+  call self%delp%get(delp_traj)
+  call self%qi%get(qx_traj)
+  call hydro_mixr_to_wpath_tl (geom, delp_traj, qx_traj, cmxr, ciwpath)
+  call self%qi%release(qx_traj)
+  call self%delp%release(delp_traj)
   have_qi = .true.
 endif
 
 ! Rain
 ! ----
 have_qr = .false.
-if (allocated(self%qr).and.allocated(self%delp).and.dxm%has_field('rainwat').and.&
+if (self%qr%has().and.self%delp%has().and.dxm%has_field('rainwat').and.&
    dxg%has_field('mass_content_of_rain_in_atmosphere_layer')) then
   call dxm%get_field('rainwat', cmxr)
   allocate(crwpath(self%isc:self%iec,self%jsc:self%jec,self%npz))
-  call hydro_mixr_to_wpath_tl (geom, self%delp, self%qr, cmxr, crwpath)
+  call self%delp%get(delp_traj)
+  call self%qr%get(qx_traj)
+  call hydro_mixr_to_wpath_tl (geom, delp_traj, qx_traj, cmxr, crwpath)
+  call self%qr%release(qx_traj)
+  call self%delp%release(delp_traj)
   have_qr = .true.
 endif
 
 ! Snow
 ! ----
 have_qs = .false.
-if (allocated(self%qs).and.allocated(self%delp).and.dxm%has_field('snowwat').and.&
+if (self%qs%has().and.self%delp%has().and.dxm%has_field('snowwat').and.&
    dxg%has_field('mass_content_of_snow_in_atmosphere_layer')) then
   call dxm%get_field('snowwat', cmxr)
   allocate(cswpath(self%isc:self%iec,self%jsc:self%jec,self%npz))
-  call hydro_mixr_to_wpath_tl (geom, self%delp, self%qs, cmxr, cswpath)
+  call self%delp%get(delp_traj)
+  call self%qs%get(qx_traj)
+  call hydro_mixr_to_wpath_tl (geom, delp_traj, qx_traj, cmxr, cswpath)
+  call self%qs%release(qx_traj)
+  call self%delp%release(delp_traj)
   have_qs = .true.
 endif
 
 ! Graupel
 ! -------
 have_qg = .false.
-if (allocated(self%qg).and.allocated(self%delp).and.dxm%has_field('graupel').and.&
+if (self%qg%has().and.self%delp%has().and.dxm%has_field('graupel').and.&
    dxg%has_field('mass_content_of_graupel_in_atmosphere_layer')) then
   call dxm%get_field('graupel', cmxr)
   allocate(cgwpath(self%isc:self%iec,self%jsc:self%jec,self%npz))
-  call hydro_mixr_to_wpath_tl (geom, self%delp, self%qg, cmxr, cgwpath)
+  call self%delp%get(delp_traj)
+  call self%qg%get(qx_traj)
+  call hydro_mixr_to_wpath_tl (geom, delp_traj, qx_traj, cmxr, cgwpath)
+  call self%qg%release(qx_traj)
+  call self%delp%release(delp_traj)
   have_qg = .true.
 endif
 
@@ -398,17 +437,19 @@ elseif (dxm%has_field('o3ppmv')) then
 endif
 
 if (have_o3) then
-  if (.not.allocated(self%o3)) call abor1_ftn("fv3jedi_lvc_model2geovals_mod.multiply no ozone" // &
-                                              "found in trajectory")
+  if (.not.self%o3%has()) call abor1_ftn("fv3jedi_lvc_model2geovals_mod.multiply no ozone" // &
+                                         "found in trajectory")
+  call self%o3%get(o3_traj)
   do k = 1, self%npz
     do j = self%jsc, self%jec
       do i = self%isc, self%iec
-        if (self%o3(i,j,k) < 0.0_kind_real ) then
+        if (o3_traj(i,j,k) < 0.0_kind_real ) then
           o3ppmv(i,j,k) = 0.0_kind_real
         endif
       enddo
     enddo
   enddo
+  call self%o3%release(o3_traj)
 endif
 
 ! Surface pressure
@@ -558,6 +599,12 @@ real(kind=kind_real), pointer     :: qmr  (:,:,:)         !Virtual temperature
 real(kind=kind_real), allocatable :: q_qmr(:,:,:)         !Specific humidity
 real(kind=kind_real), pointer     :: qptr (:,:,:)         !Specific humidity
 
+!Trajectory fields in double precision
+real(kind=kind_real), pointer     :: q_traj   (:,:,:)     !Specific humidity
+real(kind=kind_real), pointer     :: qx_traj  (:,:,:)     !Hydrometeor mixing ratio
+real(kind=kind_real), pointer     :: delp_traj(:,:,:)     !Pressure thickness
+real(kind=kind_real), pointer     :: o3_traj  (:,:,:)     !Ozone
+
 !Cloud liquid water mixing ratio
 logical :: have_ql,have_qi,have_qr,have_qs,have_qg
 real(kind=kind_real), pointer     :: wpath (:,:,:)        !Water path
@@ -666,11 +713,13 @@ endif
 ! Humidity mixing ratio
 ! ---------------------
 have_qmr = .false.
-if (allocated(self%q) .and. dxg%has_field('water_vapor_mixing_ratio_wrt_dry_air', qmr_index)) then
+if (self%q%has() .and. dxg%has_field('water_vapor_mixing_ratio_wrt_dry_air', qmr_index)) then
   call dxg%get_field('water_vapor_mixing_ratio_wrt_dry_air', qmr)
   allocate(q_qmr(self%isc:self%iec,self%jsc:self%jec,self%npz))
   q_qmr = 0.0_kind_real
-  call crtm_mixratio_ad(geom, self%q, q_qmr, qmr)
+  call self%q%get(q_traj)
+  call crtm_mixratio_ad(geom, q_traj, q_qmr, qmr)
+  call self%q%release(q_traj)
   have_qmr = .true.
 endif
 
@@ -691,60 +740,80 @@ endif
 ! Cloud liquid water
 ! ------------------
 have_ql = .false.
-if (allocated(self%ql).and.allocated(self%delp).and.dxm%has_field('liq_wat').and.&
+if (self%ql%has().and.self%delp%has().and.dxm%has_field('liq_wat').and.&
     dxg%has_field('mass_content_of_cloud_liquid_water_in_atmosphere_layer',ql_index)) then
   call dxg%get_field('mass_content_of_cloud_liquid_water_in_atmosphere_layer', wpath)
   allocate(dql(self%isc:self%iec,self%jsc:self%jec,self%npz))
   dql=0.0_kind_real
-  call hydro_mixr_to_wpath_ad (geom, self%delp, self%ql, dql, wpath)
+  call self%delp%get(delp_traj)
+  call self%ql%get(qx_traj)
+  call hydro_mixr_to_wpath_ad (geom, delp_traj, qx_traj, dql, wpath)
+  call self%ql%release(qx_traj)
+  call self%delp%release(delp_traj)
   have_ql = .true.
 endif
 
 ! Cloud ice water
 ! ---------------
 have_qi = .false.
-if (allocated(self%qi).and.allocated(self%delp).and.dxm%has_field('ice_wat').and.&
+if (self%qi%has().and.self%delp%has().and.dxm%has_field('ice_wat').and.&
     dxg%has_field('mass_content_of_cloud_ice_in_atmosphere_layer',qi_index)) then
   call dxg%get_field('mass_content_of_cloud_ice_in_atmosphere_layer', wpath)
   allocate(dqi(self%isc:self%iec,self%jsc:self%jec,self%npz))
   dqi=0.0_kind_real
-  call hydro_mixr_to_wpath_ad (geom, self%delp, self%qi, dqi, wpath)
+  call self%delp%get(delp_traj)
+  call self%qi%get(qx_traj)
+  call hydro_mixr_to_wpath_ad (geom, delp_traj, qx_traj, dqi, wpath)
+  call self%qi%release(qx_traj)
+  call self%delp%release(delp_traj)
   have_qi = .true.
 endif
 
 ! Rain
 ! ----
 have_qr = .false.
-if (allocated(self%qr).and.allocated(self%delp).and.dxm%has_field('rainwat').and.&
+if (self%qr%has().and.self%delp%has().and.dxm%has_field('rainwat').and.&
   dxg%has_field('mass_content_of_rain_in_atmosphere_layer',qr_index)) then
   call dxg%get_field('mass_content_of_rain_in_atmosphere_layer', wpath)
   allocate(dqr(self%isc:self%iec,self%jsc:self%jec,self%npz))
   dqr=0.0_kind_real
-  call hydro_mixr_to_wpath_ad (geom, self%delp, self%qr, dqr, wpath)
+  call self%delp%get(delp_traj)
+  call self%qr%get(qx_traj)
+  call hydro_mixr_to_wpath_ad (geom, delp_traj, qx_traj, dqr, wpath)
+  call self%qr%release(qx_traj)
+  call self%delp%release(delp_traj)
   have_qr = .true.
 endif
 
 ! Snow
 ! ----
 have_qs = .false.
-if (allocated(self%qs).and.allocated(self%delp).and.dxm%has_field('snowwat').and.&
+if (self%qs%has().and.self%delp%has().and.dxm%has_field('snowwat').and.&
   dxg%has_field('mass_content_of_snow_in_atmosphere_layer',qs_index)) then
   call dxg%get_field('mass_content_of_snow_in_atmosphere_layer', wpath)
   allocate(dqs(self%isc:self%iec,self%jsc:self%jec,self%npz))
   dqs=0.0_kind_real
-  call hydro_mixr_to_wpath_ad (geom, self%delp, self%qs, dqs, wpath)
+  call self%delp%get(delp_traj)
+  call self%qs%get(qx_traj)
+  call hydro_mixr_to_wpath_ad (geom, delp_traj, qx_traj, dqs, wpath)
+  call self%qs%release(qx_traj)
+  call self%delp%release(delp_traj)
   have_qs = .true.
 endif
 
 ! Graupel
 ! -------
 have_qg = .false.
-if (allocated(self%qg).and.allocated(self%delp).and.dxm%has_field('graupel').and.&
+if (self%qg%has().and.self%delp%has().and.dxm%has_field('graupel').and.&
   dxg%has_field('mass_content_of_graupel_in_atmosphere_layer',qg_index)) then
   call dxg%get_field('mass_content_of_graupel_in_atmosphere_layer', wpath)
   allocate(dqg(self%isc:self%iec,self%jsc:self%jec,self%npz))
   dqg=0.0_kind_real
-  call hydro_mixr_to_wpath_ad (geom, self%delp, self%qg, dqg, wpath)
+  call self%delp%get(delp_traj)
+  call self%qg%get(qx_traj)
+  call hydro_mixr_to_wpath_ad (geom, delp_traj, qx_traj, dqg, wpath)
+  call self%qg%release(qx_traj)
+  call self%delp%release(delp_traj)
   have_qg = .true.
 endif
 
@@ -794,17 +863,19 @@ endif
 
 have_o3mr = .false.
 if (have_o3ppmv) then
-  if (.not.allocated(self%o3)) call abor1_ftn("fv3jedi_lvc_model2geovals_mod.multiply no ozone" // &
-                                              "found in trajectory")
+  if (.not.self%o3%has()) call abor1_ftn("fv3jedi_lvc_model2geovals_mod.multiply no ozone" // &
+                                         "found in trajectory")
+  call self%o3%get(o3_traj)
   do k = 1, self%npz
     do j = self%jsc, self%jec
       do i = self%isc, self%iec
-        if (self%o3(i,j,k) < 0.0_kind_real ) then
+        if (o3_traj(i,j,k) < 0.0_kind_real ) then
           o3ppmv(i,j,k) = 0.0_kind_real
         endif
       enddo
     enddo
   enddo
+  call self%o3%release(o3_traj)
 
   ! Adjoint of ppmv to mixing ratio
   allocate(o3mr(self%isc:self%iec,self%jsc:self%jec,self%npz))
@@ -32,6 +32,14 @@ namespace fv3jedi {
 
 // -------------------------------------------------------------------------------------------------
 
+/// UFS model run in place through ESMF. Configuration keys:
+///   tstep:             time step of the exchanges with UFS
+///   forecast length:   length of the UFS forecast
+///   ufs_run_directory: directory holding the UFS configuration, run from there
+///   model variables:   fields exchanged with UFS
+///   debug level:       optional per field logging of the exchanges to the ESMF log, 0 (default)
+///                      for none, 1 for fields holding values beyond 1e30 and 2 for field ranges
+
 class ModelUFS: public oops::interface::ModelBase<Traits>,
                 private util::ObjectCounter<ModelUFS> {
  public:
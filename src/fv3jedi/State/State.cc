@@ -6,10 +6,12 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "boost/none_t.hpp"
@@ -41,7 +43,7 @@ State::State(const Geometry & geom, const oops::Variables & vars, const util::Da
   : geom_(geom),
     vars_(geom_.fieldsMetaData().getLongNameFromAnyName(vars)),
     varsJedi_(geom_.fieldsMetaData().removeInterfaceSpecificFields(vars)),
-    time_(time)
+    time_(time), version_(nextVersion())
 {
   oops::Log::trace() << "State::State (from geom, vars and time) starting" << std::endl;
   fv3jedi_state_create_f90(keyState_, geom_.toFortran(), vars_, time_);
@@ -51,7 +53,7 @@ State::State(const Geometry & geom, const oops::Variables & vars, const util::Da
 // -------------------------------------------------------------------------------------------------
 
 State::State(const Geometry & geom, const eckit::Configuration & config)
-  : geom_(geom), vars_(), varsJedi_(), time_(util::DateTime())
+  : geom_(geom), vars_(), varsJedi_(), time_(util::DateTime()), version_(nextVersion())
 {
   oops::Log::trace() << "State::State (from geom and parameters) starting" << std::endl;
   StateParameters params;
@@ -98,7 +100,8 @@ State::State(const Geometry & geom, const eckit::Configuration & config)
 // -------------------------------------------------------------------------------------------------
 
 State::State(const Geometry & resol, const State & other)
-  : geom_(resol), vars_(other.vars_), varsJedi_(other.varsJedi_), time_(other.time_)
+  : geom_(resol), vars_(other.vars_), varsJedi_(other.varsJedi_), time_(other.time_),
+    version_(nextVersion())
 {
   oops::Log::trace() << "State::State (from geom and other) starting" << std::endl;
   fv3jedi_state_create_f90(keyState_, geom_.toFortran(), vars_, time_);
@@ -121,7 +124,8 @@ State::State(const oops::Variables & vars, const State & other) : State(other)
 // -------------------------------------------------------------------------------------------------
 
 State::State(const State & other)
-  : geom_(other.geom_), vars_(other.vars_), varsJedi_(other.varsJedi_), time_(other.time_)
+  : geom_(other.geom_), vars_(other.vars_), varsJedi_(other.varsJedi_), time_(other.time_),
+    version_(other.version_)
 {
   oops::Log::trace() << "State::State (from other) starting" << std::endl;
   fv3jedi_state_create_f90(keyState_, geom_.toFortran(), vars_, time_);
@@ -140,6 +144,7 @@ State::~State() {
 State & State::operator=(const State & rhs) {
   fv3jedi_state_copy_f90(keyState_, rhs.keyState_);
   time_ = rhs.time_;
+  version_ = rhs.version_;
   return *this;
 }
 
@@ -150,6 +155,7 @@ void State::changeResolution(const State & other) {
   if (geom_.isEqual(other.geom_)) {
     fv3jedi_state_copy_f90(keyState_, other.keyState_);
     time_ = other.time_;
+    version_ = other.version_;
     return;
   }
 
@@ -183,6 +189,7 @@ void State::changeResolution(const State & other) {
 
 void State::updateFields(const oops::Variables & newVars) {
   const oops::Variables newLongVars = geom_.fieldsMetaData().getLongNameFromAnyName(newVars);
+  if (!(newLongVars == vars_)) version_ = nextVersion();
   vars_ = newLongVars;
   varsJedi_ = geom_.fieldsMetaData().removeInterfaceSpecificFields(newLongVars);
   fv3jedi_state_update_fields_f90(keyState_, geom_.toFortran(), vars_);
@@ -190,6 +197,15 @@ void State::updateFields(const oops::Variables & newVars) {
 
 // -------------------------------------------------------------------------------------------------
 
+void State::swapFields(State & other) {
+  fv3jedi_state_swap_fields_f90(keyState_, other.keyState_);
+  std::swap(vars_, other.vars_);
+  std::swap(varsJedi_, other.varsJedi_);
+  std::swap(version_, other.version_);
+}
+
+// -------------------------------------------------------------------------------------------------
+
 State & State::operator+=(const Increment & dx) {
   ASSERT(this->validTime() == dx.validTime());
   // Increment variables must be a equal to or a subset of the State variables
@@ -201,6 +217,7 @@ State & State::operator+=(const Increment & dx) {
   // needed for EnsRecenter, because that adds an increment to an *interpolated* state.
   this->synchronizeInterfaceFields();
   // Call transform and add
+  version_ = nextVersion();
   fv3jedi_state_add_increment_f90(keyState_, dx_sr.toFortran(), geom_.toFortran());
   return *this;
 }
@@ -208,12 +225,14 @@ State & State::operator+=(const Increment & dx) {
 // -------------------------------------------------------------------------------------------------
 
 void State::analytic_init(const eckit::Configuration & config, const Geometry & geom) {
+  version_ = nextVersion();
   fv3jedi_state_analytic_init_f90(keyState_, geom.toFortran(), config);
 }
 
 // -------------------------------------------------------------------------------------------------
 
 void State::read(const eckit::Configuration & config) {
+  version_ = nextVersion();
   StateParameters params;
   params.deserialize(config);
   // Optionally set the datetime on read (needed for some bump applications)
@@ -276,12 +295,14 @@ void State::print(std::ostream & os) const {
 // -------------------------------------------------------------------------------------------------
 
 void State::zero() {
+  version_ = nextVersion();
   fv3jedi_state_zero_f90(keyState_);
 }
 
 // -------------------------------------------------------------------------------------------------
 
 void State::accumul(const double & zz, const State & xx) {
+  version_ = nextVersion();
   fv3jedi_state_axpy_f90(keyState_, zz, xx.keyState_);
 }
 
@@ -303,11 +324,33 @@ void State::toFieldSet(atlas::FieldSet & fset) const {
 // -------------------------------------------------------------------------------------------------
 
 void State::fromFieldSet(const atlas::FieldSet & fset) {
+  version_ = nextVersion();
   fv3jedi_state_from_fieldset_f90(keyState_, geom_.toFortran(), varsJedi_, fset.get());
 }
 
 // -------------------------------------------------------------------------------------------------
 
+void State::fromFieldSet(const oops::Variables & vars, const atlas::FieldSet & fset) {
+  version_ = nextVersion();
+  const oops::Variables longVars = geom_.fieldsMetaData().getLongNameFromAnyName(vars);
+  fv3jedi_state_from_fieldset_f90(keyState_, geom_.toFortran(), longVars, fset.get());
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void State::addDerivedFields(const oops::Variables & vars, const atlas::FieldSet & fset) {
+  // Fields computed from the existing ones add no information, so caches keyed on the version of
+  // this State stay valid
+  const size_t version = version_;
+  oops::Variables allVars = vars_;
+  allVars += vars;
+  this->updateFields(allVars);
+  this->fromFieldSet(vars, fset);
+  version_ = version;
+}
+
+// -------------------------------------------------------------------------------------------------
+
 void State::synchronizeInterfaceFields() const {
   fv3jedi_state_synchronize_interface_fields_f90(keyState_, geom_.toFortran());
 }
@@ -337,6 +380,7 @@ void State::deserializeSection(const std::vector<double> & vect, int & size_fld,
      int & iec, int & jsc, int & jec, int & isc_sg, int & iec_sg, int & jsc_sg, int & jec_sg,
      size_t & ind_local) {
   oops::Log::trace() << "State deserialize starting" << std::endl;
+  version_ = nextVersion();
   fv3jedi_state_deserializeSection_f90(keyState_, size_fld, vect.data(), isc, iec, jsc, jec,
            isc_sg, iec_sg, jsc_sg, jec_sg, ind_local);
 
@@ -347,6 +391,7 @@ void State::deserializeSection(const std::vector<double> & vect, int & size_fld,
 // -------------------------------------------------------------------------------------------------
 void State::transpose(const State & FCState, const eckit::mpi::Comm & global, const int & mytask,
     const int & ensNum, const int & transNum ) {
+  version_ = nextVersion();
 
   int ist_fc, iend_fc, jst_fc, jend_fc, kst_fc, kend_fc, npz_fc;
   int ist_da, iend_da, jst_da, jend_da, kst_da, kend_da, npz_da;
@@ -489,6 +534,7 @@ void State::serialize(std::vector<double> & vect) const {
 
 void State::deserialize(const std::vector<double> & vect, size_t & index) {
   oops::Log::trace() << "State deserialize starting" << std::endl;
+  version_ = nextVersion();
   fv3jedi_state_deserialize_f90(keyState_, vect.size(), vect.data(), index);
 
   ASSERT(vect.at(index) == -54321.56789);
@@ -500,4 +546,11 @@ void State::deserialize(const std::vector<double> & vect, size_t & index) {
 
 // -------------------------------------------------------------------------------------------------
 
+size_t State::nextVersion() {
+  static std::atomic<size_t> counter{0};
+  return ++counter;
+}
+
+// -------------------------------------------------------------------------------------------------
+
 }  // namespace fv3jedi
@@ -111,6 +111,8 @@ class State : public util::Printable, private util::ObjectCounter<State> {
 
 // Add or remove fields
   void updateFields(const oops::Variables &);
+  // Exchange fields and variables with another State without copying the data
+  void swapFields(State &);
 
 // Utilities
   const Geometry & geometry() const {return geom_;}
@@ -126,10 +128,19 @@ class State : public util::Printable, private util::ObjectCounter<State> {
 // Accessors to the ATLAS fieldset
   void toFieldSet(atlas::FieldSet &) const;
   void fromFieldSet(const atlas::FieldSet &);
+  // Fill only the listed variables, leaving the other fields untouched
+  void fromFieldSet(const oops::Variables &, const atlas::FieldSet &);
+  // Add the listed variables, computed from the other fields, keeping the version
+  void addDerivedFields(const oops::Variables &, const atlas::FieldSet &);
 
-  int & toFortran() {return keyState_;}
+  // Non-const access is how the Fortran fields get written, so it counts as a modification
+  int & toFortran() {version_ = nextVersion(); return keyState_;}
   const int & toFortran() const {return keyState_;}
 
+  // Identifier of the current field values, used to key caches of quantities derived from the
+  // State. Changed whenever field data is written; copies share the version of their source.
+  size_t version() const {return version_;}
+
   // Const w.r.t. JEDI, but does update internal fortran state (i.e., the interface-specific fields)
   // to synchronize it with the JEDI-presented fields.
   void synchronizeInterfaceFields() const;
@@ -139,12 +150,14 @@ class State : public util::Printable, private util::ObjectCounter<State> {
 // Private methods and variables
  private:
   void print(std::ostream &) const;
+  static size_t nextVersion();
   F90state keyState_;
   const Geometry & geom_;
   oops::Variables stdvars_;
   oops::Variables vars_;
   oops::Variables varsJedi_;  // subset of vars_; excluding interface-specific variables
   util::DateTime time_;
+  size_t version_;
 };
 
 // -------------------------------------------------------------------------------------------------
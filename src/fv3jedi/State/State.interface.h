@@ -21,6 +21,7 @@ extern "C" {
   void fv3jedi_state_axpy_f90(const F90state &, const double &, const F90state &);
   void fv3jedi_state_add_increment_f90(const F90state &, const F90inc &, const F90geom &);
   void fv3jedi_state_update_fields_f90(F90state &, const F90geom &, const oops::Variables &);
+  void fv3jedi_state_swap_fields_f90(const F90state &, const F90state &);
   void fv3jedi_state_analytic_init_f90(const F90state &, const F90geom &,
                                        const eckit::Configuration &);
   void fv3jedi_state_to_fieldset_f90(const F90state &, const F90geom &, const oops::Variables &,
@@ -29,6 +30,9 @@ extern "C" {
                                        const atlas::field::FieldSetImpl *);
   void fv3jedi_state_synchronize_interface_fields_f90(const F90state &, const F90geom &);
   void fv3jedi_state_set_interface_fields_outofdate_f90(const F90state &, const bool &);
+  void fv3jedi_state_vertical_coord_f90(const F90state &, const F90geom &,
+                                        const eckit::Configuration &, const std::size_t &,
+                                        double[]);
   void fv3jedi_state_sersize_f90(const F90state &, int &);
 
   void fv3jedi_state_serialize_f90(const F90state &, const std::size_t &, double[]);
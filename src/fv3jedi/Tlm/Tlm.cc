@@ -18,7 +18,6 @@
 #include "fv3jedi/State/State.h"
 #include "fv3jedi/Tlm/Tlm.h"
 #include "fv3jedi/Tlm/Tlm.interface.h"
-#include "fv3jedi/Tlm/Traj.interface.h"
 #include "fv3jedi/Utilities/Traits.h"
 
 namespace fv3jedi {
@@ -27,13 +26,11 @@ namespace fv3jedi {
 static oops::interface::LinearModelMaker<Traits, Tlm> makerTLM_("FV3JEDITLM");
 // -------------------------------------------------------------------------------------------------
 Tlm::Tlm(const Geometry & resol, const eckit::Configuration & config)
-  : keySelf_(0), tstep_(), trajmap_(), linvars_(), an2model_(), finalVars_()
+  : keySelf_(0), tstep_(config.getString("tstep")), trajectories_(resol, config, tstep_),
+    linvars_(), an2model_(), finalVars_(), checkpoints_()
 {
   oops::Log::trace() << "Tlm::Tlm starting" << std::endl;
 
-  // Store time step
-  tstep_ = util::Duration(config.getString("tstep"));
-
   oops::Variables tlvars(config, "tlm variables");
   linvars_ = oops::Variables(resol.fieldsMetaData().getLongNameFromAnyName(tlvars));
 
@@ -41,6 +38,15 @@ Tlm::Tlm(const Geometry & resol, const eckit::Configuration & config)
   linVarChangeConfig.set("linear variable change name", "Analysis2Model");
   an2model_.reset(new LinearVariableChange(resol, linVarChangeConfig));
 
+  // Optionally recompute the trajectory from checkpoints rather than storing every step
+  if (config.has("trajectory checkpointing")) {
+    ASSERT_MSG(!config.has("trajectory storage") && !config.has("trajectory interpolation"),
+               "Tlm: trajectory checkpointing excludes trajectory storage and interpolation");
+    const eckit::LocalConfiguration checkpointConfig(config, "trajectory checkpointing");
+    checkpoints_.reset(new TrajectoryCheckpoints(resol, checkpointConfig, tstep_, *an2model_,
+                                                 linvars_));
+  }
+
   // Implementation
   fv3jedi_tlm_create_f90(keySelf_, resol.toFortran(), config);
 
@@ -53,16 +59,19 @@ Tlm::~Tlm() {
   // Implementation
   fv3jedi_tlm_delete_f90(keySelf_);
 
-  // Clear trajecotory
-  for (trajIter jtra = trajmap_.begin(); jtra != trajmap_.end(); ++jtra) {
-    fv3jedi_traj_wipe_f90(jtra->second);
-  }
   oops::Log::trace() << "Tlm::~Tlm done" << std::endl;
 }
 // -------------------------------------------------------------------------------------------------
 void Tlm::setTrajectory(const State & xx, State & xlr, const ModelBias & bias) {
   oops::Log::trace() << "Tlm::setTrajectory starting" << std::endl;
 
+  // Only checkpoints are kept, trajectories are computed when they are used
+  if (checkpoints_) {
+    checkpoints_->insert(xx);
+    oops::Log::trace() << "Tlm::setTrajectory done" << std::endl;
+    return;
+  }
+
   // Interpolate to resolution of the trajectory
   xlr.changeResolution(xx);
 
@@ -72,10 +81,7 @@ void Tlm::setTrajectory(const State & xx, State & xlr, const ModelBias & bias) {
   an2model_->changeVarTraj(xlr, linvars_);
 
   // Set trajectory
-  int keyTraj = 0;
-  fv3jedi_traj_set_f90(keyTraj, xlr.toFortran());
-  ASSERT(keyTraj != 0);
-  trajmap_[xx.validTime()] = keyTraj;
+  trajectories_.insert(xx.validTime(), xlr);
 
   oops::Log::trace() << "Tlm::setTrajectory done" << std::endl;
 }
@@ -84,13 +90,7 @@ void Tlm::initializeTL(Increment & dx) const {
   oops::Log::trace() << "Tlm::initializeTL starting" << std::endl;
 
   // Get traj index
-  trajICst itra = trajmap_.find(dx.validTime());
-
-  // Check traj is available
-  if (itra == trajmap_.end()) {
-    oops::Log::error() << "Tlm: trajectory not available at time " << dx.validTime() << std::endl;
-    ABORT("Tlm: trajectory not available");
-  }
+  const F90traj keyTraj = trajectory(dx.validTime(), true);
 
   ASSERT_MSG(!finalVars_, "finalVars_ should always be null when calling initializeTL");
   if (!(linvars_ <= dx.variablesIncludingInterfaceFields())) {
@@ -103,7 +103,7 @@ void Tlm::initializeTL(Increment & dx) const {
   }
 
   // Implementation
-  fv3jedi_tlm_initialize_tl_f90(keySelf_, dx.toFortran(), itra->second);
+  fv3jedi_tlm_initialize_tl_f90(keySelf_, dx.toFortran(), keyTraj);
 
   oops::Log::trace() << "Tlm::initializeTL done" << std::endl;
 }
@@ -112,16 +112,10 @@ void Tlm::stepTL(Increment & dx, const ModelBiasIncrement &) const {
   oops::Log::trace() << "Tlm::stepTL starting" << std::endl;
 
   // Get traj index
-  trajICst itra = trajmap_.find(dx.validTime());
-
-  // Check traj is available
-  if (itra == trajmap_.end()) {
-    oops::Log::error() << "Tlm: trajectory not available at time " << dx.validTime() << std::endl;
-    ABORT("Tlm: trajectory not available");
-  }
+  const F90traj keyTraj = trajectory(dx.validTime(), true);
 
   // Implementation
-  fv3jedi_tlm_step_tl_f90(keySelf_, dx.toFortran(), itra->second);
+  fv3jedi_tlm_step_tl_f90(keySelf_, dx.toFortran(), keyTraj);
 
   // Tick increment clock
   dx.validTime() += tstep_;
@@ -148,13 +142,7 @@ void Tlm::initializeAD(Increment & dx) const {
   oops::Log::trace() << "Tlm::initializeAD starting" << std::endl;
 
   // Get traj index
-  trajICst itra = trajmap_.find(dx.validTime());
-
-  // Check traj is available
-  if (itra == trajmap_.end()) {
-    oops::Log::error() << "Tlm: trajectory not available at time " << dx.validTime() << std::endl;
-    ABORT("Tlm: trajectory not available");
-  }
+  const F90traj keyTraj = trajectory(dx.validTime(), false);
 
   ASSERT_MSG(!finalVars_, "finalVars_ should always be null when calling initializeAD");
   if (!(linvars_ <= dx.variablesIncludingInterfaceFields())) {
@@ -166,7 +154,7 @@ void Tlm::initializeAD(Increment & dx) const {
   }
 
   // Implementation
-  fv3jedi_tlm_initialize_ad_f90(keySelf_, dx.toFortran(), itra->second);
+  fv3jedi_tlm_initialize_ad_f90(keySelf_, dx.toFortran(), keyTraj);
 
   oops::Log::trace() << "Tlm::initializeAD done" << std::endl;
 }
@@ -178,20 +166,14 @@ void Tlm::stepAD(Increment & dx, ModelBiasIncrement &) const {
   dx.validTime() -= tstep_;
 
   // Get traj index
-  trajICst itra = trajmap_.find(dx.validTime());
-
-  // Check traj is available
-  if (itra == trajmap_.end()) {
-    oops::Log::error() << "Tlm: trajectory not available at time " << dx.validTime() << std::endl;
-    ABORT("Tlm: trajectory not available");
-  }
+  const F90traj keyTraj = trajectory(dx.validTime(), false);
 
   // Make sure interface-specific fields are synchronized
   // They could be desynchronized if an adjoint postprocessor was run before stepAD
   dx.synchronizeInterfaceFields();
 
   // Implementation
-  fv3jedi_tlm_step_ad_f90(keySelf_, dx.toFortran(), itra->second);
+  fv3jedi_tlm_step_ad_f90(keySelf_, dx.toFortran(), keyTraj);
 
   oops::Log::trace() << "Tlm::stepAD done" << std::endl;
 }
@@ -215,17 +197,20 @@ void Tlm::finalizeAD(Increment & dx) const {
   oops::Log::trace() << "Tlm::finalizeAD done" << std::endl;
 }
 // -------------------------------------------------------------------------------------------------
+F90traj Tlm::trajectory(const util::DateTime & time, const bool forward) const {
+  // Recomputed from checkpoints or stored, possibly read back from disk
+  if (checkpoints_) return checkpoints_->get(time, forward);
+  return trajectories_.get(time, forward);
+}
+// -------------------------------------------------------------------------------------------------
 void Tlm::print(std::ostream & os) const {
   oops::Log::trace() << "Tlm::print starting" << std::endl;
 
   // Print information about the Tlm object
-  os << "FV3JEDI TLM Trajectory, nstep=" << trajmap_.size() << std::endl;
-  typedef std::map< util::DateTime, int >::const_iterator trajICst;
-  if (trajmap_.size() > 0) {
-    os << "FV3JEDI TLM Trajectory: times are:";
-    for (trajICst jtra = trajmap_.begin(); jtra != trajmap_.end(); ++jtra) {
-      os << "  " << jtra->first;
-    }
+  if (checkpoints_) {
+    checkpoints_->print(os);
+  } else {
+    trajectories_.print(os);
   }
 
   oops::Log::trace() << "Tlm::print done" << std::endl;
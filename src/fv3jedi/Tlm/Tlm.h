@@ -18,6 +18,8 @@
 #include "oops/util/Printable.h"
 
 #include "fv3jedi/LinearVariableChange/Base/LinearVariableChangeBase.h"
+#include "fv3jedi/Tlm/TrajectoryCheckpoints.h"
+#include "fv3jedi/Tlm/TrajectoryStore.h"
 #include "fv3jedi/Utilities/Traits.h"
 
 // Forward declarations
@@ -73,20 +75,20 @@ class Tlm: public oops::interface::LinearModelBase<Traits>,
 
   // Accessor functions
   const util::Duration & timeResolution() const override {return tstep_;}
-  const util::Duration & stepTrajectory() const override {return tstep_;}
+  const util::Duration & stepTrajectory() const override {return trajectories_.interval();}
 
  private:
   void print(std::ostream &) const override;
-  typedef std::map< util::DateTime, int >::iterator trajIter;
-  typedef std::map< util::DateTime, int >::const_iterator trajICst;
+  F90traj trajectory(const util::DateTime &, const bool) const;
 
 // Data
   F90model keySelf_;
   util::Duration tstep_;
-  std::map<util::DateTime, F90traj> trajmap_;
+  TrajectoryStore trajectories_;
   oops::Variables linvars_;
   std::unique_ptr<LinearVariableChange> an2model_;
   mutable std::unique_ptr<const oops::Variables> finalVars_;
+  std::unique_ptr<TrajectoryCheckpoints> checkpoints_;
 };
 // -------------------------------------------------------------------------------------------------
 
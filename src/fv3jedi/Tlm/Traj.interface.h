@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 #include "fv3jedi/Utilities/interface.h"
 
 // Forward declarations
@@ -25,6 +27,11 @@ extern "C" {
 
   void fv3jedi_traj_set_f90(F90traj &, const F90state &);
   void fv3jedi_traj_wipe_f90(F90traj &);
+  void fv3jedi_traj_spill_f90(const F90traj &, const eckit::Configuration &);
+  void fv3jedi_traj_load_f90(const F90traj &, const eckit::Configuration &);
+  void fv3jedi_traj_load_buffer_f90(const F90traj &, const size_t &, const char[]);
+  void fv3jedi_traj_interpolate_f90(F90traj &, const int &, const F90traj[], const double[]);
+  void fv3jedi_traj_difference_norms_f90(const F90traj &, const F90traj &, double[]);
 
 }  // extern "C"
 // -----------------------------------------------------------------------------
@@ -0,0 +1,190 @@
+/*
+ * (C) Copyright 2024 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+
+#include "eckit/exception/Exceptions.h"
+
+#include "oops/util/abor1_cpp.h"
+#include "oops/util/Logger.h"
+
+#include "fv3jedi/LinearVariableChange/LinearVariableChange.h"
+#include "fv3jedi/ModelBias/ModelBias.h"
+#include "fv3jedi/State/State.h"
+#include "fv3jedi/Tlm/TrajectoryCheckpoints.h"
+#include "fv3jedi/Tlm/Traj.interface.h"
+
+namespace fv3jedi {
+
+// -------------------------------------------------------------------------------------------------
+
+namespace {
+
+// Number of steps that s checkpoints can reverse with r recomputations of each step
+double binomialReach(const size_t s, const size_t r) {
+  double reach = 1.0;
+  for (size_t i = 1; i <= s; ++i) reach = reach * static_cast<double>(r + i) / i;
+  return reach;
+}
+
+// Optimal distance to the next checkpoint when l steps are to be reversed with s free checkpoints
+size_t revolveStride(const size_t l, const size_t s) {
+  size_t r = 0;
+  while (binomialReach(s, r) < l) ++r;
+  const double rest = binomialReach(s - 1, r);
+  return l > rest ? l - static_cast<size_t>(rest) : 1;
+}
+
+}  // namespace
+
+// -------------------------------------------------------------------------------------------------
+TrajectoryCheckpoints::TrajectoryCheckpoints(const Geometry & resol,
+                                             const eckit::Configuration & config,
+                                             const util::Duration & tstep,
+                                             LinearVariableChange & an2model,
+                                             const oops::Variables & linvars)
+  : resol_(resol), tstep_(tstep), an2model_(an2model), linvars_(linvars),
+    modelConfig_(config, "model"), maxCheckpoints_(config.getUnsigned("checkpoints")),
+    maxBase_(0), model_(), bias_(), first_(), last_(), stride_(1), base_(), extra_(), cursor_(),
+    traj_(0), trajTime_(), recomputed_(0)
+{
+  ASSERT_MSG(maxCheckpoints_ >= 2, "TrajectoryCheckpoints: at least two checkpoints are needed");
+  maxBase_ = maxCheckpoints_ / 2;
+  oops::Log::info() << "TrajectoryCheckpoints: recomputing the trajectory from at most "
+                    << maxCheckpoints_ << " checkpoints" << std::endl;
+}
+// -------------------------------------------------------------------------------------------------
+TrajectoryCheckpoints::~TrajectoryCheckpoints() {
+  oops::Log::info() << "TrajectoryCheckpoints: " << recomputed_
+                    << " nonlinear steps were recomputed" << std::endl;
+  clear();
+}
+// -------------------------------------------------------------------------------------------------
+void TrajectoryCheckpoints::clear() {
+  base_.clear();
+  extra_.clear();
+  cursor_.reset();
+  if (traj_ != 0) fv3jedi_traj_wipe_f90(traj_);
+  traj_ = 0;
+}
+// -------------------------------------------------------------------------------------------------
+int64_t TrajectoryCheckpoints::steps(const util::DateTime & t1, const util::DateTime & t2) const {
+  return (t2 - t1).toSeconds() / tstep_.toSeconds();
+}
+// -------------------------------------------------------------------------------------------------
+void TrajectoryCheckpoints::insert(const State & xx) {
+  const util::DateTime & time = xx.validTime();
+
+  // A trajectory starting again belongs to the next outer loop
+  if (!base_.empty() && time <= last_) clear();
+
+  if (!model_) {
+    model_.reset(oops::interface::ModelFactory<Traits>::create(xx.geometry(), modelConfig_));
+    bias_.reset(new ModelBias(xx.geometry(), eckit::LocalConfiguration()));
+    ASSERT_MSG(model_->timeResolution() == tstep_,
+               "TrajectoryCheckpoints: model and linear model time steps differ");
+  }
+
+  if (base_.empty()) {
+    first_ = time;
+    stride_ = 1;
+  }
+  last_ = time;
+
+  if (steps(first_, time) % stride_ != 0) return;
+  base_[time].reset(new State(xx));
+
+  // Over budget, double the distance between checkpoints
+  while (base_.size() > maxBase_ && base_.size() > 1) {
+    stride_ *= 2;
+    for (auto jchk = base_.begin(); jchk != base_.end(); ) {
+      if (steps(first_, jchk->first) % stride_ != 0) {
+        jchk = base_.erase(jchk);
+      } else {
+        ++jchk;
+      }
+    }
+  }
+}
+// -------------------------------------------------------------------------------------------------
+F90traj TrajectoryCheckpoints::get(const util::DateTime & time, const bool forward) const {
+  if (traj_ != 0 && trajTime_ == time) return traj_;
+
+  if (base_.empty() || time < first_ || time > last_) {
+    oops::Log::error() << "Tlm: trajectory not available at time " << time << std::endl;
+    ABORT("Tlm: trajectory not available");
+  }
+
+  // Same steps as Tlm::setTrajectory applied to the recomputed state
+  State xlr(resol_, state(time, forward));
+  xlr.synchronizeInterfaceFields();
+  an2model_.changeVarTraj(xlr, linvars_);
+
+  if (traj_ != 0) fv3jedi_traj_wipe_f90(traj_);
+  traj_ = 0;
+  fv3jedi_traj_set_f90(traj_, xlr.toFortran());
+  ASSERT(traj_ != 0);
+  trajTime_ = time;
+
+  return traj_;
+}
+// -------------------------------------------------------------------------------------------------
+const State & TrajectoryCheckpoints::state(const util::DateTime & time, const bool forward) const {
+  // Checkpoints the adjoint sweep has passed are not needed again
+  if (!forward) extra_.erase(extra_.upper_bound(time), extra_.end());
+
+  auto ibase = base_.find(time);
+  if (ibase != base_.end()) return *ibase->second;
+  auto iextra = extra_.find(time);
+  if (iextra != extra_.end()) return *iextra->second;
+  if (cursor_ && cursor_->validTime() == time) return *cursor_;
+
+  // Latest checkpoint before the time, the working state continues if it is closer
+  const State * start = std::prev(base_.upper_bound(time))->second.get();
+  iextra = extra_.upper_bound(time);
+  if (iextra != extra_.begin() && std::prev(iextra)->first > start->validTime()) {
+    start = std::prev(iextra)->second.get();
+  }
+  if (!cursor_ || cursor_->validTime() > time || cursor_->validTime() < start->validTime()) {
+    cursor_.reset(new State(*start));
+  }
+
+  // The working state counts against the budget too
+  size_t free = maxCheckpoints_ - std::min(maxCheckpoints_, base_.size() + extra_.size() + 1);
+  while (cursor_->validTime() < time) {
+    const size_t l = steps(cursor_->validTime(), time);
+    if (forward || free == 0 || l == 1) {
+      advance(*cursor_, l);
+    } else {
+      const size_t m = revolveStride(l, free);
+      advance(*cursor_, m);
+      if (m < l) {
+        extra_[cursor_->validTime()].reset(new State(*cursor_));
+        --free;
+      }
+    }
+  }
+
+  return *cursor_;
+}
+// -------------------------------------------------------------------------------------------------
+void TrajectoryCheckpoints::advance(State & xx, const size_t nsteps) const {
+  model_->initialize(xx);
+  for (size_t jstep = 0; jstep < nsteps; ++jstep) model_->step(xx, *bias_);
+  model_->finalize(xx);
+  recomputed_ += nsteps;
+}
+// -------------------------------------------------------------------------------------------------
+void TrajectoryCheckpoints::print(std::ostream & os) const {
+  os << "FV3JEDI TLM Trajectory: " << base_.size() << " checkpoints every " << stride_
+     << " steps from " << first_ << " to " << last_ << ", " << extra_.size()
+     << " adjoint checkpoints, " << recomputed_ << " steps recomputed";
+}
+// -------------------------------------------------------------------------------------------------
+}  // namespace fv3jedi
@@ -0,0 +1,98 @@
+/*
+ * (C) Copyright 2024 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <ostream>
+
+#include "eckit/config/LocalConfiguration.h"
+
+#include "oops/base/Variables.h"
+#include "oops/interface/ModelBase.h"
+#include "oops/util/DateTime.h"
+#include "oops/util/Duration.h"
+
+#include "fv3jedi/Geometry/Geometry.h"
+#include "fv3jedi/Utilities/interface.h"
+#include "fv3jedi/Utilities/Traits.h"
+
+namespace fv3jedi {
+  class LinearVariableChange;
+  class ModelBias;
+  class State;
+
+// -------------------------------------------------------------------------------------------------
+
+/// Trajectory of the linear model recomputed from checkpoints of the nonlinear model.
+///
+/// Instead of a trajectory per time step at most "checkpoints" model states are held, counting the
+/// working state that recomputation advances. While the nonlinear model runs, half of them hold
+/// states spread evenly over the window: the first step is always kept and every other checkpoint
+/// is dropped whenever that half is exceeded. Trajectories in between are recomputed with the
+/// nonlinear "model" from the latest earlier checkpoint. The tangent linear sweep advances the
+/// working state step by step. The adjoint sweep runs backwards and places the remaining
+/// checkpoints where binomial checkpointing (revolve) puts them, which bounds the number of extra
+/// nonlinear steps for the given memory. On top of the budget, the trajectory of the step in use is
+/// held, and while it is set a copy of its state: at most "checkpoints" + 1 states and one
+/// trajectory.
+
+class TrajectoryCheckpoints {
+ public:
+  TrajectoryCheckpoints(const Geometry &, const eckit::Configuration &, const util::Duration &,
+                        LinearVariableChange &, const oops::Variables &);
+  ~TrajectoryCheckpoints();
+
+  TrajectoryCheckpoints(const TrajectoryCheckpoints &) = delete;
+  TrajectoryCheckpoints & operator=(const TrajectoryCheckpoints &) = delete;
+
+  /// Offer the nonlinear state of a time step
+  void insert(const State &);
+
+  /// Trajectory at a time, recomputed if needed; forward is false during the adjoint sweep
+  F90traj get(const util::DateTime &, const bool forward) const;
+
+  void print(std::ostream &) const;
+
+ private:
+  void clear();
+  const State & state(const util::DateTime &, const bool) const;
+  void advance(State &, const size_t) const;
+  int64_t steps(const util::DateTime &, const util::DateTime &) const;
+
+  const Geometry resol_;
+  const util::Duration tstep_;
+  LinearVariableChange & an2model_;
+  const oops::Variables linvars_;
+  const eckit::LocalConfiguration modelConfig_;
+  const size_t maxCheckpoints_;
+  size_t maxBase_;
+
+  std::unique_ptr<oops::interface::ModelBase<Traits>> model_;
+  std::unique_ptr<ModelBias> bias_;
+
+  // Checkpoints from the nonlinear run, every stride_ steps from first_
+  util::DateTime first_;
+  util::DateTime last_;
+  int64_t stride_;
+  std::map<util::DateTime, std::unique_ptr<State>> base_;
+
+  // Checkpoints placed during the adjoint sweep and the working state
+  mutable std::map<util::DateTime, std::unique_ptr<State>> extra_;
+  mutable std::unique_ptr<State> cursor_;
+
+  // Trajectory of the step in use
+  mutable F90traj traj_;
+  mutable util::DateTime trajTime_;
+  mutable size_t recomputed_;
+};
+
+// -------------------------------------------------------------------------------------------------
+
+}  // namespace fv3jedi
@@ -0,0 +1,315 @@
+/*
+ * (C) Copyright 2024 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "eckit/config/LocalConfiguration.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/mpi/Comm.h"
+
+#include "oops/util/abor1_cpp.h"
+#include "oops/util/Logger.h"
+
+#include "fv3jedi/Geometry/Geometry.h"
+#include "fv3jedi/State/State.h"
+#include "fv3jedi/Tlm/TrajectoryStore.h"
+#include "fv3jedi/Tlm/Traj.interface.h"
+
+namespace fv3jedi {
+
+// -------------------------------------------------------------------------------------------------
+TrajectoryStore::TrajectoryStore(const Geometry & geom, const eckit::Configuration & config,
+                                 const util::Duration & tstep)
+  : comm_(geom.getComm()), tstep_(tstep), trajmap_(), interval_(tstep), cubic_(false),
+    diagnostics_(false), interp_(0), interpTime_(), spill_(false), directory_(), prefix_(),
+    stepsInMemory_(0), singlePrecision_(false), resident_(), onDisk_(), prefetches_()
+{
+  if (config.has("trajectory interpolation")) {
+    const eckit::LocalConfiguration interpConfig(config, "trajectory interpolation");
+    interval_ = util::Duration(interpConfig.getString("interval"));
+    const std::string method = interpConfig.getString("method", "linear");
+    ASSERT_MSG(method == "linear" || method == "cubic",
+               "TrajectoryStore: interpolation method must be linear or cubic");
+    cubic_ = method == "cubic";
+    diagnostics_ = interpConfig.getBool("diagnostics", false);
+    ASSERT_MSG(interval_.toSeconds() > 0 && interval_.toSeconds() % tstep_.toSeconds() == 0,
+               "TrajectoryStore: interpolation interval must be a multiple of the time step");
+
+    oops::Log::info() << "TrajectoryStore: trajectory every " << interval_ << ", " << method
+                      << " interpolation in between" << std::endl;
+  }
+
+  if (!config.has("trajectory storage")) return;
+
+  const eckit::LocalConfiguration storageConfig(config, "trajectory storage");
+  spill_ = true;
+  directory_ = storageConfig.getString("directory");
+  // Interpolation needs the whole stencil resident plus the next step being prefetched
+  const size_t minSteps = interval_ == tstep_ ? 1 : (cubic_ ? 4 : 2) + 1;
+  stepsInMemory_ = storageConfig.getUnsigned("steps in memory", std::max<size_t>(minSteps, 2));
+  singlePrecision_ = storageConfig.getBool("single precision", false);
+  ASSERT_MSG(stepsInMemory_ >= 1, "TrajectoryStore: steps in memory must be at least one");
+  ASSERT_MSG(stepsInMemory_ >= minSteps, "TrajectoryStore: interpolation needs the stencil plus "
+             "one step in memory, three steps for linear and five for cubic");
+
+  eckit::PathName(directory_).mkdir();
+
+  // Files are per process and per store so that several linear models, on any communicator, and
+  // several executables can share the directory
+  static size_t instances = 0;
+  prefix_ = directory_ + "/fv3jedi_traj_" + std::to_string(eckit::mpi::comm().rank()) + "_"
+            + std::to_string(::getpid()) + "_" + std::to_string(instances++);
+
+  oops::Log::info() << "TrajectoryStore: holding " << stepsInMemory_ << " steps in memory, "
+                    << "spilling to " << directory_
+                    << (singlePrecision_ ? " in single precision" : "") << std::endl;
+}
+// -------------------------------------------------------------------------------------------------
+TrajectoryStore::~TrajectoryStore() {
+  prefetches_.clear();  // Waits for reads in flight, their data is not needed
+  if (interp_ != 0) fv3jedi_traj_wipe_f90(interp_);
+  for (auto & jtra : trajmap_) {
+    fv3jedi_traj_wipe_f90(jtra.second);
+    if (onDisk_.count(jtra.first)) eckit::PathName(filename(jtra.first)).unlink();
+  }
+}
+// -------------------------------------------------------------------------------------------------
+void TrajectoryStore::insert(const util::DateTime & time, const State & xx) {
+  waitPrefetches();
+  if (interp_ != 0) fv3jedi_traj_wipe_f90(interp_);
+  interp_ = 0;
+
+  // Replace any trajectory already held at this time
+  auto itra = trajmap_.find(time);
+  if (itra != trajmap_.end()) {
+    fv3jedi_traj_wipe_f90(itra->second);
+    trajmap_.erase(itra);
+    resident_.remove(time);
+    if (onDisk_.erase(time)) eckit::PathName(filename(time)).unlink();
+  }
+
+  F90traj keyTraj = 0;
+  fv3jedi_traj_set_f90(keyTraj, xx.toFortran());
+  ASSERT(keyTraj != 0);
+  trajmap_[time] = keyTraj;
+
+  // Written through straight away so that every step, in memory or reloaded, has the same values
+  if (spill_) {
+    eckit::LocalConfiguration spillConfig;
+    spillConfig.set("filename", filename(time));
+    spillConfig.set("single precision", singlePrecision_);
+    spillConfig.set("release", false);
+    fv3jedi_traj_spill_f90(keyTraj, spillConfig);
+    onDisk_.insert(time);
+    resident_.push_front(time);
+    evict(stepsInMemory_, time, time);
+  }
+
+  if (diagnostics_) interpolationDiagnostics(time);
+}
+// -------------------------------------------------------------------------------------------------
+F90traj TrajectoryStore::get(const util::DateTime & time, const bool forward) const {
+  auto itra = trajmap_.find(time);
+  if (itra == trajmap_.end()) {
+    if (interval_ != tstep_) return interpolated(time, forward);
+    oops::Log::error() << "Tlm: trajectory not available at time " << time << std::endl;
+    ABORT("Tlm: trajectory not available");
+  }
+
+  if (spill_) {
+    makeResident(time);
+    prefetch(forward ? time + tstep_ : time - tstep_);
+  }
+
+  return itra->second;
+}
+// -------------------------------------------------------------------------------------------------
+F90traj TrajectoryStore::interpolated(const util::DateTime & time, const bool forward) const {
+  if (interp_ != 0 && interpTime_ == time) return interp_;
+
+  // Stored steps either side of the time
+  auto inext = trajmap_.upper_bound(time);
+  if (inext == trajmap_.begin() || inext == trajmap_.end()) {
+    oops::Log::error() << "Tlm: trajectory not available at time " << time << std::endl;
+    ABORT("Tlm: trajectory not available");
+  }
+  auto iprev = std::prev(inext);
+
+  std::vector<util::DateTime> times{iprev->first, inext->first};
+  if (cubic_ && iprev != trajmap_.begin() && std::next(inext) != trajmap_.end()) {
+    times.insert(times.begin(), std::prev(iprev)->first);
+    times.push_back(std::next(inext)->first);
+  }
+
+  // Lagrange weights through the stored steps
+  std::vector<double> weights(times.size(), 1.0);
+  for (size_t jt = 0; jt < times.size(); ++jt) {
+    for (size_t kt = 0; kt < times.size(); ++kt) {
+      if (kt == jt) continue;
+      weights[jt] *= static_cast<double>((time - times[kt]).toSeconds())
+                   / static_cast<double>((times[jt] - times[kt]).toSeconds());
+    }
+  }
+
+  std::vector<F90traj> keys;
+  for (const util::DateTime & jtime : times) {
+    if (spill_) makeResident(jtime);
+    keys.push_back(trajmap_.at(jtime));
+  }
+
+  const int nkeys = keys.size();
+  fv3jedi_traj_interpolate_f90(interp_, nkeys, keys.data(), weights.data());
+  interpTime_ = time;
+
+  // Read the next stored step while the interpolated ones are used
+  if (spill_) prefetch(forward ? times.back() + interval_ : times.front() - interval_);
+
+  return interp_;
+}
+// -------------------------------------------------------------------------------------------------
+void TrajectoryStore::interpolationDiagnostics(const util::DateTime & time) {
+  // Interpolate the previous step from its neighbours, twice the interval apart
+  const util::DateTime middle = time - interval_;
+  const util::DateTime before = middle - interval_;
+  if (trajmap_.find(middle) == trajmap_.end() || trajmap_.find(before) == trajmap_.end()) return;
+
+  if (spill_) {
+    makeResident(before);
+    makeResident(middle);
+    makeResident(time);
+  }
+
+  const F90traj keys[2] = {trajmap_.at(before), trajmap_.at(time)};
+  const double weights[2] = {0.5, 0.5};
+  F90traj keyInterp = 0;
+  fv3jedi_traj_interpolate_f90(keyInterp, 2, keys, weights);
+  std::vector<double> norms(10);
+  fv3jedi_traj_difference_norms_f90(keyInterp, trajmap_.at(middle), norms.data());
+  fv3jedi_traj_wipe_f90(keyInterp);
+  comm_.allReduceInPlace(norms.begin(), norms.end(), eckit::mpi::sum());
+
+  const std::vector<std::string> names{"u", "v", "t", "delp", "sphum"};
+  oops::Log::info() << "TrajectoryStore: linear interpolation of " << middle
+                    << " from steps " << interval_ << " either side, relative rms error:";
+  for (size_t jf = 0; jf < names.size(); ++jf) {
+    const double error = norms[2*jf+1] > 0.0 ? std::sqrt(norms[2*jf] / norms[2*jf+1]) : 0.0;
+    oops::Log::info() << " " << names[jf] << " " << error;
+  }
+  oops::Log::info() << std::endl;
+}
+// -------------------------------------------------------------------------------------------------
+std::string TrajectoryStore::filename(const util::DateTime & time) const {
+  return prefix_ + "_" + time.toString() + ".bin";
+}
+// -------------------------------------------------------------------------------------------------
+void TrajectoryStore::makeResident(const util::DateTime & time) const {
+  // A prefetched step has only been read into a buffer, the trajectory is filled here
+  auto ipre = prefetches_.find(time);
+  if (ipre != prefetches_.end()) {
+    const std::vector<char> buffer = ipre->second.get();
+    prefetches_.erase(ipre);
+    const size_t nbytes = buffer.size();
+    fv3jedi_traj_load_buffer_f90(trajmap_.at(time), nbytes, buffer.data());
+  }
+
+  auto ires = std::find(resident_.begin(), resident_.end(), time);
+  if (ires != resident_.end()) {
+    resident_.splice(resident_.begin(), resident_, ires);
+    return;
+  }
+
+  // Not prefetched, read it now
+  evict(stepsInMemory_ - 1, time, time);
+  eckit::LocalConfiguration loadConfig;
+  loadConfig.set("filename", filename(time));
+  fv3jedi_traj_load_f90(trajmap_.at(time), loadConfig);
+  resident_.push_front(time);
+}
+// -------------------------------------------------------------------------------------------------
+void TrajectoryStore::prefetch(const util::DateTime & time) const {
+  // Prefetching needs room for the step in use and the one being read
+  if (stepsInMemory_ < 2 || trajmap_.find(time) == trajmap_.end()) return;
+  if (std::find(resident_.begin(), resident_.end(), time) != resident_.end()) return;
+
+  evict(stepsInMemory_ - 1, resident_.front(), time);
+
+  // The worker only reads the file into a buffer. Everything that touches Fortran, the registry
+  // lookup, the allocation and the copy, happens in makeResident on the calling thread.
+  const std::string file = filename(time);
+  prefetches_[time] = std::async(std::launch::async, [file]() {
+    std::ifstream in(file, std::ios::binary | std::ios::ate);
+    if (!in) throw eckit::CantOpenFile(file);
+    std::vector<char> buffer(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    if (!in.read(buffer.data(), buffer.size())) throw eckit::ReadError(file);
+    return buffer;
+  });
+
+  // Second most recently used, after the step in use
+  resident_.insert(std::next(resident_.begin()), time);
+}
+// -------------------------------------------------------------------------------------------------
+void TrajectoryStore::evict(const size_t maxResident, const util::DateTime & keep1,
+                            const util::DateTime & keep2) const {
+  // Least recently used steps go first, their files are already written
+  auto ires = resident_.end();
+  while (resident_.size() > maxResident && ires != resident_.begin()) {
+    --ires;
+    const util::DateTime time = *ires;
+    if (time == keep1 || time == keep2) continue;
+
+    // A step still being prefetched holds no memory in the trajectory, dropping the buffer frees it
+    auto ipre = prefetches_.find(time);
+    if (ipre != prefetches_.end()) {
+      ipre->second.get();
+      prefetches_.erase(ipre);
+      ires = resident_.erase(ires);
+      continue;
+    }
+
+    eckit::LocalConfiguration spillConfig;
+    spillConfig.set("filename", filename(time));
+    spillConfig.set("single precision", singlePrecision_);
+    spillConfig.set("write", false);
+    fv3jedi_traj_spill_f90(trajmap_.at(time), spillConfig);
+
+    ires = resident_.erase(ires);
+  }
+}
+// -------------------------------------------------------------------------------------------------
+void TrajectoryStore::waitPrefetches() const {
+  for (auto & jpre : prefetches_) {
+    const std::vector<char> buffer = jpre.second.get();
+    const size_t nbytes = buffer.size();
+    fv3jedi_traj_load_buffer_f90(trajmap_.at(jpre.first), nbytes, buffer.data());
+  }
+  prefetches_.clear();
+}
+// -------------------------------------------------------------------------------------------------
+void TrajectoryStore::print(std::ostream & os) const {
+  os << "FV3JEDI TLM Trajectory, nstep=" << trajmap_.size() << std::endl;
+  if (trajmap_.size() > 0) {
+    os << "FV3JEDI TLM Trajectory: times are:";
+    for (const auto & jtra : trajmap_) {
+      os << "  " << jtra.first;
+    }
+  }
+  if (spill_) {
+    os << std::endl << "FV3JEDI TLM Trajectory: " << resident_.size() << " steps in memory, "
+       << onDisk_.size() << " steps in " << directory_;
+  }
+}
+// -------------------------------------------------------------------------------------------------
+}  // namespace fv3jedi
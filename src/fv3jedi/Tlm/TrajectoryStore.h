@@ -0,0 +1,108 @@
+/*
+ * (C) Copyright 2024 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#pragma once
+
+#include <future>
+#include <list>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "oops/util/DateTime.h"
+#include "oops/util/Duration.h"
+
+#include "fv3jedi/Utilities/interface.h"
+
+// Forward declarations
+namespace eckit {
+  class Configuration;
+  namespace mpi {
+    class Comm;
+  }
+}
+
+namespace fv3jedi {
+  class Geometry;
+  class State;
+
+// -------------------------------------------------------------------------------------------------
+
+/// Trajectory of the linear model, one fv3jedi_traj per time step.
+///
+/// Without a "trajectory storage" section every step stays in memory. With one, at most
+/// "steps in memory" steps are held in memory and the others are spilled to a file per step and
+/// process in "directory", which should be node-local. Steps are written when they are stored, so
+/// evicting a step only frees it. With "single precision: true" the files take half the space and
+/// every step is rounded to single precision, in memory or not. A step that is not in memory is
+/// read back when the linear model reaches it and the next step in the direction of integration,
+/// backwards for the adjoint, is read asynchronously while the current one is used. Only the file
+/// read runs on another thread; the trajectory is filled from the bytes read on the calling thread
+/// when the step is needed, so no Fortran runs concurrently.
+///
+/// With a "trajectory interpolation" section the trajectory is only set every "interval", a
+/// multiple of the time step, and steps in between are interpolated "linear" or "cubic" in time.
+/// With "diagnostics: true" each new step is used to check how well the step before it would have
+/// been interpolated from its neighbours, which bounds the interpolation error. With storage, the
+/// interpolation stencil and the step being prefetched must fit in memory, so "steps in memory"
+/// is at least three for linear and five for cubic interpolation, which is also the default.
+
+class TrajectoryStore {
+ public:
+  TrajectoryStore(const Geometry &, const eckit::Configuration &, const util::Duration &);
+  ~TrajectoryStore();
+
+  TrajectoryStore(const TrajectoryStore &) = delete;
+  TrajectoryStore & operator=(const TrajectoryStore &) = delete;
+
+  /// Store the trajectory at the valid time of the state
+  void insert(const util::DateTime &, const State &);
+
+  /// Trajectory at a time, read back or interpolated if needed; forward is the prefetch direction
+  F90traj get(const util::DateTime &, const bool forward) const;
+
+  /// Time between trajectories set by the nonlinear model
+  const util::Duration & interval() const {return interval_;}
+
+  void print(std::ostream &) const;
+
+ private:
+  std::string filename(const util::DateTime &) const;
+  F90traj interpolated(const util::DateTime &, const bool) const;
+  void interpolationDiagnostics(const util::DateTime &);
+  void makeResident(const util::DateTime &) const;
+  void prefetch(const util::DateTime &) const;
+  void evict(const size_t, const util::DateTime &, const util::DateTime &) const;
+  void waitPrefetches() const;
+
+  const eckit::mpi::Comm & comm_;
+  util::Duration tstep_;
+  std::map<util::DateTime, F90traj> trajmap_;
+
+  // Interpolation in time
+  util::Duration interval_;
+  bool cubic_;
+  bool diagnostics_;
+  mutable F90traj interp_;
+  mutable util::DateTime interpTime_;
+
+  // Out-of-core storage
+  bool spill_;
+  std::string directory_;
+  std::string prefix_;
+  size_t stepsInMemory_;
+  bool singlePrecision_;
+  mutable std::list<util::DateTime> resident_;  // Most recently used first
+  mutable std::set<util::DateTime> onDisk_;
+  mutable std::map<util::DateTime, std::future<std::vector<char>>> prefetches_;
+};
+
+// -------------------------------------------------------------------------------------------------
+
+}  // namespace fv3jedi
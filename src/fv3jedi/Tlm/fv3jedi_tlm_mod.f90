@@ -30,6 +30,10 @@ implicit none
 private
 public :: fv3jedi_tlm
 
+interface swap
+  module procedure swap_rank2, swap_rank3, swap_rank4
+end interface swap
+
 ! --------------------------------------------------------------------------------------------------
 
 !> Fortran derived type to hold tlm definition
@@ -117,12 +121,12 @@ subroutine initialize_ad(self, inc, traj)
 
 class(fv3jedi_tlm),      intent(inout) :: self
 type(fv3jedi_increment), intent(inout) :: inc
-type(fv3jedi_traj),      intent(in)    :: traj
+type(fv3jedi_traj),      intent(inout) :: traj
 
 ! Make sure the tracers are allocated (true => both traj and pert tracers)
 call self%fv3jedi_lm%allocate_tracers(inc%isc, inc%iec, inc%jsc, inc%jec, &
                                       inc%npz, inc%ntracers, .true.)
-call traj_to_traj(traj, self%fv3jedi_lm)
+call swap_traj(traj, self%fv3jedi_lm)
 
 ! The action of finalize_tl is {inc = LM; LM = 0}, the adjoint of which is {LM* = inc*; inc* = 0}.
 ! To keep the code simple, we first perform the extra step {LM* = 0}, so that we can then re-use
@@ -141,6 +145,8 @@ if (allocated(self%fv3jedi_lm%pert%delz)) self%fv3jedi_lm%pert%delz = 0.0_kind_r
 call lm_to_inc_ad(self%fv3jedi_lm,inc)
 call self%fv3jedi_lm%init_ad()
 
+call swap_traj(traj, self%fv3jedi_lm)
+
 end subroutine initialize_ad
 
 ! --------------------------------------------------------------------------------------------------
@@ -149,17 +155,19 @@ subroutine initialize_tl(self, inc, traj)
 
 class(fv3jedi_tlm),      intent(inout) :: self
 type(fv3jedi_increment), intent(inout) :: inc
-type(fv3jedi_traj),      intent(in)    :: traj
+type(fv3jedi_traj),      intent(inout) :: traj
 
 ! Make sure the tracers are allocated (true => both traj and pert tracers)
 call self%fv3jedi_lm%allocate_tracers(inc%isc, inc%iec, inc%jsc, inc%jec, &
                                       inc%npz, inc%ntracers, .true.)
-call traj_to_traj(traj, self%fv3jedi_lm)
+call swap_traj(traj, self%fv3jedi_lm)
 
 call inc_to_lm(inc,self%fv3jedi_lm)
 call self%fv3jedi_lm%init_tl()
 call lm_to_inc(self%fv3jedi_lm,inc)
 
+call swap_traj(traj, self%fv3jedi_lm)
+
 end subroutine initialize_tl
 
 ! --------------------------------------------------------------------------------------------------
@@ -168,13 +176,15 @@ subroutine step_ad(self, inc, traj)
 
 class(fv3jedi_tlm),      intent(inout) :: self
 type(fv3jedi_increment), intent(inout) :: inc
-type(fv3jedi_traj),      intent(in)    :: traj
+type(fv3jedi_traj),      intent(inout) :: traj
 
-call traj_to_traj(traj, self%fv3jedi_lm)
+call swap_traj(traj, self%fv3jedi_lm)
 
 call lm_to_inc_ad(self%fv3jedi_lm,inc)
 call self%fv3jedi_lm%step_ad()
 
+call swap_traj(traj, self%fv3jedi_lm)
+
 end subroutine step_ad
 
 ! --------------------------------------------------------------------------------------------------
@@ -183,13 +193,15 @@ subroutine step_tl(self, inc, traj)
 
 class(fv3jedi_tlm),      intent(inout) :: self
 type(fv3jedi_increment), intent(inout) :: inc
-type(fv3jedi_traj),      intent(in)    :: traj
+type(fv3jedi_traj),      intent(inout) :: traj
 
-call traj_to_traj(traj, self%fv3jedi_lm)
+call swap_traj(traj, self%fv3jedi_lm)
 
 call self%fv3jedi_lm%step_tl()
 call lm_to_inc(self%fv3jedi_lm,inc)
 
+call swap_traj(traj, self%fv3jedi_lm)
+
 end subroutine step_tl
 
 ! --------------------------------------------------------------------------------------------------
@@ -474,51 +486,100 @@ end subroutine lm_to_inc_ad
 
 ! --------------------------------------------------------------------------------------------------
 
-subroutine traj_to_traj( traj, lm )
+subroutine swap_traj( traj, lm )
+
+! Exchange the arrays of the stored trajectory with those of the linear model. Only the array
+! descriptors move, so lending a trajectory to the linear model for a step costs nothing and a
+! second call hands the arrays back.
 
-type(fv3jedi_traj),    intent(in)    :: traj
+type(fv3jedi_traj),    intent(inout) :: traj
 type(fv3jedi_lm_type), intent(inout) :: lm
 
-lm%traj%u    = traj%u
-lm%traj%v    = traj%v
-lm%traj%ua   = traj%ua
-lm%traj%va   = traj%va
-lm%traj%t    = traj%t
+! Both sides index the compute domain
+if (allocated(traj%u) .and. allocated(lm%traj%u)) then
+  if (any(lbound(traj%u) /= lbound(lm%traj%u)) .or. any(ubound(traj%u) /= ubound(lm%traj%u))) &
+    call abor1_ftn("fv3jedi_tlm_mod.swap_traj: trajectory and linear model bounds differ")
+endif
 
-lm%traj%delp = traj%delp
+call swap(traj%u,    lm%traj%u)
+call swap(traj%v,    lm%traj%v)
+call swap(traj%ua,   lm%traj%ua)
+call swap(traj%va,   lm%traj%va)
+call swap(traj%t,    lm%traj%t)
 
-! Copy the tracers
-lm%traj%tracers = traj%tracers
-lm%traj%tracer_names  = traj%tracer_names
+call swap(traj%delp, lm%traj%delp)
+
+! The tracers, the names are small and copied
+call swap(traj%tracers, lm%traj%tracers)
+lm%traj%tracer_names = traj%tracer_names
 
 if (.not. lm%conf%hydrostatic) then
-  lm%traj%w    = traj%w
-  lm%traj%delz = traj%delz
+  call swap(traj%w,    lm%traj%w)
+  call swap(traj%delz, lm%traj%delz)
 endif
 
 if (lm%conf%do_phy_mst .ne. 0) then
-  lm%traj%qls  = traj%qls
-  lm%traj%qcn  = traj%qcn
-  lm%traj%cfcn = traj%cfcn
+  call swap(traj%qls,  lm%traj%qls)
+  call swap(traj%qcn,  lm%traj%qcn)
+  call swap(traj%cfcn, lm%traj%cfcn)
 endif
 
 !> Rank two
-lm%traj%phis    = traj%phis
-lm%traj%frocean = traj%frocean
-lm%traj%frland  = traj%frland
-lm%traj%varflt  = traj%varflt
-lm%traj%ustar   = traj%ustar
-lm%traj%bstar   = traj%bstar
-lm%traj%zpbl    = traj%zpbl
-lm%traj%cm      = traj%cm
-lm%traj%ct      = traj%ct
-lm%traj%cq      = traj%cq
-lm%traj%kcbl    = traj%kcbl
-lm%traj%ts      = traj%ts
-lm%traj%khl     = traj%khl
-lm%traj%khu     = traj%khu
-
-end subroutine traj_to_traj
+call swap(traj%phis,    lm%traj%phis)
+call swap(traj%frocean, lm%traj%frocean)
+call swap(traj%frland,  lm%traj%frland)
+call swap(traj%varflt,  lm%traj%varflt)
+call swap(traj%ustar,   lm%traj%ustar)
+call swap(traj%bstar,   lm%traj%bstar)
+call swap(traj%zpbl,    lm%traj%zpbl)
+call swap(traj%cm,      lm%traj%cm)
+call swap(traj%ct,      lm%traj%ct)
+call swap(traj%cq,      lm%traj%cq)
+call swap(traj%kcbl,    lm%traj%kcbl)
+call swap(traj%ts,      lm%traj%ts)
+call swap(traj%khl,     lm%traj%khl)
+call swap(traj%khu,     lm%traj%khu)
+
+end subroutine swap_traj
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine swap_rank2(a, b)
+
+real(kind=kind_real), allocatable, intent(inout) :: a(:,:), b(:,:)
+real(kind=kind_real), allocatable :: tmp(:,:)
+
+call move_alloc(a, tmp)
+call move_alloc(b, a)
+call move_alloc(tmp, b)
+
+end subroutine swap_rank2
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine swap_rank3(a, b)
+
+real(kind=kind_real), allocatable, intent(inout) :: a(:,:,:), b(:,:,:)
+real(kind=kind_real), allocatable :: tmp(:,:,:)
+
+call move_alloc(a, tmp)
+call move_alloc(b, a)
+call move_alloc(tmp, b)
+
+end subroutine swap_rank3
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine swap_rank4(a, b)
+
+real(kind=kind_real), allocatable, intent(inout) :: a(:,:,:,:), b(:,:,:,:)
+real(kind=kind_real), allocatable :: tmp(:,:,:,:)
+
+call move_alloc(a, tmp)
+call move_alloc(b, a)
+call move_alloc(tmp, b)
+
+end subroutine swap_rank4
 
 ! --------------------------------------------------------------------------------------------------
 
@@ -5,6 +5,12 @@
 
 module fv3jedi_traj_mod
 
+! iso
+use iso_c_binding,        only: c_char, c_float, c_int64_t
+
+! fckit
+use fckit_configuration_module, only: fckit_configuration
+
 ! fv3-jedi-lm
 use fv3jedi_lm_utils_mod, only: fv3jedi_traj => fv3jedi_lm_traj, deallocate_traj
 
@@ -19,6 +25,11 @@ private
 public :: fv3jedi_traj
 public :: set
 public :: wipe
+public :: spill
+public :: load
+public :: load_buffer
+public :: linear_combination
+public :: difference_norms
 
 ! --------------------------------------------------------------------------------------------------
 
@@ -261,10 +272,346 @@ subroutine wipe(self)
 implicit none
 type(fv3jedi_traj), pointer :: self
 
-call deallocate_traj(self)
+! A trajectory that has been spilled to disk holds no memory
+if (allocated(self%u)) call deallocate_traj(self)
 
 end subroutine wipe
 
 ! --------------------------------------------------------------------------------------------------
 
+subroutine spill(self, conf)
+
+! Write the trajectory to "filename" and free its memory. With "single precision" the fields are
+! written as 32 bit reals, halving the file and the time taken to read it back, and the copy in
+! memory is rounded the same way so the trajectory does not depend on whether it was reloaded.
+! "write: false" only frees a trajectory whose file is current, "release: false" only writes.
+
+implicit none
+type(fv3jedi_traj),        intent(inout) :: self
+type(fckit_configuration), intent(in)    :: conf
+
+integer :: unit, ios, nt
+logical :: single, write_file, release
+character(len=:), allocatable :: filename
+
+call conf%get_or_die("filename", filename)
+call conf%get_or_die("single precision", single)
+write_file = .true.
+if (conf%has("write")) call conf%get_or_die("write", write_file)
+release = .true.
+if (conf%has("release")) call conf%get_or_die("release", release)
+
+if (.not. allocated(self%u)) &
+  call abor1_ftn("fv3jedi_traj_mod.spill: trajectory is not in memory")
+
+if (write_file) then
+
+  open(newunit=unit, file=filename, access='stream', form='unformatted', status='replace', &
+       action='write', iostat=ios)
+  if (ios /= 0) call abor1_ftn("fv3jedi_traj_mod.spill: cannot open "//filename)
+
+  nt = size(self%tracers, 4)
+  write(unit) single, lbound(self%u, 1), ubound(self%u, 1), lbound(self%u, 2), ubound(self%u, 2), &
+              size(self%u, 3), self%ntracers, nt
+  write(unit) self%tracer_names
+
+  call write_field(unit, single, size(self%u),       self%u)
+  call write_field(unit, single, size(self%v),       self%v)
+  call write_field(unit, single, size(self%ua),      self%ua)
+  call write_field(unit, single, size(self%va),      self%va)
+  call write_field(unit, single, size(self%t),       self%t)
+  call write_field(unit, single, size(self%delp),    self%delp)
+  call write_field(unit, single, size(self%w),       self%w)
+  call write_field(unit, single, size(self%delz),    self%delz)
+  call write_field(unit, single, size(self%qls),     self%qls)
+  call write_field(unit, single, size(self%qcn),     self%qcn)
+  call write_field(unit, single, size(self%cfcn),    self%cfcn)
+  call write_field(unit, single, size(self%tracers), self%tracers)
+  call write_field(unit, single, size(self%phis),    self%phis)
+  call write_field(unit, single, size(self%frocean), self%frocean)
+  call write_field(unit, single, size(self%frland),  self%frland)
+  call write_field(unit, single, size(self%varflt),  self%varflt)
+  call write_field(unit, single, size(self%ustar),   self%ustar)
+  call write_field(unit, single, size(self%bstar),   self%bstar)
+  call write_field(unit, single, size(self%zpbl),    self%zpbl)
+  call write_field(unit, single, size(self%cm),      self%cm)
+  call write_field(unit, single, size(self%ct),      self%ct)
+  call write_field(unit, single, size(self%cq),      self%cq)
+  call write_field(unit, single, size(self%kcbl),    self%kcbl)
+  call write_field(unit, single, size(self%ts),      self%ts)
+  call write_field(unit, single, size(self%khl),     self%khl)
+  call write_field(unit, single, size(self%khu),     self%khu)
+
+  close(unit, iostat=ios)
+  if (ios /= 0) call abor1_ftn("fv3jedi_traj_mod.spill: failed writing "//filename)
+
+endif
+
+if (release) then
+  call deallocate_traj(self)
+  if (allocated(self%tracers)) deallocate(self%tracers)
+  if (allocated(self%tracer_names)) deallocate(self%tracer_names)
+endif
+
+end subroutine spill
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine load(self, conf)
+
+! Read back a trajectory written by spill from "filename"
+
+implicit none
+type(fv3jedi_traj),        intent(inout) :: self
+type(fckit_configuration), intent(in)    :: conf
+
+integer :: unit, ios
+integer(kind=c_int64_t) :: nbytes
+character(kind=c_char), allocatable :: buffer(:)
+character(len=:), allocatable :: filename
+
+call conf%get_or_die("filename", filename)
+
+if (allocated(self%u)) return
+
+open(newunit=unit, file=filename, access='stream', form='unformatted', status='old', &
+     action='read', iostat=ios)
+if (ios /= 0) call abor1_ftn("fv3jedi_traj_mod.load: cannot open "//filename)
+
+inquire(unit=unit, size=nbytes)
+allocate(buffer(nbytes))
+read(unit, iostat=ios) buffer
+if (ios /= 0) call abor1_ftn("fv3jedi_traj_mod.load: failed reading "//filename)
+close(unit)
+
+call load_buffer(self, buffer)
+
+end subroutine load
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine load_buffer(self, buffer)
+
+! Fill the trajectory from the bytes of a file written by spill
+
+implicit none
+type(fv3jedi_traj),     intent(inout) :: self
+character(kind=c_char), intent(in)    :: buffer(:)
+
+integer :: header(7), isc, iec, jsc, jec, npz, nt
+integer(kind=c_int64_t) :: pos, nbytes
+logical :: single
+
+if (allocated(self%u)) return
+
+pos = 1
+nbytes = storage_size(single)/8
+call check_buffer(buffer, pos, nbytes)
+single = transfer(buffer(pos:pos+nbytes-1), single)
+pos = pos + nbytes
+
+nbytes = size(header)*storage_size(header)/8
+call check_buffer(buffer, pos, nbytes)
+header = transfer(buffer(pos:pos+nbytes-1), header)
+pos = pos + nbytes
+isc = header(1)
+iec = header(2)
+jsc = header(3)
+jec = header(4)
+npz = header(5)
+self%ntracers = header(6)
+nt = header(7)
+
+allocate(self%tracer_names(nt))
+nbytes = nt*storage_size(self%tracer_names)/8
+call check_buffer(buffer, pos, nbytes)
+if (nt > 0) self%tracer_names = transfer(buffer(pos:pos+nbytes-1), self%tracer_names, nt)
+pos = pos + nbytes
+
+allocate(self%u      (isc:iec, jsc:jec, npz))
+allocate(self%v      (isc:iec, jsc:jec, npz))
+allocate(self%ua     (isc:iec, jsc:jec, npz))
+allocate(self%va     (isc:iec, jsc:jec, npz))
+allocate(self%t      (isc:iec, jsc:jec, npz))
+allocate(self%delp   (isc:iec, jsc:jec, npz))
+allocate(self%w      (isc:iec, jsc:jec, npz))
+allocate(self%delz   (isc:iec, jsc:jec, npz))
+allocate(self%qls    (isc:iec, jsc:jec, npz))
+allocate(self%qcn    (isc:iec, jsc:jec, npz))
+allocate(self%cfcn   (isc:iec, jsc:jec, npz))
+allocate(self%tracers(isc:iec, jsc:jec, npz, nt))
+allocate(self%phis   (isc:iec, jsc:jec))
+allocate(self%frocean(isc:iec, jsc:jec))
+allocate(self%frland (isc:iec, jsc:jec))
+allocate(self%varflt (isc:iec, jsc:jec))
+allocate(self%ustar  (isc:iec, jsc:jec))
+allocate(self%bstar  (isc:iec, jsc:jec))
+allocate(self%zpbl   (isc:iec, jsc:jec))
+allocate(self%cm     (isc:iec, jsc:jec))
+allocate(self%ct     (isc:iec, jsc:jec))
+allocate(self%cq     (isc:iec, jsc:jec))
+allocate(self%kcbl   (isc:iec, jsc:jec))
+allocate(self%ts     (isc:iec, jsc:jec))
+allocate(self%khl    (isc:iec, jsc:jec))
+allocate(self%khu    (isc:iec, jsc:jec))
+
+call unpack_field(buffer, pos, single, size(self%u),       self%u)
+call unpack_field(buffer, pos, single, size(self%v),       self%v)
+call unpack_field(buffer, pos, single, size(self%ua),      self%ua)
+call unpack_field(buffer, pos, single, size(self%va),      self%va)
+call unpack_field(buffer, pos, single, size(self%t),       self%t)
+call unpack_field(buffer, pos, single, size(self%delp),    self%delp)
+call unpack_field(buffer, pos, single, size(self%w),       self%w)
+call unpack_field(buffer, pos, single, size(self%delz),    self%delz)
+call unpack_field(buffer, pos, single, size(self%qls),     self%qls)
+call unpack_field(buffer, pos, single, size(self%qcn),     self%qcn)
+call unpack_field(buffer, pos, single, size(self%cfcn),    self%cfcn)
+call unpack_field(buffer, pos, single, size(self%tracers), self%tracers)
+call unpack_field(buffer, pos, single, size(self%phis),    self%phis)
+call unpack_field(buffer, pos, single, size(self%frocean), self%frocean)
+call unpack_field(buffer, pos, single, size(self%frland),  self%frland)
+call unpack_field(buffer, pos, single, size(self%varflt),  self%varflt)
+call unpack_field(buffer, pos, single, size(self%ustar),   self%ustar)
+call unpack_field(buffer, pos, single, size(self%bstar),   self%bstar)
+call unpack_field(buffer, pos, single, size(self%zpbl),    self%zpbl)
+call unpack_field(buffer, pos, single, size(self%cm),      self%cm)
+call unpack_field(buffer, pos, single, size(self%ct),      self%ct)
+call unpack_field(buffer, pos, single, size(self%cq),      self%cq)
+call unpack_field(buffer, pos, single, size(self%kcbl),    self%kcbl)
+call unpack_field(buffer, pos, single, size(self%ts),      self%ts)
+call unpack_field(buffer, pos, single, size(self%khl),     self%khl)
+call unpack_field(buffer, pos, single, size(self%khu),     self%khu)
+
+if (pos /= size(buffer, kind=c_int64_t) + 1) &
+  call abor1_ftn("fv3jedi_traj_mod.load_buffer: trajectory file has unexpected size")
+
+end subroutine load_buffer
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine write_field(unit, single, n, field)
+
+implicit none
+integer,              intent(in)    :: unit
+logical,              intent(in)    :: single
+integer,              intent(in)    :: n
+real(kind=kind_real), intent(inout) :: field(n)
+
+if (single) then
+  field = real(real(field, c_float), kind_real)
+  write(unit) real(field, c_float)
+else
+  write(unit) field
+endif
+
+end subroutine write_field
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine unpack_field(buffer, pos, single, n, field)
+
+implicit none
+character(kind=c_char),  intent(in)    :: buffer(:)
+integer(kind=c_int64_t), intent(inout) :: pos
+logical,                 intent(in)    :: single
+integer,                 intent(in)    :: n
+real(kind=kind_real),    intent(out)   :: field(n)
+
+integer(kind=c_int64_t) :: nbytes
+
+if (single) then
+  nbytes = int(n, c_int64_t)*storage_size(0.0_c_float)/8
+  call check_buffer(buffer, pos, nbytes)
+  field = real(transfer(buffer(pos:pos+nbytes-1), 0.0_c_float, n), kind_real)
+else
+  nbytes = int(n, c_int64_t)*storage_size(field)/8
+  call check_buffer(buffer, pos, nbytes)
+  field = transfer(buffer(pos:pos+nbytes-1), 0.0_kind_real, n)
+endif
+pos = pos + nbytes
+
+end subroutine unpack_field
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine check_buffer(buffer, pos, nbytes)
+
+implicit none
+character(kind=c_char),  intent(in) :: buffer(:)
+integer(kind=c_int64_t), intent(in) :: pos
+integer(kind=c_int64_t), intent(in) :: nbytes
+
+if (pos + nbytes - 1 > size(buffer, kind=c_int64_t)) &
+  call abor1_ftn("fv3jedi_traj_mod.load_buffer: trajectory file is truncated")
+
+end subroutine check_buffer
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine linear_combination(self, b, a, other)
+
+! self = b*self + a*other, used to interpolate trajectories in time
+
+implicit none
+type(fv3jedi_traj),   intent(inout) :: self
+real(kind=kind_real), intent(in)    :: b
+real(kind=kind_real), intent(in)    :: a
+type(fv3jedi_traj),   intent(in)    :: other
+
+self%u       = b*self%u       + a*other%u
+self%v       = b*self%v       + a*other%v
+self%ua      = b*self%ua      + a*other%ua
+self%va      = b*self%va      + a*other%va
+self%t       = b*self%t       + a*other%t
+self%delp    = b*self%delp    + a*other%delp
+self%w       = b*self%w       + a*other%w
+self%delz    = b*self%delz    + a*other%delz
+self%qls     = b*self%qls     + a*other%qls
+self%qcn     = b*self%qcn     + a*other%qcn
+self%cfcn    = b*self%cfcn    + a*other%cfcn
+self%tracers = b*self%tracers + a*other%tracers
+self%phis    = b*self%phis    + a*other%phis
+self%frocean = b*self%frocean + a*other%frocean
+self%frland  = b*self%frland  + a*other%frland
+self%varflt  = b*self%varflt  + a*other%varflt
+self%ustar   = b*self%ustar   + a*other%ustar
+self%bstar   = b*self%bstar   + a*other%bstar
+self%zpbl    = b*self%zpbl    + a*other%zpbl
+self%cm      = b*self%cm      + a*other%cm
+self%ct      = b*self%ct      + a*other%ct
+self%cq      = b*self%cq      + a*other%cq
+self%kcbl    = b*self%kcbl    + a*other%kcbl
+self%ts      = b*self%ts      + a*other%ts
+self%khl     = b*self%khl     + a*other%khl
+self%khu     = b*self%khu     + a*other%khu
+
+end subroutine linear_combination
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine difference_norms(self, other, norms)
+
+! Local sums of the squared difference and of the squared reference (other) for u, v, t, delp and
+! specific humidity, the first tracer. The caller reduces them over the tasks.
+
+implicit none
+type(fv3jedi_traj),   intent(in)  :: self
+type(fv3jedi_traj),   intent(in)  :: other
+real(kind=kind_real), intent(out) :: norms(10)
+
+norms(1)  = sum((self%u - other%u)**2)
+norms(2)  = sum(other%u**2)
+norms(3)  = sum((self%v - other%v)**2)
+norms(4)  = sum(other%v**2)
+norms(5)  = sum((self%t - other%t)**2)
+norms(6)  = sum(other%t**2)
+norms(7)  = sum((self%delp - other%delp)**2)
+norms(8)  = sum(other%delp**2)
+norms(9)  = sum((self%tracers(:,:,:,1) - other%tracers(:,:,:,1))**2)
+norms(10) = sum(other%tracers(:,:,:,1)**2)
+
+end subroutine difference_norms
+
+! --------------------------------------------------------------------------------------------------
+
 end module fv3jedi_traj_mod
@@ -0,0 +1,144 @@
+! (C) Copyright 2024 UCAR
+!
+! This software is licensed under the terms of the Apache Licence Version 2.0
+! which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+
+module fv3jedi_trajectory_field_mod
+
+! Trajectory fields of the linear variable changes. A field is held in double precision or, when
+! "trajectory precision: single" is configured, in single precision to halve the memory of the
+! trajectory. Kernels always see double precision: get points at the stored field or, for single
+! precision, widens it into a work array that release frees again.
+
+use iso_c_binding,              only: c_float
+use fckit_configuration_module, only: fckit_configuration
+
+use fv3jedi_geom_mod,  only: fv3jedi_geom
+use fv3jedi_kinds_mod, only: kind_real
+
+implicit none
+private
+public fv3jedi_trajectory_field
+public trajectory_single_precision
+
+type :: fv3jedi_trajectory_field
+  real(kind=kind_real), pointer :: dp(:,:,:) => null()
+  real(kind=c_float), allocatable :: sp(:,:,:)
+  contains
+    procedure, public :: set
+    procedure, public :: has
+    procedure, public :: get
+    procedure, public :: release
+    procedure, public :: delete
+end type fv3jedi_trajectory_field
+
+! --------------------------------------------------------------------------------------------------
+
+contains
+
+! --------------------------------------------------------------------------------------------------
+
+function trajectory_single_precision(conf) result(single)
+
+type(fckit_configuration), intent(in) :: conf
+logical :: single
+
+character(len=:), allocatable :: str
+
+single = .false.
+if (conf%has("trajectory precision")) then
+  call conf%get_or_die("trajectory precision", str)
+  select case (str)
+  case ("single")
+    single = .true.
+  case ("double")
+    single = .false.
+  case default
+    call abor1_ftn("trajectory_single_precision: trajectory precision must be single or double")
+  end select
+endif
+
+end function trajectory_single_precision
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine set(self, geom, field, single)
+
+class(fv3jedi_trajectory_field), intent(inout) :: self
+type(fv3jedi_geom),              intent(in)    :: geom
+real(kind=kind_real),            intent(in)    :: field(:,:,:)
+logical,                         intent(in)    :: single
+
+call self%delete()
+
+if (single) then
+  allocate(self%sp(geom%isc:geom%iec,geom%jsc:geom%jec,size(field,3)))
+  self%sp = real(field, c_float)
+else
+  allocate(self%dp(geom%isc:geom%iec,geom%jsc:geom%jec,size(field,3)))
+  self%dp = field
+endif
+
+end subroutine set
+
+! --------------------------------------------------------------------------------------------------
+
+logical function has(self)
+
+class(fv3jedi_trajectory_field), intent(in) :: self
+
+has = associated(self%dp) .or. allocated(self%sp)
+
+end function has
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine get(self, field)
+
+class(fv3jedi_trajectory_field), intent(in)  :: self
+real(kind=kind_real), pointer,   intent(out) :: field(:,:,:)
+
+if (associated(self%dp)) then
+  field => self%dp
+elseif (allocated(self%sp)) then
+  allocate(field(lbound(self%sp,1):ubound(self%sp,1), lbound(self%sp,2):ubound(self%sp,2), &
+                 lbound(self%sp,3):ubound(self%sp,3)))
+  field = real(self%sp, kind_real)
+else
+  call abor1_ftn("fv3jedi_trajectory_field_mod.get: trajectory field has not been set")
+endif
+
+end subroutine get
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine release(self, field)
+
+class(fv3jedi_trajectory_field), intent(in)    :: self
+real(kind=kind_real), pointer,   intent(inout) :: field(:,:,:)
+
+if (.not. associated(field)) return
+
+! Work arrays exist only for fields held in single precision
+if (allocated(self%sp)) then
+  deallocate(field)
+else
+  nullify(field)
+endif
+
+end subroutine release
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine delete(self)
+
+class(fv3jedi_trajectory_field), intent(inout) :: self
+
+if (associated(self%dp)) deallocate(self%dp)
+if (allocated(self%sp)) deallocate(self%sp)
+
+end subroutine delete
+
+! --------------------------------------------------------------------------------------------------
+
+end module fv3jedi_trajectory_field_mod
@@ -44,12 +44,29 @@ public :: changevarinverse
 
 type :: fv3jedi_varcha_c2a
   logical :: skip_femps_init
-  type(fempsgrid) :: grid
-  type(fempsoprs) :: oprs
+  logical :: native_poisson
+  integer :: poisson_iterations
+  real(kind=kind_real) :: poisson_tolerance
+  type(fempsgrid), pointer :: grid => null()
+  type(fempsoprs), pointer :: oprs => null()
+  logical :: owns_femps = .false.
   integer :: lprocs
   integer, allocatable :: lev_start(:), lev_final(:)
 end type fv3jedi_varcha_c2a
 
+! The femps grid hierarchy and operators are expensive to build and read only once built. They are
+! kept for the life of the process and shared by every instance set up from the same grid files,
+! resolution, multigrid configuration and level processors.
+type :: femps_context
+  character(len=2055) :: path2fv3gridfiles
+  integer :: cube, ngrids, niter, lprocs, comm
+  logical :: check_convergence
+  type(fempsgrid), pointer :: grid => null()
+  type(fempsoprs), pointer :: oprs => null()
+end type femps_context
+
+type(femps_context), allocatable, save :: femps_cache(:)
+
 ! ------------------------------------------------------------------------------
 
 contains
@@ -68,13 +85,34 @@ character(len=:), allocatable :: str
 character(len=2055) :: path2fv3gridfiles
 
 integer :: n, levs_per_proc
-logical :: tmp
+logical :: tmp, check_convergence
+
+! Poisson solver, femps on gathered levels or conjugate gradient on the native decomposition
+! -----------------------------------------------------------------------------------------
+self%native_poisson = .false.
+if (conf%has("poisson solver")) then
+  call conf%get_or_die("poisson solver",str)
+  if (str == "native") then
+    self%native_poisson = .true.
+  elseif (str /= "femps") then
+    call abor1_ftn("fv3jedi_varcha_c2a_mod.create: poisson solver must be femps or native")
+  endif
+endif
+
+if (self%native_poisson) then
+  if (.not. conf%get("poisson solver iterations",self%poisson_iterations)) &
+    self%poisson_iterations = 1000
+  if (.not. conf%get("poisson solver tolerance",self%poisson_tolerance)) &
+    self%poisson_tolerance = 1.0e-10_kind_real
+endif
 
 ! Grid and operators for the femps Poisson solver
 ! -----------------------------------------------
-self%skip_femps_init = .false.
+check_convergence = .false.
+self%skip_femps_init = self%native_poisson
 if (conf%has("skip femps initialization")) then
-   call conf%get_or_die("skip femps initialization",self%skip_femps_init)
+   call conf%get_or_die("skip femps initialization",tmp)
+   self%skip_femps_init = self%skip_femps_init .or. tmp
 end if
 
 if (.not. self%skip_femps_init) then
@@ -86,8 +124,8 @@ if (.not. self%skip_femps_init) then
   if( .not. conf%get('femps_levelprocs',lprocs) ) then
     lprocs = -1
   endif
-  if( .not. conf%get('femps_checkconvergence',self%grid%check_convergence) ) then
-    self%grid%check_convergence = .false.
+  if( .not. conf%get('femps_checkconvergence',check_convergence) ) then
+    check_convergence = .false.
   endif
 
   ! Processors that will do the work
@@ -128,31 +166,21 @@ if (.not. self%skip_femps_init) then
   ! Processors doing the work need grid and operators
   if (geom%f_comm%rank() < self%lprocs ) then
 
-    if (geom%f_comm%rank() == 0 ) print*, 'Creating FEMPS grid object'
-    call self%grid%setup('cs',ngrids=ngrids,cube=geom%npx-1,niter=niter,&
-                         comm = geom%f_comm%communicator(), &
-                         rank = geom%f_comm%rank(), &
-                         csize = geom%f_comm%size() )
-
-    if (geom%f_comm%rank() == 0 ) print*, 'Creating FEMPS grid hierarchy from files'
-    call fv3grid_to_ugrid(self%grid,path2fv3gridfiles)
-
-    ! Build the connectivity and extra geom
-    if (geom%f_comm%rank() == 0 ) print*, 'Creating FEMPS cubed-sphere connectivity'
-    call self%grid%build_cs(1,1)
-
-    ! Perform all the setup
-    if (geom%f_comm%rank() == 0 ) print*, 'Creating FEMPS static operators'
-    call preliminary(self%grid,self%oprs)
-
-    ! Partial delete of operators not needed
-    if (geom%f_comm%rank() == 0 ) print*, 'FEMPS partial deallocate'
-    call self%oprs%pdelete()
+    call femps_context_get(geom, path2fv3gridfiles, ngrids, niter, check_convergence, &
+                           self%lprocs, self%grid, self%oprs)
 
   endif
 
 endif
 
+! Processors without a level still need the convergence setting of the grid
+if (.not. associated(self%grid)) then
+  allocate(self%grid)
+  allocate(self%oprs)
+  self%grid%check_convergence = check_convergence
+  self%owns_femps = .true.
+endif
+
 end subroutine create
 
 ! ------------------------------------------------------------------------------
@@ -162,10 +190,14 @@ subroutine delete(self)
 implicit none
 type(fv3jedi_varcha_c2a), intent(inout) :: self
 
-if (.not. self%skip_femps_init) then
-  call self%oprs%delete()
-  call self%grid%delete()
+! Grid and operators with levels belong to the process wide cache
+if (self%owns_femps) then
+  deallocate(self%grid)
+  deallocate(self%oprs)
+  self%owns_femps = .false.
 endif
+nullify(self%grid)
+nullify(self%oprs)
 
 if (allocated(self%lev_start)) deallocate(self%lev_start)
 if (allocated(self%lev_final)) deallocate(self%lev_final)
@@ -174,6 +206,89 @@ end subroutine delete
 
 ! ------------------------------------------------------------------------------
 
+subroutine femps_context_get(geom, path2fv3gridfiles, ngrids, niter, check_convergence, lprocs, &
+                             grid, oprs)
+
+implicit none
+type(fv3jedi_geom),       intent(in) :: geom
+character(len=*),         intent(in) :: path2fv3gridfiles
+integer,                  intent(in) :: ngrids
+integer,                  intent(in) :: niter
+logical,                  intent(in) :: check_convergence
+integer,                  intent(in) :: lprocs
+type(fempsgrid), pointer, intent(inout) :: grid
+type(fempsoprs), pointer, intent(inout) :: oprs
+
+integer :: n, ncache
+type(femps_context), allocatable :: tmp(:)
+
+! Reuse a grid and operators built earlier with the same settings
+! ---------------------------------------------------------------
+ncache = 0
+if (allocated(femps_cache)) ncache = size(femps_cache)
+
+do n = 1, ncache
+  if (femps_cache(n)%path2fv3gridfiles == path2fv3gridfiles .and. &
+      femps_cache(n)%cube == geom%npx-1 .and. &
+      femps_cache(n)%ngrids == ngrids .and. &
+      femps_cache(n)%niter == niter .and. &
+      femps_cache(n)%lprocs == lprocs .and. &
+      femps_cache(n)%comm == geom%f_comm%communicator() .and. &
+      (femps_cache(n)%check_convergence .eqv. check_convergence)) then
+    if (geom%f_comm%rank() == 0 ) print*, 'Reusing FEMPS grid and operators'
+    grid => femps_cache(n)%grid
+    oprs => femps_cache(n)%oprs
+    return
+  endif
+enddo
+
+! Build a new grid and operators
+! ------------------------------
+allocate(grid)
+allocate(oprs)
+
+grid%check_convergence = check_convergence
+
+if (geom%f_comm%rank() == 0 ) print*, 'Creating FEMPS grid object'
+call grid%setup('cs',ngrids=ngrids,cube=geom%npx-1,niter=niter,&
+                comm = geom%f_comm%communicator(), &
+                rank = geom%f_comm%rank(), &
+                csize = geom%f_comm%size() )
+
+if (geom%f_comm%rank() == 0 ) print*, 'Creating FEMPS grid hierarchy from files'
+call fv3grid_to_ugrid(grid,path2fv3gridfiles)
+
+! Build the connectivity and extra geom
+if (geom%f_comm%rank() == 0 ) print*, 'Creating FEMPS cubed-sphere connectivity'
+call grid%build_cs(1,1)
+
+! Perform all the setup
+if (geom%f_comm%rank() == 0 ) print*, 'Creating FEMPS static operators'
+call preliminary(grid,oprs)
+
+! Partial delete of operators not needed
+if (geom%f_comm%rank() == 0 ) print*, 'FEMPS partial deallocate'
+call oprs%pdelete()
+
+! Add to the cache
+! ----------------
+allocate(tmp(ncache+1))
+if (ncache > 0) tmp(1:ncache) = femps_cache
+tmp(ncache+1)%path2fv3gridfiles = path2fv3gridfiles
+tmp(ncache+1)%cube = geom%npx-1
+tmp(ncache+1)%ngrids = ngrids
+tmp(ncache+1)%niter = niter
+tmp(ncache+1)%lprocs = lprocs
+tmp(ncache+1)%comm = geom%f_comm%communicator()
+tmp(ncache+1)%check_convergence = check_convergence
+tmp(ncache+1)%grid => grid
+tmp(ncache+1)%oprs => oprs
+call move_alloc(tmp, femps_cache)
+
+end subroutine femps_context_get
+
+! ------------------------------------------------------------------------------
+
 subroutine changevar(self,geom,xctl,xana)
 
 implicit none
@@ -228,7 +343,12 @@ if (xctl%has_field('psi') .and. xctl%has_field('chi')) then
   allocate(vd(geom%isc:geom%iec+1,geom%jsc:geom%jec  ,1:geom%npz))
   call psichi_to_udvd(geom, psi, chi, ud, vd)
   have_udvd = .true.
-  if (.not. self%skip_femps_init) then
+  if (self%native_poisson) then
+    allocate(vort(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz))
+    allocate(divg(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz))
+    call psichi_to_vortdivg_native(geom, psi, chi, vort, divg)
+    have_vodi = .true.
+  elseif (.not. self%skip_femps_init) then
     allocate(vort(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz))
     allocate(divg(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz))
     call psichi_to_vortdivg(geom, self%grid, self%oprs, psi, chi, vort, divg, self%lprocs, self%lev_start, &
@@ -404,8 +524,13 @@ if (have_udvd) then
   allocate(vort(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz))
   allocate(divg(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz))
   call udvd_to_vortdivg(geom, ud, vd, vort, divg)
-  call vortdivg_to_psichi(geom, self%grid, self%oprs, vort, divg, psi, chi, &
-                          self%lprocs, self%lev_start, self%lev_final)
+  if (self%native_poisson) then
+    call vortdivg_to_psichi_native(geom, vort, divg, psi, chi, self%poisson_iterations, &
+                                   self%poisson_tolerance)
+  else
+    call vortdivg_to_psichi(geom, self%grid, self%oprs, vort, divg, psi, chi, &
+                            self%lprocs, self%lev_start, self%lev_final)
+  endif
   have_pcvd = .true.
 endif
 
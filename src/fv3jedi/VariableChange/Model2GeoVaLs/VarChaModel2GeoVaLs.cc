@@ -42,9 +42,22 @@ VarChaModel2GeoVaLs::~VarChaModel2GeoVaLs() {
 void VarChaModel2GeoVaLs::changeVar(const State & xin, State & xout) const {
   util::Timer timer(classname(), "changeVar");
   oops::Log::trace() << classname() << " changeVar start" << std::endl;
+  // Repeated requests for the same variables from an unmodified state reuse the previous output
+  if (cachedOutput_ && xin.version() == cachedInputVersion_ &&
+      xin.variablesIncludingInterfaceFields() == cachedInputVars_ &&
+      xin.validTime() == cachedOutput_->validTime() &&
+      xout.variables() == cachedOutput_->variables()) {
+    xout = *cachedOutput_;
+    oops::Log::trace() << classname() << " changeVar done (cached)" << std::endl;
+    return;
+  }
   fv3jedi_vc_model2geovals_changevar_f90(keyFtnConfig_, geom_.toFortran(), xin.toFortran(),
                                          xout.toFortran());
   xout.validTime() = xin.validTime();
+  ++computations_;
+  cachedOutput_.reset(new State(xout));
+  cachedInputVersion_ = xin.version();
+  cachedInputVars_ = xin.variablesIncludingInterfaceFields();
   oops::Log::trace() << classname() << " changeVar done" << std::endl;
 }
 // -------------------------------------------------------------------------------------------------
@@ -13,6 +13,7 @@
 
 #include "eckit/config/Configuration.h"
 #include "fv3jedi/Geometry/Geometry.h"
+#include "fv3jedi/State/State.h"
 #include "fv3jedi/Utilities/Traits.h"
 #include "fv3jedi/VariableChange/Base/VariableChangeBase.h"
 #include "VarChaModel2GeoVaLs.interface.h"
@@ -29,10 +30,17 @@ class VarChaModel2GeoVaLs: public VariableChangeBase,
   ~VarChaModel2GeoVaLs();
   void changeVar(const State &, State &) const override;
   void changeVarInverse(const State &, State &) const override;
+  // Number of changeVar calls that computed the output rather than reusing it
+  size_t computations() const {return computations_;}
 
  private:
   F90vc_M2G keyFtnConfig_;
   const Geometry & geom_;
+  // Output of the last computation, reused while the input state keeps its version
+  mutable std::unique_ptr<State> cachedOutput_;
+  mutable size_t cachedInputVersion_ = 0;
+  mutable oops::Variables cachedInputVars_;
+  mutable size_t computations_ = 0;
   void print(std::ostream &) const override;
 };
 
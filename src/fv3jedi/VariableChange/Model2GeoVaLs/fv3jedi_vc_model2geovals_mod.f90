@@ -32,15 +32,56 @@ implicit none
 private
 public :: fv3jedi_vc_model2geovals
 
+! Nodes of the derivation graph. Each node computes a family of derived quantities from the model
+! fields and from the nodes it depends on, so nodes are numbered in an order in which they can run.
+integer, parameter :: node_none         = 0
+integer, parameter :: node_pressures    = 1
+integer, parameter :: node_t            = 2
+integer, parameter :: node_q            = 3
+integer, parameter :: node_qsat         = 4
+integer, parameter :: node_rh           = 5
+integer, parameter :: node_geoph        = 6
+integer, parameter :: node_delz         = 7
+integer, parameter :: node_tv           = 8
+integer, parameter :: node_o3           = 9
+integer, parameter :: node_winds        = 10
+integer, parameter :: node_slmsk        = 11
+integer, parameter :: node_zorl         = 12
+integer, parameter :: node_f10m         = 13
+integer, parameter :: node_domain_mask  = 14
+integer, parameter :: node_qmr          = 15
+integer, parameter :: node_co2          = 16
+integer, parameter :: node_hydrometeors = 17
+integer, parameter :: node_crtm_cld     = 18
+integer, parameter :: node_soil         = 19
+integer, parameter :: node_tskin        = 20
+integer, parameter :: node_crtm_sfc     = 21
+integer, parameter :: node_snwdph       = 22
+integer, parameter :: node_vort         = 23
+integer, parameter :: node_tropprs      = 24
+integer, parameter :: n_nodes           = 24
+
+! Time-invariant inputs kept from the last state that had them, so that states of later time slots
+! that do not carry them can still be used
+type :: time_invariant_field
+  character(len=field_clen) :: name
+  real(kind=kind_real), allocatable :: array(:,:,:)
+end type time_invariant_field
+
 type :: fv3jedi_vc_model2geovals
   integer :: isc, iec, jsc, jec, npz
   character(len=10) :: tropprs_method
   character(len=16) :: radii_method
   character(len=8) :: use_mask
+  logical :: depends(n_nodes, n_nodes)  ! depends(n, m): node n consumes the output of node m
+  type(time_invariant_field) :: time_invariant(4)
   contains
     procedure, public :: create
     procedure, public :: delete
     procedure, public :: changevar
+    procedure, private :: plan
+    procedure, private :: has_time_invariant
+    procedure, private :: get_time_invariant
 end type fv3jedi_vc_model2geovals
 
 ! --------------------------------------------------------------------------------------------------
@@ -76,6 +117,30 @@ self%jsc = geom%jsc
 self%jec = geom%jec
 self%npz = geom%npz
 
+! Derivation graph
+self%depends = .false.
+self%depends(node_qsat,     [node_t, node_pressures, node_q]) = .true.
+self%depends(node_rh,       [node_qsat, node_q]) = .true.
+self%depends(node_geoph,    [node_t, node_pressures, node_q]) = .true.
+self%depends(node_delz,     [node_geoph]) = .true.
+self%depends(node_tv,       [node_t, node_q]) = .true.
+self%depends(node_f10m,     [node_winds]) = .true.
+self%depends(node_qmr,      [node_q]) = .true.
+self%depends(node_crtm_cld, [node_slmsk, node_t, node_pressures, node_q, node_hydrometeors]) = .true.
+self%depends(node_crtm_sfc, [node_slmsk, node_f10m, node_soil, node_tskin]) = .true.
+self%depends(node_vort,     [node_winds]) = .true.
+if (trim(self%tropprs_method) == "gsi") then
+  self%depends(node_tropprs, [node_vort, node_tv, node_pressures, node_o3]) = .true.
+elseif (trim(self%tropprs_method) == "thompson") then
+  self%depends(node_tropprs, [node_pressures, node_geoph, node_t]) = .true.
+endif
+
+! Inputs carried over between states
+self%time_invariant(1)%name = 'phis'
+self%time_invariant(2)%name = 'slmsk'
+self%time_invariant(3)%name = 'vtype'
+self%time_invariant(4)%name = 'stype'
+
 end subroutine create
 
 ! --------------------------------------------------------------------------------------------------
@@ -84,20 +149,32 @@ subroutine delete(self)
 
 class(fv3jedi_vc_model2geovals), intent(inout) :: self
 
+integer :: n
+
+do n = 1, size(self%time_invariant)
+  if (allocated(self%time_invariant(n)%array)) deallocate(self%time_invariant(n)%array)
+enddo
+
 end subroutine delete
 
 ! --------------------------------------------------------------------------------------------------
 
 subroutine changevar(self, geom, xm, xg)
 
-class(fv3jedi_vc_model2geovals), intent(inout) :: self
+class(fv3jedi_vc_model2geovals), target, intent(inout) :: self
 type(fv3jedi_geom),              intent(inout) :: geom
 type(fv3jedi_state),             intent(in)    :: xm
 type(fv3jedi_state),             intent(inout) :: xg
 
-integer :: f, jlev, i, j, k
+integer :: jlev, i, j, k
 character(len=field_clen), allocatable :: fields_to_do(:)
-real(kind=kind_real), pointer :: field_ptr(:,:,:)
+
+! Derivation plan
+logical :: need(n_nodes)
+integer :: last_use(n_nodes)
+
+! Time-invariant input, from the state or carried over
+real(kind=kind_real), pointer     :: ti_ptr(:,:,:)
 
 ! Specific humidity
 logical :: have_q
@@ -302,617 +379,735 @@ call copy_subset(xm%fields, xg%fields, fields_to_do)
 if (.not.allocated(fields_to_do)) return
 
 
-! Get pressures at edge, center & log center
-! ------------------------------------------
+! Plan the derivation: only the nodes leading to the requested GeoVaLs are computed
+! ---------------------------------------------------------------------------------
+call self%plan(fields_to_do, need, last_use)
+
 have_pressures = .false.
+have_t = .false.
+have_q = .false.
+have_qsat = .false.
+have_rh = .false.
+have_geoph = .false.
+have_delz = .false.
+have_tv = .false.
+have_o3 = .false.
+have_winds = .false.
+have_slmsk = .false.
+have_zorl = .false.
+have_f10m = .false.
+have_domain_mask = .false.
+have_qmr = .false.
+have_qiql = .false.
+have_qr = .false.
+have_qs = .false.
+have_qg = .false.
+have_nc = .false.
+have_ni = .false.
+have_nr = .false.
+have_crtm_cld = .false.
+have_soilt = .false.
+have_soilm = .false.
+have_tskin = .false.
+have_crtm_surface = .false.
+have_sss = .false.
+have_snwdph = .false.
+have_vort = .false.
+have_tropprs = .false.
+have_co2 = .false.
+
+! GeoVaLs not derived from the model fields
+call fill_outputs(node_none)
 
-if (xm%has_field('delp')) then
-  call xm%get_field('delp', delp)
-  allocate(ps(self%isc:self%iec, self%jsc:self%jec, 1))
-  ps(:,:,1) = geom%ptop + sum(delp,3)
-  have_pressures = .true.
-elseif (xm%has_field('ps')) then
-  call xm%get_field('ps', ps)
-  allocate(delp(self%isc:self%iec, self%jsc:self%jec, self%npz))
-  do jlev = 1,self%npz
-    delp(:,:,jlev) = (geom%ak(jlev+1)-geom%ak(jlev))+(geom%bk(jlev+1)-geom%bk(jlev))*ps(:,:,1)
-  enddo
-  have_pressures = .true.
-elseif (xm%has_field('pe')) then
-  call xm%get_field('pe', prsi)
-  allocate(ps(self%isc:self%iec, self%jsc:self%jec, 1))
-  ps(:,:,1) = prsi(:,:,self%npz+1)
-  allocate(delp(self%isc:self%iec, self%jsc:self%jec, self%npz))
-  do jlev = 1,self%npz
-    delp(:,:,jlev) = prsi(:,:,jlev+1) - prsi(:,:,jlev)
-  enddo
-  have_pressures = .true.
-endif
 
-if (have_pressures) then
-  if (.not.allocated(prsi)) allocate(prsi(self%isc:self%iec,self%jsc:self%jec,self%npz+1))
-  if (.not.allocated(prs )) allocate(prs (self%isc:self%iec,self%jsc:self%jec,self%npz  ))
-  if (.not.allocated(pkz )) allocate(pkz (self%isc:self%iec,self%jsc:self%jec,self%npz  ))
-  call delp_to_pe_p_logp(geom, delp, prsi, prs, pkz=pkz)
+! Get pressures at edge, center & log center
+! ------------------------------------------
+if (need(node_pressures)) then
+  if (xm%has_field('delp')) then
+    call xm%get_field('delp', delp)
+    allocate(ps(self%isc:self%iec, self%jsc:self%jec, 1))
+    ps(:,:,1) = geom%ptop + sum(delp,3)
+    have_pressures = .true.
+  elseif (xm%has_field('ps')) then
+    call xm%get_field('ps', ps)
+    allocate(delp(self%isc:self%iec, self%jsc:self%jec, self%npz))
+    do jlev = 1,self%npz
+      delp(:,:,jlev) = (geom%ak(jlev+1)-geom%ak(jlev))+(geom%bk(jlev+1)-geom%bk(jlev))*ps(:,:,1)
+    enddo
+    have_pressures = .true.
+  elseif (xm%has_field('pe')) then
+    call xm%get_field('pe', prsi)
+    allocate(ps(self%isc:self%iec, self%jsc:self%jec, 1))
+    ps(:,:,1) = prsi(:,:,self%npz+1)
+    allocate(delp(self%isc:self%iec, self%jsc:self%jec, self%npz))
+    do jlev = 1,self%npz
+      delp(:,:,jlev) = prsi(:,:,jlev+1) - prsi(:,:,jlev)
+    enddo
+    have_pressures = .true.
+  endif
+
+  if (have_pressures) then
+    if (.not.allocated(prsi)) allocate(prsi(self%isc:self%iec,self%jsc:self%jec,self%npz+1))
+    if (.not.allocated(prs )) allocate(prs (self%isc:self%iec,self%jsc:self%jec,self%npz  ))
+    if (.not.allocated(pkz )) allocate(pkz (self%isc:self%iec,self%jsc:self%jec,self%npz  ))
+    call delp_to_pe_p_logp(geom, delp, prsi, prs, pkz=pkz)
+  endif
+  call node_done(node_pressures)
 endif
 
 ! Temperature
 ! -----------
-have_t = .false.
-if (xm%has_field( 't')) then
-  call xm%get_field('t', t)
-  have_t = .true.
+if (need(node_t)) then
+  if (xm%has_field( 't')) then
+    call xm%get_field('t', t)
+    have_t = .true.
+  endif
+  call node_done(node_t)
 endif
 
 ! Specific humidity
 ! -----------------
-have_q = .false.
-if (xm%has_field( 'sphum')) then
-  call xm%get_field('sphum',  q)
-  have_q = .true.
+if (need(node_q)) then
+  if (xm%has_field( 'sphum')) then
+    call xm%get_field('sphum',  q)
+    have_q = .true.
+  endif
+  call node_done(node_q)
 endif
 
 ! Saturation specific humidity
 ! ----------------------------
-have_qsat = .false.
-if (xm%has_field('qsat')) then
-  call xm%get_field('qsat', qsat)
-  have_qsat = .true.
-elseif (have_t .and. have_pressures .and. have_q) then
-  allocate(qsat(self%isc:self%iec,self%jsc:self%jec,self%npz))
-  call get_qsat(geom,delp,t,q,qsat)
-  have_qsat = .true.
+if (need(node_qsat)) then
+  if (xm%has_field('qsat')) then
+    call xm%get_field('qsat', qsat)
+    have_qsat = .true.
+  elseif (have_t .and. have_pressures .and. have_q) then
+    allocate(qsat(self%isc:self%iec,self%jsc:self%jec,self%npz))
+    call get_qsat(geom,delp,t,q,qsat)
+    have_qsat = .true.
+  endif
+  call node_done(node_qsat)
 endif
 
 ! Relative humidity
 ! -----------------
-have_rh = .false.
-if (xm%has_field('rh')) then
-  call xm%get_field('rh', rh)
-  have_rh = .true.
-elseif (have_qsat .and. have_q) then
-  allocate(rh  (self%isc:self%iec,self%jsc:self%jec,self%npz))
-  call q_to_rh(geom,qsat,q,rh)
-  have_rh = .true.
+if (need(node_rh)) then
+  if (xm%has_field('rh')) then
+    call xm%get_field('rh', rh)
+    have_rh = .true.
+  elseif (have_qsat .and. have_q) then
+    allocate(rh  (self%isc:self%iec,self%jsc:self%jec,self%npz))
+    call q_to_rh(geom,qsat,q,rh)
+    have_rh = .true.
+  endif
+  call node_done(node_rh)
 endif
 
 ! Geopotential height
 ! -------------------
-have_geoph = .false.
-if (have_t .and. have_pressures .and. have_q .and. ( xm%has_field('phis') .or. &
-  xm%has_field('geopotential_height_at_surface') )) then
-  if (.not.allocated(phis)) allocate(phis(self%isc:self%iec,self%jsc:self%jec,1))
-  if (.not.allocated(suralt)) allocate(suralt(self%isc:self%iec,self%jsc:self%jec,1))
-  if ( xm%has_field( 'phis') ) then
-     call xm%get_field('phis',  phis)
-     suralt = phis / constant('grav')
-  else
-     call xm%get_field('geopotential_height_at_surface', suralt)
-     phis = suralt * constant('grav')
-  end if
-  if (.not.allocated(geophi)) allocate(geophi(self%isc:self%iec,self%jsc:self%jec,self%npz+1))
-  if (.not.allocated(geoph )) allocate(geoph (self%isc:self%iec,self%jsc:self%jec,self%npz  ))
-  call geop_height(geom, prs, prsi, t, q, phis(:,:,1), use_compress, geoph)
-  call geop_height_levels(geom, prs, prsi, t, q, phis(:,:,1), use_compress, geophi)
-  have_geoph = .true.
+if (need(node_geoph)) then
+  if (have_t .and. have_pressures .and. have_q .and. ( self%has_time_invariant(xm, 'phis') .or. &
+    xm%has_field('geopotential_height_at_surface') )) then
+    if (.not.allocated(phis)) allocate(phis(self%isc:self%iec,self%jsc:self%jec,1))
+    if (.not.allocated(suralt)) allocate(suralt(self%isc:self%iec,self%jsc:self%jec,1))
+    if ( xm%has_field( 'phis') .or. .not. xm%has_field('geopotential_height_at_surface') ) then
+       call self%get_time_invariant(xm, 'phis', ti_ptr)
+       phis = ti_ptr
+       suralt = phis / constant('grav')
+    else
+       call xm%get_field('geopotential_height_at_surface', suralt)
+       phis = suralt * constant('grav')
+    end if
+    if (.not.allocated(geophi)) allocate(geophi(self%isc:self%iec,self%jsc:self%jec,self%npz+1))
+    if (.not.allocated(geoph )) allocate(geoph (self%isc:self%iec,self%jsc:self%jec,self%npz  ))
+    call geop_height(geom, prs, prsi, t, q, phis(:,:,1), use_compress, geoph)
+    call geop_height_levels(geom, prs, prsi, t, q, phis(:,:,1), use_compress, geophi)
+    have_geoph = .true.
+  endif
+  call node_done(node_geoph)
 endif
 
 ! Layer thickness
 ! ---------------
-have_delz = .false.
-if (xm%has_field('layer_thickness')) then
-   call xm%get_field('layer_thickness', delz)
-   have_delz = .true.
-elseif (have_geoph) then
-   allocate(delz(self%isc:self%iec,self%jsc:self%jec,self%npz))
-   delz = geophi(:,:,2:self%npz+1) - geophi(:,:,1:self%npz)
-   have_delz = .true.
+if (need(node_delz)) then
+  if (xm%has_field('layer_thickness')) then
+     call xm%get_field('layer_thickness', delz)
+     have_delz = .true.
+  elseif (have_geoph) then
+     allocate(delz(self%isc:self%iec,self%jsc:self%jec,self%npz))
+     delz = geophi(:,:,2:self%npz+1) - geophi(:,:,1:self%npz)
+     have_delz = .true.
+  endif
+  call node_done(node_delz)
 endif
 
 ! Virtual temperature
 ! -------------------
-have_tv = .false.
-if (xm%has_field( 'tv')) then
-    call xm%get_field('tv', tv)
+if (need(node_tv)) then
+  if (xm%has_field( 'tv')) then
+      call xm%get_field('tv', tv)
+      have_tv = .true.
+  elseif (have_t .and. have_q) then
+    allocate(tv(self%isc:self%iec,self%jsc:self%jec,self%npz))
+    call t_to_tv(geom, t, q, tv)
     have_tv = .true.
-elseif (have_t .and. have_q) then
-  allocate(tv(self%isc:self%iec,self%jsc:self%jec,self%npz))
-  call t_to_tv(geom, t, q, tv)
-  have_tv = .true.
+  endif
+  call node_done(node_tv)
 endif
 
-
 ! Ozone
 ! -----
-have_o3   = .false.
-if (xm%has_field( 'o3mr')) then
-  call xm%get_field('o3mr', o3mr)
-  allocate(o3ppmv(self%isc:self%iec,self%jsc:self%jec,self%npz))
-  o3ppmv = o3mr * constant('constoz')
-  have_o3 = .true.
-elseif (xm%has_field('o3ppmv')) then
-  call xm%get_field('o3ppmv', o3ppmv)
-  allocate(o3mr(self%isc:self%iec,self%jsc:self%jec,self%npz))
-  o3mr = o3ppmv / constant('constoz')
-  have_o3 = .true.
-endif
+if (need(node_o3)) then
+  if (xm%has_field( 'o3mr')) then
+    call xm%get_field('o3mr', o3mr)
+    allocate(o3ppmv(self%isc:self%iec,self%jsc:self%jec,self%npz))
+    o3ppmv = o3mr * constant('constoz')
+    have_o3 = .true.
+  elseif (xm%has_field('o3ppmv')) then
+    call xm%get_field('o3ppmv', o3ppmv)
+    allocate(o3mr(self%isc:self%iec,self%jsc:self%jec,self%npz))
+    o3mr = o3ppmv / constant('constoz')
+    have_o3 = .true.
+  endif
 
-if (have_o3) then
-  do k = 1, self%npz
-    do j = self%jsc, self%jec
-      do i = self%isc, self%iec
-        if (o3mr(i,j,k) < 0.0_kind_real ) then
-          o3mr(i,j,k)   = 0.0_kind_real
-          o3ppmv(i,j,k) = 0.0_kind_real
-        endif
+  if (have_o3) then
+    do k = 1, self%npz
+      do j = self%jsc, self%jec
+        do i = self%isc, self%iec
+          if (o3mr(i,j,k) < 0.0_kind_real ) then
+            o3mr(i,j,k)   = 0.0_kind_real
+            o3ppmv(i,j,k) = 0.0_kind_real
+          endif
+        enddo
       enddo
     enddo
-  enddo
+  endif
+  call node_done(node_o3)
 endif
 
 ! Wind transforms
 ! ---------------
-have_winds = .false.
-if (xm%has_field('ua')) then
-  call xm%get_field('ua', ua)
-  call xm%get_field('va', va)
-  have_winds = .true.
-elseif (xm%has_field('ud')) then
-  call xm%get_field('ud', ud)
-  call xm%get_field('vd', vd)
-  allocate(ua(self%isc:self%iec,self%jsc:self%jec,self%npz))
-  allocate(va(self%isc:self%iec,self%jsc:self%jec,self%npz))
-  call d_to_a(geom, ud, vd, ua, va)
-  have_winds = .true.
-  nullify(ud,vd)
+if (need(node_winds)) then
+  if (xm%has_field('ua')) then
+    call xm%get_field('ua', ua)
+    call xm%get_field('va', va)
+    have_winds = .true.
+  elseif (xm%has_field('ud')) then
+    call xm%get_field('ud', ud)
+    call xm%get_field('vd', vd)
+    allocate(ua(self%isc:self%iec,self%jsc:self%jec,self%npz))
+    allocate(va(self%isc:self%iec,self%jsc:self%jec,self%npz))
+    call d_to_a(geom, ud, vd, ua, va)
+    have_winds = .true.
+    nullify(ud,vd)
+  endif
+  call node_done(node_winds)
 endif
 
 ! Land sea mask
 ! -------------
-have_slmsk = .false.
-if (xm%has_field( 'slmsk')) then
-  call xm%get_field('slmsk', slmsk)
-  have_slmsk = .true.
-elseif ( xm%has_field('frocean' ) .and. xm%has_field('frlake'  ) .and. &
-         xm%has_field('frseaice') .and. xm%has_field('ts'    ) ) then
-  call xm%get_field('frocean' , frocean )
-  call xm%get_field('frlake'  , frlake  )
-  call xm%get_field('frseaice', frseaice)
-  call xm%get_field('ts'      , tskin   )
-
-  allocate(slmsk(self%isc:self%iec,self%jsc:self%jec,1))
-  slmsk = 1.0_kind_real !Land
-  do j = self%jsc,self%jec
-    do i = self%isc,self%iec
-      if ( frocean(i,j,1) + frlake(i,j,1) >= 0.6_kind_real) then
-        slmsk(i,j,1) = 0.0_kind_real ! Water
-      endif
-      if ( slmsk(i,j,1) == 0.0_kind_real .and. frseaice(i,j,1) > 0.5_kind_real) then
-        slmsk(i,j,1) = 2.0_kind_real ! Ice
-      endif
-      if ( slmsk(i,j,1) == 0.0_kind_real .and. tskin(i,j,1) < 271.4_kind_real ) then
-        slmsk(i,j,1) = 2.0_kind_real ! Ice
-      endif
+if (need(node_slmsk)) then
+  if (xm%has_field( 'slmsk')) then
+    call self%get_time_invariant(xm, 'slmsk', ti_ptr)
+    slmsk = ti_ptr
+    have_slmsk = .true.
+  elseif ( xm%has_field('frocean' ) .and. xm%has_field('frlake'  ) .and. &
+           xm%has_field('frseaice') .and. xm%has_field('ts'    ) ) then
+    call xm%get_field('frocean' , frocean )
+    call xm%get_field('frlake'  , frlake  )
+    call xm%get_field('frseaice', frseaice)
+    call xm%get_field('ts'      , tskin   )
+
+    allocate(slmsk(self%isc:self%iec,self%jsc:self%jec,1))
+    slmsk = 1.0_kind_real !Land
+    do j = self%jsc,self%jec
+      do i = self%isc,self%iec
+        if ( frocean(i,j,1) + frlake(i,j,1) >= 0.6_kind_real) then
+          slmsk(i,j,1) = 0.0_kind_real ! Water
+        endif
+        if ( slmsk(i,j,1) == 0.0_kind_real .and. frseaice(i,j,1) > 0.5_kind_real) then
+          slmsk(i,j,1) = 2.0_kind_real ! Ice
+        endif
+        if ( slmsk(i,j,1) == 0.0_kind_real .and. tskin(i,j,1) < 271.4_kind_real ) then
+          slmsk(i,j,1) = 2.0_kind_real ! Ice
+        endif
+      enddo
     enddo
-  enddo
-  have_slmsk = .true.
+    have_slmsk = .true.
+  elseif (self%has_time_invariant(xm, 'slmsk')) then
+    call self%get_time_invariant(xm, 'slmsk', ti_ptr)
+    slmsk = ti_ptr
+    have_slmsk = .true.
+  endif
+  call node_done(node_slmsk)
 endif
 
-
 ! Transform surface roughness length (zorl) from cm to meters.
 ! -------------
-have_zorl = .false.
-allocate(sfc_rough(self%isc:self%iec,self%jsc:self%jec,1))
-if (xm%has_field( 'zorl')) then
-  call xm%get_field('zorl', zorl)
-  have_zorl = .true.
-  sfc_rough = zorl*0.01
-else
-  sfc_rough = 0.01_kind_real
+if (need(node_zorl)) then
+  allocate(sfc_rough(self%isc:self%iec,self%jsc:self%jec,1))
+  if (xm%has_field( 'zorl')) then
+    call xm%get_field('zorl', zorl)
+    have_zorl = .true.
+    sfc_rough = zorl*0.01
+  else
+    sfc_rough = 0.01_kind_real
+  endif
+  call node_done(node_zorl)
 endif
 
-
 ! f10m
 ! ----
-have_f10m = .false.
-if (xm%has_field('f10m')) then
-  call xm%get_field('f10m', f10m)
-  have_f10m = .true.
-elseif ( xm%has_field( 'u_srf') .and. xm%has_field( 'v_srf') .and. have_winds ) then
-  call xm%get_field('u_srf' , u_srf)
-  call xm%get_field('v_srf' , v_srf)
-
-  allocate(f10m(self%isc:self%iec,self%jsc:self%jec,1))
-  f10m = sqrt(u_srf**2 + v_srf**2)
-
-  do j = self%jsc,self%jec
-    do i = self%isc,self%iec
-      wspd = sqrt(ua(i,j,self%npz)**2 +  va(i,j,self%npz)**2)
-      if (f10m(i,j,1) > 0.0_kind_real) then
-        f10m(i,j,1) = f10m(i,j,1)/wspd
-      else
-        f10m(i,j,1) = 1.0_kind_real
-      endif
+if (need(node_f10m)) then
+  if (xm%has_field('f10m')) then
+    call xm%get_field('f10m', f10m)
+    have_f10m = .true.
+  elseif ( xm%has_field( 'u_srf') .and. xm%has_field( 'v_srf') .and. have_winds ) then
+    call xm%get_field('u_srf' , u_srf)
+    call xm%get_field('v_srf' , v_srf)
+
+    allocate(f10m(self%isc:self%iec,self%jsc:self%jec,1))
+    f10m = sqrt(u_srf**2 + v_srf**2)
+
+    do j = self%jsc,self%jec
+      do i = self%isc,self%iec
+        wspd = sqrt(ua(i,j,self%npz)**2 +  va(i,j,self%npz)**2)
+        if (f10m(i,j,1) > 0.0_kind_real) then
+          f10m(i,j,1) = f10m(i,j,1)/wspd
+        else
+          f10m(i,j,1) = 1.0_kind_real
+        endif
+      enddo
     enddo
-  enddo
-  have_f10m = .true.
+    have_f10m = .true.
+  endif
+  call node_done(node_f10m)
 endif
 
 ! observable_domain_mask
 ! -----------
-have_domain_mask = .false.
-allocate(observable_domain_mask(self%isc:self%iec, self%jsc:self%jec, 1))
+if (need(node_domain_mask)) then
+  allocate(observable_domain_mask(self%isc:self%iec, self%jsc:self%jec, 1))
 
-! the compute domain defines the interior of the domain. Set mask index = 0.
-observable_domain_mask(self%isc:self%iec, self%jsc:self%jec, 1) = 0.0_kind_real
-have_domain_mask = .true.
+  ! the compute domain defines the interior of the domain. Set mask index = 0.
+  observable_domain_mask(self%isc:self%iec, self%jsc:self%jec, 1) = 0.0_kind_real
+  have_domain_mask = .true.
+  call node_done(node_domain_mask)
+endif
 
 ! CRTM mixing ratio
 ! -----------------
-have_qmr = .false.
-if (have_q) then
-  allocate(qmr(self%isc:self%iec,self%jsc:self%jec,self%npz))
-  call crtm_mixratio(geom, q, qmr)
-  have_qmr = .true.
+if (need(node_qmr)) then
+  if (have_q) then
+    allocate(qmr(self%isc:self%iec,self%jsc:self%jec,self%npz))
+    call crtm_mixratio(geom, q, qmr)
+    have_qmr = .true.
+  endif
+  call node_done(node_qmr)
 endif
 
 ! CO2
 ! ---
-allocate(co2(self%isc:self%iec,self%jsc:self%jec,self%npz))
-co2 = 407.0_kind_real
-if (xm%has_field('co2')) then
-  call xm%get_field('co2', co2)
+if (need(node_co2)) then
+  allocate(co2(self%isc:self%iec,self%jsc:self%jec,self%npz))
+  co2 = 407.0_kind_real
+  if (xm%has_field('co2')) then
+    call xm%get_field('co2', co2)
+  endif
+  have_co2 = .true.
+  call node_done(node_co2)
 endif
-have_co2 = .true.
 
 ! Clouds
 ! ------
-have_qiql = .false.
-if (xm%has_field( 'ice_wat') .and. xm%has_field( 'liq_wat')) then
-  call xm%get_field('ice_wat', qi)
-  call xm%get_field('liq_wat', ql)
-  have_qiql = .true.
-elseif (xm%has_field( 'qils') .and. xm%has_field( 'qicn') .and. &
-        xm%has_field( 'qlls') .and. xm%has_field( 'qlcn')) then
-  call xm%get_field('qils', qils)
-  call xm%get_field('qicn', qicn)
-  call xm%get_field('qlls', qlls)
-  call xm%get_field('qlcn', qlcn)
-  allocate(qi(self%isc:self%iec,self%jsc:self%jec,self%npz))
-  allocate(ql(self%isc:self%iec,self%jsc:self%jec,self%npz))
-  qi = qils + qicn
-  ql = qlls + qlcn
-  have_qiql = .true.
-endif
-! ------ Rain, snow, and graupel
-have_qr = .false.
-if (xm%has_field( 'rainwat')) then
-  call xm%get_field('rainwat', qr)
-  have_qr = .true.
-elseif (xm%has_field( 'qrls') .and. xm%has_field( 'qrcn')) then
-  call xm%get_field('qrls', qrls)
-  call xm%get_field('qrcn', qrcn)
-  allocate(qr(self%isc:self%iec,self%jsc:self%jec,self%npz))
-  qr = qrls + qrcn
-  have_qr = .true.
-endif
-! ------
-have_qs = .false.
-if (xm%has_field( 'snowwat')) then
-  call xm%get_field('snowwat', qs)
-  have_qs = .true.
-elseif (xm%has_field( 'qsls') .and. xm%has_field( 'qscn')) then
-  call xm%get_field('qsls', qsls)
-  call xm%get_field('qscn', qscn)
-  allocate(qs(self%isc:self%iec,self%jsc:self%jec,self%npz))
-  qs = qsls + qscn
-  have_qs = .true.
-endif
-! ------
-have_qg = .false.
-if (xm%has_field('graupel')) then
-  call xm%get_field('graupel', qg)
-  have_qg = .true.
-endif
-
-! 2-moment microphysics number mixing ratios (concentrations)
-have_nc = .false.
-if (xm%has_field('water_nc')) then
-  call xm%get_field('water_nc', nc)
-  have_nc = .true.
-endif
-have_ni = .false.
-if (xm%has_field('ice_nc')) then
-  call xm%get_field('ice_nc', ni)
-  have_ni = .true.
-endif
-have_nr = .false.
-if (xm%has_field('rain_nc')) then
-  call xm%get_field('rain_nc', nr)
-  have_nr = .true.
-endif
-
+if (need(node_hydrometeors)) then
+  if (xm%has_field( 'ice_wat') .and. xm%has_field( 'liq_wat')) then
+    call xm%get_field('ice_wat', qi)
+    call xm%get_field('liq_wat', ql)
+    have_qiql = .true.
+  elseif (xm%has_field( 'qils') .and. xm%has_field( 'qicn') .and. &
+          xm%has_field( 'qlls') .and. xm%has_field( 'qlcn')) then
+    call xm%get_field('qils', qils)
+    call xm%get_field('qicn', qicn)
+    call xm%get_field('qlls', qlls)
+    call xm%get_field('qlcn', qlcn)
+    allocate(qi(self%isc:self%iec,self%jsc:self%jec,self%npz))
+    allocate(ql(self%isc:self%iec,self%jsc:self%jec,self%npz))
+    qi = qils + qicn
+    ql = qlls + qlcn
+    have_qiql = .true.
+  endif
+  ! ------ Rain, snow, and graupel
+  if (xm%has_field( 'rainwat')) then
+    call xm%get_field('rainwat', qr)
+    have_qr = .true.
+  elseif (xm%has_field( 'qrls') .and. xm%has_field( 'qrcn')) then
+    call xm%get_field('qrls', qrls)
+    call xm%get_field('qrcn', qrcn)
+    allocate(qr(self%isc:self%iec,self%jsc:self%jec,self%npz))
+    qr = qrls + qrcn
+    have_qr = .true.
+  endif
+  ! ------
+  if (xm%has_field( 'snowwat')) then
+    call xm%get_field('snowwat', qs)
+    have_qs = .true.
+  elseif (xm%has_field( 'qsls') .and. xm%has_field( 'qscn')) then
+    call xm%get_field('qsls', qsls)
+    call xm%get_field('qscn', qscn)
+    allocate(qs(self%isc:self%iec,self%jsc:self%jec,self%npz))
+    qs = qsls + qscn
+    have_qs = .true.
+  endif
+  ! ------
+  if (xm%has_field('graupel')) then
+    call xm%get_field('graupel', qg)
+    have_qg = .true.
+  endif
 
-! Get CRTM moisture fields
-! ------------------------
-have_crtm_cld = .false.
-if (have_slmsk .and. have_t .and. have_pressures .and. have_q .and. have_qiql ) then
-  allocate(ql_ade(self%isc:self%iec,self%jsc:self%jec,self%npz))
-  allocate(qi_ade(self%isc:self%iec,self%jsc:self%jec,self%npz))
-  allocate(ql_efr(self%isc:self%iec,self%jsc:self%jec,self%npz))
-  allocate(qi_efr(self%isc:self%iec,self%jsc:self%jec,self%npz))
-  allocate(watercov(self%isc:self%iec,self%jsc:self%jec))
-  ql_ade = 0.0_kind_real
-  qi_ade = 0.0_kind_real
-  ql_efr = 0.0_kind_real
-  qi_efr = 0.0_kind_real
-
-  !TODO Is it water_area_fraction or sea_coverage fed in here?
-  watercov = 0.0_kind_real
-  do j = self%jsc,self%jec
-    do i = self%isc,self%iec
-      if (slmsk(i,j,1) == 0) watercov(i,j) = 1.0_kind_real
-    enddo
-  enddo
-  if (have_qr ) then
-    allocate(qr_ade(self%isc:self%iec,self%jsc:self%jec,self%npz))
-    allocate(qr_efr(self%isc:self%iec,self%jsc:self%jec,self%npz))
-    qr_ade = 0.0_kind_real
-    qr_efr = 0.0_kind_real
+  ! 2-moment microphysics number mixing ratios (concentrations)
+  if (xm%has_field('water_nc')) then
+    call xm%get_field('water_nc', nc)
+    have_nc = .true.
   endif
-  if (have_qs ) then
-    allocate(qs_ade(self%isc:self%iec,self%jsc:self%jec,self%npz))
-    allocate(qs_efr(self%isc:self%iec,self%jsc:self%jec,self%npz))
-    qs_ade = 0.0_kind_real
-    qs_efr = 0.0_kind_real
+  if (xm%has_field('ice_nc')) then
+    call xm%get_field('ice_nc', ni)
+    have_ni = .true.
   endif
-  if (have_qg ) then
-    allocate(qg_ade(self%isc:self%iec,self%jsc:self%jec,self%npz))
-    allocate(qg_efr(self%isc:self%iec,self%jsc:self%jec,self%npz))
-    qg_ade = 0.0_kind_real
-    qg_efr = 0.0_kind_real
+  if (xm%has_field('rain_nc')) then
+    call xm%get_field('rain_nc', nr)
+    have_nr = .true.
   endif
+  call node_done(node_hydrometeors)
+endif
 
-! Call routine that computes liquid/ice water paths and effective radii.
-! Different complexity for number of species and 1- or 2-moment microphysics.
+! Get CRTM moisture fields
 ! ------------------------
-
-  if (have_nc .and. have_ni .and. have_nr .and. have_qr .and. have_qs .and. have_qg) then
-    call crtm_ade_efr(geom=geom, p=prs, t=t, delp=delp, sea_frac=watercov,         &
-          q=q, ql=ql, qi=qi, qr=qr, qs=qs, qg=qg, nc=nc, ni=ni, nr=nr,             &
-          ql_ade=ql_ade,qi_ade=qi_ade,qr_ade=qr_ade,qs_ade=qs_ade,qg_ade=qg_ade,   &
-          ql_efr=ql_efr,qi_efr=qi_efr,qr_efr=qr_efr,qs_efr=qs_efr,qg_efr=qg_efr,   &
-          method=self%radii_method, use_mask=self%use_mask)
-  elseif (have_ni .and. have_nr .and. have_qr .and. have_qg) then
-    call crtm_ade_efr(geom=geom, p=prs, t=t, delp=delp, sea_frac=watercov,         &
-          q=q, ql=ql, qi=qi, qr=qr, qs=qs, qg=qg, ni=ni, nr=nr,                    &
-          ql_ade=ql_ade,qi_ade=qi_ade,qr_ade=qr_ade,qs_ade=qs_ade,qg_ade=qg_ade,   &
-          ql_efr=ql_efr,qi_efr=qi_efr,qr_efr=qr_efr,qs_efr=qs_efr,qg_efr=qg_efr,   &
-          method=self%radii_method, use_mask=self%use_mask)
-  elseif (have_ni .and. have_qs .and. have_qr .and. have_qg) then
-    call crtm_ade_efr(geom=geom, p=prs, t=t, delp=delp, sea_frac=watercov,         &
-          q=q, ql=ql, qi=qi, qr=qr, qs=qs, qg=qg, ni=ni,                           &
-          ql_ade=ql_ade,qi_ade=qi_ade,qr_ade=qr_ade,qs_ade=qs_ade,qg_ade=qg_ade,   &
-          ql_efr=ql_efr,qi_efr=qi_efr,qr_efr=qr_efr,qs_efr=qs_efr,qg_efr=qg_efr,   &
-          method=self%radii_method, use_mask=self%use_mask)
-  elseif (have_qr .and. have_qs .and. have_qg) then
-    call crtm_ade_efr(geom=geom, p=prs, t=t, delp=delp, sea_frac=watercov,         &
-          q=q, ql=ql, qi=qi, qr=qr, qs=qs, qg=qg,                                  &
-          ql_ade=ql_ade,qi_ade=qi_ade,qr_ade=qr_ade,qs_ade=qs_ade,qg_ade=qg_ade,   &
-          ql_efr=ql_efr,qi_efr=qi_efr,qr_efr=qr_efr,qs_efr=qs_efr,qg_efr=qg_efr,   &
-          method=self%radii_method, use_mask=self%use_mask)
-  elseif (have_qr .and. have_qs) then
-    call crtm_ade_efr(geom=geom, p=prs, t=t, delp=delp, sea_frac=watercov,         &
-          q=q, ql=ql, qi=qi, qr=qr, qs=qs,                                         &
-          ql_ade=ql_ade,qi_ade=qi_ade,qr_ade=qr_ade,qs_ade=qs_ade,                 &
-          ql_efr=ql_efr,qi_efr=qi_efr,qr_efr=qr_efr,qs_efr=qs_efr,                 &
-          method=self%radii_method, use_mask=self%use_mask)
-  elseif (have_qr .and. have_qg) then
-    call crtm_ade_efr(geom=geom, p=prs, t=t, delp=delp, sea_frac=watercov,         &
-          q=q, ql=ql, qi=qi, qr=qr, qg=qg,                                         &
-          ql_ade=ql_ade,qi_ade=qi_ade,qr_ade=qr_ade,qg_ade=qg_ade,                 &
-          ql_efr=ql_efr,qi_efr=qi_efr,qr_efr=qr_efr,qg_efr=qg_efr,                 &
-          method=self%radii_method, use_mask=self%use_mask)
-  elseif (have_qs .and. have_qg) then
-    call crtm_ade_efr(geom=geom, p=prs, t=t, delp=delp, sea_frac=watercov,         &
-          q=q, ql=ql, qi=qi, qs=qs, qg=qg,                                         &
-          ql_ade=ql_ade,qi_ade=qi_ade,qs_ade=qs_ade,qg_ade=qg_ade,                 &
-          ql_efr=ql_efr,qi_efr=qi_efr,qs_efr=qs_efr,qg_efr=qg_efr,                 &
-          method=self%radii_method, use_mask=self%use_mask)
-  elseif (have_qs) then
-    call crtm_ade_efr(geom=geom, p=prs, t=t, delp=delp, sea_frac=watercov,         &
-          q=q, ql=ql, qi=qi, qs=qs,                                                &
-          ql_ade=ql_ade,qi_ade=qi_ade,qs_ade=qs_ade,                               &
-          ql_efr=ql_efr,qi_efr=qi_efr,qs_efr=qs_efr,                               &
-          method=self%radii_method, use_mask=self%use_mask)
-  elseif (have_qr) then
-    call crtm_ade_efr(geom=geom, p=prs, t=t, delp=delp, sea_frac=watercov,         &
-          q=q, ql=ql, qi=qi, qr=qr,                                                &
-          ql_ade=ql_ade,qi_ade=qi_ade,qr_ade=qr_ade,                               &
-          ql_efr=ql_efr,qi_efr=qi_efr,qr_efr=qr_efr,                               &
-          method=self%radii_method, use_mask=self%use_mask)
-  else
-    call crtm_ade_efr(geom=geom, p=prs, t=t, delp=delp, sea_frac=watercov,         &
-          q=q, ql=ql, qi=qi,                                                       &
-          ql_ade=ql_ade,qi_ade=qi_ade,                                             &
-          ql_efr=ql_efr,qi_efr=qi_efr,                                             &
-          method=self%radii_method, use_mask=self%use_mask)
+if (need(node_crtm_cld)) then
+  if (have_slmsk .and. have_t .and. have_pressures .and. have_q .and. have_qiql ) then
+    allocate(ql_ade(self%isc:self%iec,self%jsc:self%jec,self%npz))
+    allocate(qi_ade(self%isc:self%iec,self%jsc:self%jec,self%npz))
+    allocate(ql_efr(self%isc:self%iec,self%jsc:self%jec,self%npz))
+    allocate(qi_efr(self%isc:self%iec,self%jsc:self%jec,self%npz))
+    allocate(watercov(self%isc:self%iec,self%jsc:self%jec))
+    ql_ade = 0.0_kind_real
+    qi_ade = 0.0_kind_real
+    ql_efr = 0.0_kind_real
+    qi_efr = 0.0_kind_real
+
+    !TODO Is it water_area_fraction or sea_coverage fed in here?
+    watercov = 0.0_kind_real
+    do j = self%jsc,self%jec
+      do i = self%isc,self%iec
+        if (slmsk(i,j,1) == 0) watercov(i,j) = 1.0_kind_real
+      enddo
+    enddo
+    if (have_qr ) then
+      allocate(qr_ade(self%isc:self%iec,self%jsc:self%jec,self%npz))
+      allocate(qr_efr(self%isc:self%iec,self%jsc:self%jec,self%npz))
+      qr_ade = 0.0_kind_real
+      qr_efr = 0.0_kind_real
+    endif
+    if (have_qs ) then
+      allocate(qs_ade(self%isc:self%iec,self%jsc:self%jec,self%npz))
+      allocate(qs_efr(self%isc:self%iec,self%jsc:self%jec,self%npz))
+      qs_ade = 0.0_kind_real
+      qs_efr = 0.0_kind_real
+    endif
+    if (have_qg ) then
+      allocate(qg_ade(self%isc:self%iec,self%jsc:self%jec,self%npz))
+      allocate(qg_efr(self%isc:self%iec,self%jsc:self%jec,self%npz))
+      qg_ade = 0.0_kind_real
+      qg_efr = 0.0_kind_real
+    endif
+
+  ! Call routine that computes liquid/ice water paths and effective radii.
+  ! Different complexity for number of species and 1- or 2-moment microphysics.
+  ! ------------------------
+
+    if (have_nc .and. have_ni .and. have_nr .and. have_qr .and. have_qs .and. have_qg) then
+      call crtm_ade_efr(geom=geom, p=prs, t=t, delp=delp, sea_frac=watercov,         &
+            q=q, ql=ql, qi=qi, qr=qr, qs=qs, qg=qg, nc=nc, ni=ni, nr=nr,             &
+            ql_ade=ql_ade,qi_ade=qi_ade,qr_ade=qr_ade,qs_ade=qs_ade,qg_ade=qg_ade,   &
+            ql_efr=ql_efr,qi_efr=qi_efr,qr_efr=qr_efr,qs_efr=qs_efr,qg_efr=qg_efr,   &
+            method=self%radii_method, use_mask=self%use_mask)
+    elseif (have_ni .and. have_nr .and. have_qr .and. have_qg) then
+      call crtm_ade_efr(geom=geom, p=prs, t=t, delp=delp, sea_frac=watercov,         &
+            q=q, ql=ql, qi=qi, qr=qr, qs=qs, qg=qg, ni=ni, nr=nr,                    &
+            ql_ade=ql_ade,qi_ade=qi_ade,qr_ade=qr_ade,qs_ade=qs_ade,qg_ade=qg_ade,   &
+            ql_efr=ql_efr,qi_efr=qi_efr,qr_efr=qr_efr,qs_efr=qs_efr,qg_efr=qg_efr,   &
+            method=self%radii_method, use_mask=self%use_mask)
+    elseif (have_ni .and. have_qs .and. have_qr .and. have_qg) then
+      call crtm_ade_efr(geom=geom, p=prs, t=t, delp=delp, sea_frac=watercov,         &
+            q=q, ql=ql, qi=qi, qr=qr, qs=qs, qg=qg, ni=ni,                           &
+            ql_ade=ql_ade,qi_ade=qi_ade,qr_ade=qr_ade,qs_ade=qs_ade,qg_ade=qg_ade,   &
+            ql_efr=ql_efr,qi_efr=qi_efr,qr_efr=qr_efr,qs_efr=qs_efr,qg_efr=qg_efr,   &
+            method=self%radii_method, use_mask=self%use_mask)
+    elseif (have_qr .and. have_qs .and. have_qg) then
+      call crtm_ade_efr(geom=geom, p=prs, t=t, delp=delp, sea_frac=watercov,         &
+            q=q, ql=ql, qi=qi, qr=qr, qs=qs, qg=qg,                                  &
+            ql_ade=ql_ade,qi_ade=qi_ade,qr_ade=qr_ade,qs_ade=qs_ade,qg_ade=qg_ade,   &
+            ql_efr=ql_efr,qi_efr=qi_efr,qr_efr=qr_efr,qs_efr=qs_efr,qg_efr=qg_efr,   &
+            method=self%radii_method, use_mask=self%use_mask)
+    elseif (have_qr .and. have_qs) then
+      call crtm_ade_efr(geom=geom, p=prs, t=t, delp=delp, sea_frac=watercov,         &
+            q=q, ql=ql, qi=qi, qr=qr, qs=qs,                                         &
+            ql_ade=ql_ade,qi_ade=qi_ade,qr_ade=qr_ade,qs_ade=qs_ade,                 &
+            ql_efr=ql_efr,qi_efr=qi_efr,qr_efr=qr_efr,qs_efr=qs_efr,                 &
+            method=self%radii_method, use_mask=self%use_mask)
+    elseif (have_qr .and. have_qg) then
+      call crtm_ade_efr(geom=geom, p=prs, t=t, delp=delp, sea_frac=watercov,         &
+            q=q, ql=ql, qi=qi, qr=qr, qg=qg,                                         &
+            ql_ade=ql_ade,qi_ade=qi_ade,qr_ade=qr_ade,qg_ade=qg_ade,                 &
+            ql_efr=ql_efr,qi_efr=qi_efr,qr_efr=qr_efr,qg_efr=qg_efr,                 &
+            method=self%radii_method, use_mask=self%use_mask)
+    elseif (have_qs .and. have_qg) then
+      call crtm_ade_efr(geom=geom, p=prs, t=t, delp=delp, sea_frac=watercov,         &
+            q=q, ql=ql, qi=qi, qs=qs, qg=qg,                                         &
+            ql_ade=ql_ade,qi_ade=qi_ade,qs_ade=qs_ade,qg_ade=qg_ade,                 &
+            ql_efr=ql_efr,qi_efr=qi_efr,qs_efr=qs_efr,qg_efr=qg_efr,                 &
+            method=self%radii_method, use_mask=self%use_mask)
+    elseif (have_qs) then
+      call crtm_ade_efr(geom=geom, p=prs, t=t, delp=delp, sea_frac=watercov,         &
+            q=q, ql=ql, qi=qi, qs=qs,                                                &
+            ql_ade=ql_ade,qi_ade=qi_ade,qs_ade=qs_ade,                               &
+            ql_efr=ql_efr,qi_efr=qi_efr,qs_efr=qs_efr,                               &
+            method=self%radii_method, use_mask=self%use_mask)
+    elseif (have_qr) then
+      call crtm_ade_efr(geom=geom, p=prs, t=t, delp=delp, sea_frac=watercov,         &
+            q=q, ql=ql, qi=qi, qr=qr,                                                &
+            ql_ade=ql_ade,qi_ade=qi_ade,qr_ade=qr_ade,                               &
+            ql_efr=ql_efr,qi_efr=qi_efr,qr_efr=qr_efr,                               &
+            method=self%radii_method, use_mask=self%use_mask)
+    else
+      call crtm_ade_efr(geom=geom, p=prs, t=t, delp=delp, sea_frac=watercov,         &
+            q=q, ql=ql, qi=qi,                                                       &
+            ql_ade=ql_ade,qi_ade=qi_ade,                                             &
+            ql_efr=ql_efr,qi_efr=qi_efr,                                             &
+            method=self%radii_method, use_mask=self%use_mask)
+    endif
+    have_crtm_cld = .true.
   endif
-  have_crtm_cld = .true.
+  call node_done(node_crtm_cld)
 endif
 
-
 ! CRTM surface fields
 ! -------------------
+if (need(node_soil)) then
+
+  ! Soil temperature
+  if (xm%has_field( 'soilt' )) then
+    call xm%get_field('soilt' , soilt )
+    have_soilt = .true.
+  elseif (xm%has_field( 'stc' )) then
+    call xm%get_field('stc' , soil_tmp )
+    allocate(soilt(self%isc:self%iec,self%jsc:self%jec,1))
+    soilt(:,:,1) = soil_tmp(:,:,1) ! Which of the 4 levels should we use?
+    have_soilt = .true.
+  endif
 
-! Soil temperature
-have_soilt = .false.
-if (xm%has_field( 'soilt' )) then
-  call xm%get_field('soilt' , soilt )
-  have_soilt = .true.
-elseif (xm%has_field( 'stc' )) then
-  call xm%get_field('stc' , soil_tmp )
-  allocate(soilt(self%isc:self%iec,self%jsc:self%jec,1))
-  soilt(:,:,1) = soil_tmp(:,:,1) ! Which of the 4 levels should we use?
-  have_soilt = .true.
-endif
-
-! Soil moisture
-have_soilm = .false.
-if (xm%has_field( 'soilm' )) then
-  call xm%get_field('soilm' , soilm )
-  have_soilm = .true.
-elseif (xm%has_field( 'smc' )) then
-  call xm%get_field('smc' , soil_tmp )
-  allocate(soilm(self%isc:self%iec,self%jsc:self%jec,1))
-  soilm(:,:,1) = soil_tmp(:,:,1) ! Which of the 4 levels should we use?
-  have_soilm = .true.
+  ! Soil moisture
+  if (xm%has_field( 'soilm' )) then
+    call xm%get_field('soilm' , soilm )
+    have_soilm = .true.
+  elseif (xm%has_field( 'smc' )) then
+    call xm%get_field('smc' , soil_tmp )
+    allocate(soilm(self%isc:self%iec,self%jsc:self%jec,1))
+    soilm(:,:,1) = soil_tmp(:,:,1) ! Which of the 4 levels should we use?
+    have_soilm = .true.
+  endif
+  call node_done(node_soil)
 endif
 
 ! Skin temperature
 ! ----------------
-have_tskin = .false.
-if ( xm%has_field( 'ts') ) then
-   allocate(skin_temperature_at_surface(self%isc:self%iec,self%jsc:self%jec,1))
-   call xm%get_field('ts', skin_temperature_at_surface)
-   have_tskin = .true.
-endif
-
-have_crtm_surface = .false.
-have_sss = .false.
-if ( have_slmsk .and. have_f10m .and. xm%has_field( 'sheleg') .and. &
-     xm%has_field( 'ts')     .and. xm%has_field( 'vtype' ) .and. &
-     xm%has_field( 'stype' ) .and. xm%has_field( 'vfrac' ) .and. &
-     have_soilt .and. have_soilm .and. &
-     xm%has_field( 'u_srf' ) .and. xm%has_field( 'v_srf' ) ) then
-
-  call xm%get_field('sheleg', sheleg)
-  call xm%get_field('ts'    , tskin )
-  call xm%get_field('vtype' , vtype )
-  call xm%get_field('stype' , stype )
-  call xm%get_field('vfrac' , vfrac )
-  call xm%get_field('u_srf' , u_srf )
-  call xm%get_field('v_srf' , v_srf )
-
-  allocate(land_type_index_npoess                    (self%isc:self%iec,self%jsc:self%jec,1))
-  allocate(land_type_index_igbp                      (self%isc:self%iec,self%jsc:self%jec,1))
-  allocate(vegetation_type_index                     (self%isc:self%iec,self%jsc:self%jec,1))
-  allocate(soil_type                                 (self%isc:self%iec,self%jsc:self%jec,1))
-  allocate(water_area_fraction                       (self%isc:self%iec,self%jsc:self%jec,1))
-  allocate(land_area_fraction                        (self%isc:self%iec,self%jsc:self%jec,1))
-  allocate(ice_area_fraction                         (self%isc:self%iec,self%jsc:self%jec,1))
-  allocate(surface_snow_area_fraction                (self%isc:self%iec,self%jsc:self%jec,1))
-  allocate(leaf_area_index                           (self%isc:self%iec,self%jsc:self%jec,1))
-  allocate(skin_temperature_at_surface_where_sea     (self%isc:self%iec,self%jsc:self%jec,1))
-  allocate(skin_temperature_at_surface_where_land    (self%isc:self%iec,self%jsc:self%jec,1))
-  allocate(skin_temperature_at_surface_where_ice     (self%isc:self%iec,self%jsc:self%jec,1))
-  allocate(skin_temperature_at_surface_where_snow    (self%isc:self%iec,self%jsc:self%jec,1))
-  allocate(volume_fraction_of_condensed_water_in_soil(self%isc:self%iec,self%jsc:self%jec,1))
-  allocate(vegetation_area_fraction                  (self%isc:self%iec,self%jsc:self%jec,1))
-  allocate(soil_temperature                          (self%isc:self%iec,self%jsc:self%jec,1))
-  allocate(surface_snow_thickness                    (self%isc:self%iec,self%jsc:self%jec,1))
-  allocate(wind_speed_at_surface                     (self%isc:self%iec,self%jsc:self%jec,1))
-  allocate(wind_from_direction_at_surface            (self%isc:self%iec,self%jsc:self%jec,1))
-  allocate(sea_surface_salinity                      (self%isc:self%iec,self%jsc:self%jec,1))
-
-  allocate(sss(self%isc:self%iec,self%jsc:self%jec,1))
-  sss = 0.0_kind_real
-  if (xm%has_field( 'sss')) then
-    call xm%get_field('sss', sss)
-    have_sss = .true.
+if (need(node_tskin)) then
+  if ( xm%has_field( 'ts') ) then
+     allocate(skin_temperature_at_surface(self%isc:self%iec,self%jsc:self%jec,1))
+     call xm%get_field('ts', skin_temperature_at_surface)
+     have_tskin = .true.
   endif
+  call node_done(node_tskin)
+endif
 
-  ! Compute day of year, used for surface fields with seasonal variation
-  sec_of_year = datetime_seconds_since_jan1(xm%time)
-  fractional_day_of_year = sec_of_year / 86400.0_kind_real
-
-  ! Here we compute the surface data for CRTM. A particular note about the surface types:
-  !
-  ! We compute at once the CRTM surface types supported in fv3-jedi: land types in two possible
-  ! classification schemes, soil type, and vegetation type (*). This simplifies the logic, and
-  ! should only be a negligible additional expense. A minor optimization would be to pass to
-  ! `crtm_surface` information about which surface type was requested from this function
-  ! (changevar), so only the requested type would be computed. Typically, this would be land type
-  ! (in just a single classification scheme) for vis/IR obs, or soil and vegetation types for
-  ! microwave obs.
-  !
-  ! (*) Note: CRTM also supports the USGS land type classification -- to use this with fv3-jedi, the
-  ! mapping from the fv3-jedi land type to the USGS land type must be added to `crtm_surface`. This
-  ! would exactly follow the code currently in place for the NPOESS and IGBP classifications.
-  call crtm_surface( geom, fractional_day_of_year, &
-                     slmsk, sheleg, skin_temperature_at_surface, vtype, stype, vfrac, soilt, &
-                     soilm, u_srf, v_srf, f10m, sss, land_type_index_npoess, land_type_index_igbp, &
-                     vegetation_type_index, soil_type, water_area_fraction, land_area_fraction, &
-                     ice_area_fraction, surface_snow_area_fraction, leaf_area_index, &
-                     skin_temperature_at_surface_where_sea, &
-                     skin_temperature_at_surface_where_land, &
-                     skin_temperature_at_surface_where_ice, &
-                     skin_temperature_at_surface_where_snow, &
-                     volume_fraction_of_condensed_water_in_soil, vegetation_area_fraction, &
-                     soil_temperature, surface_snow_thickness, &
-                     wind_speed_at_surface, wind_from_direction_at_surface, sea_surface_salinity)
-
-  have_crtm_surface = .true.
+! CRTM surface data
+! -----------------
+if (need(node_crtm_sfc)) then
+  if ( have_slmsk .and. have_f10m .and. xm%has_field( 'sheleg') .and. &
+       xm%has_field( 'ts')     .and. self%has_time_invariant(xm, 'vtype') .and. &
+       self%has_time_invariant(xm, 'stype') .and. xm%has_field( 'vfrac' ) .and. &
+       have_soilt .and. have_soilm .and. &
+       xm%has_field( 'u_srf' ) .and. xm%has_field( 'v_srf' ) ) then
+
+    call xm%get_field('sheleg', sheleg)
+    call xm%get_field('ts'    , tskin )
+    call self%get_time_invariant(xm, 'vtype', vtype)
+    call self%get_time_invariant(xm, 'stype', stype)
+    call xm%get_field('vfrac' , vfrac )
+    call xm%get_field('u_srf' , u_srf )
+    call xm%get_field('v_srf' , v_srf )
+
+    allocate(land_type_index_npoess                    (self%isc:self%iec,self%jsc:self%jec,1))
+    allocate(land_type_index_igbp                      (self%isc:self%iec,self%jsc:self%jec,1))
+    allocate(vegetation_type_index                     (self%isc:self%iec,self%jsc:self%jec,1))
+    allocate(soil_type                                 (self%isc:self%iec,self%jsc:self%jec,1))
+    allocate(water_area_fraction                       (self%isc:self%iec,self%jsc:self%jec,1))
+    allocate(land_area_fraction                        (self%isc:self%iec,self%jsc:self%jec,1))
+    allocate(ice_area_fraction                         (self%isc:self%iec,self%jsc:self%jec,1))
+    allocate(surface_snow_area_fraction                (self%isc:self%iec,self%jsc:self%jec,1))
+    allocate(leaf_area_index                           (self%isc:self%iec,self%jsc:self%jec,1))
+    allocate(skin_temperature_at_surface_where_sea     (self%isc:self%iec,self%jsc:self%jec,1))
+    allocate(skin_temperature_at_surface_where_land    (self%isc:self%iec,self%jsc:self%jec,1))
+    allocate(skin_temperature_at_surface_where_ice     (self%isc:self%iec,self%jsc:self%jec,1))
+    allocate(skin_temperature_at_surface_where_snow    (self%isc:self%iec,self%jsc:self%jec,1))
+    allocate(volume_fraction_of_condensed_water_in_soil(self%isc:self%iec,self%jsc:self%jec,1))
+    allocate(vegetation_area_fraction                  (self%isc:self%iec,self%jsc:self%jec,1))
+    allocate(soil_temperature                          (self%isc:self%iec,self%jsc:self%jec,1))
+    allocate(surface_snow_thickness                    (self%isc:self%iec,self%jsc:self%jec,1))
+    allocate(wind_speed_at_surface                     (self%isc:self%iec,self%jsc:self%jec,1))
+    allocate(wind_from_direction_at_surface            (self%isc:self%iec,self%jsc:self%jec,1))
+    allocate(sea_surface_salinity                      (self%isc:self%iec,self%jsc:self%jec,1))
+
+    allocate(sss(self%isc:self%iec,self%jsc:self%jec,1))
+    sss = 0.0_kind_real
+    if (xm%has_field( 'sss')) then
+      call xm%get_field('sss', sss)
+      have_sss = .true.
+    endif
+
+    ! Compute day of year, used for surface fields with seasonal variation
+    sec_of_year = datetime_seconds_since_jan1(xm%time)
+    fractional_day_of_year = sec_of_year / 86400.0_kind_real
+
+    ! Here we compute the surface data for CRTM. A particular note about the surface types:
+    !
+    ! We compute at once the CRTM surface types supported in fv3-jedi: land types in two possible
+    ! classification schemes, soil type, and vegetation type (*). This simplifies the logic, and
+    ! should only be a negligible additional expense. A minor optimization would be to pass to
+    ! `crtm_surface` information about which surface type was requested from this function
+    ! (changevar), so only the requested type would be computed. Typically, this would be land type
+    ! (in just a single classification scheme) for vis/IR obs, or soil and vegetation types for
+    ! microwave obs.
+    !
+    ! (*) Note: CRTM also supports the USGS land type classification -- to use this with fv3-jedi, the
+    ! mapping from the fv3-jedi land type to the USGS land type must be added to `crtm_surface`. This
+    ! would exactly follow the code currently in place for the NPOESS and IGBP classifications.
+    call crtm_surface( geom, fractional_day_of_year, &
+                       slmsk, sheleg, skin_temperature_at_surface, vtype, stype, vfrac, soilt, &
+                       soilm, u_srf, v_srf, f10m, sss, land_type_index_npoess, land_type_index_igbp, &
+                       vegetation_type_index, soil_type, water_area_fraction, land_area_fraction, &
+                       ice_area_fraction, surface_snow_area_fraction, leaf_area_index, &
+                       skin_temperature_at_surface_where_sea, &
+                       skin_temperature_at_surface_where_land, &
+                       skin_temperature_at_surface_where_ice, &
+                       skin_temperature_at_surface_where_snow, &
+                       volume_fraction_of_condensed_water_in_soil, vegetation_area_fraction, &
+                       soil_temperature, surface_snow_thickness, &
+                       wind_speed_at_surface, wind_from_direction_at_surface, sea_surface_salinity)
+
+    have_crtm_surface = .true.
 
+  endif
+  call node_done(node_crtm_sfc)
 endif
 
 ! Snow depth
-have_snwdph = .false.
-if (xm%has_field('totalSnowDepth')) then
-   allocate(snwdph_meters(self%isc:self%iec,self%jsc:self%jec,1))
-   call xm%get_field('totalSnowDepth', snwdph)
-   snwdph_meters = 1.e-3_kind_real*snwdph
-   have_snwdph = .true.
-elseif (xm%has_field('totalSnowDepthMeters')) then
-   allocate(snwdph(self%isc:self%iec,self%jsc:self%jec,1))
-   call xm%get_field('totalSnowDepthMeters', snwdph_meters)
-   snwdph = 1.e+3_kind_real*snwdph_meters
-   have_snwdph = .true.
-end if
+if (need(node_snwdph)) then
+  if (xm%has_field('totalSnowDepth')) then
+     allocate(snwdph_meters(self%isc:self%iec,self%jsc:self%jec,1))
+     call xm%get_field('totalSnowDepth', snwdph)
+     snwdph_meters = 1.e-3_kind_real*snwdph
+     have_snwdph = .true.
+  elseif (xm%has_field('totalSnowDepthMeters')) then
+     allocate(snwdph(self%isc:self%iec,self%jsc:self%jec,1))
+     call xm%get_field('totalSnowDepthMeters', snwdph_meters)
+     snwdph = 1.e+3_kind_real*snwdph_meters
+     have_snwdph = .true.
+  end if
+  call node_done(node_snwdph)
+endif
 
 ! Vorticity
 ! ---------
-have_vort = .false.
-if (xm%has_field('ud') .and. xm%has_field('vd')) then
-  call xm%get_field('ud', ud)
-  call xm%get_field('vd', vd)
-  allocate(vort(self%isc:self%iec,self%jsc:self%jec,self%npz))
-  allocate(divg(self%isc:self%iec,self%jsc:self%jec,self%npz))
-  call udvd_to_vortdivg(geom, ud, vd, vort, divg)
-  have_vort = .true.
-  nullify(ud, vd)
-elseif (have_winds) then
-  allocate(vort(self%isc:self%iec,self%jsc:self%jec,self%npz))
-  allocate(divg(self%isc:self%iec,self%jsc:self%jec,self%npz))
-  allocate(ud(self%isc:self%iec  ,self%jsc:self%jec+1,self%npz))
-  allocate(vd(self%isc:self%iec+1,self%jsc:self%jec  ,self%npz))
-  call a_to_d(geom, ua, va, ud, vd)
-  call udvd_to_vortdivg(geom, ud, vd, vort, divg)
-  have_vort = .true.
+if (need(node_vort)) then
+  if (xm%has_field('ud') .and. xm%has_field('vd')) then
+    call xm%get_field('ud', ud)
+    call xm%get_field('vd', vd)
+    allocate(vort(self%isc:self%iec,self%jsc:self%jec,self%npz))
+    allocate(divg(self%isc:self%iec,self%jsc:self%jec,self%npz))
+    call udvd_to_vortdivg(geom, ud, vd, vort, divg)
+    have_vort = .true.
+    nullify(ud, vd)
+  elseif (have_winds) then
+    allocate(vort(self%isc:self%iec,self%jsc:self%jec,self%npz))
+    allocate(divg(self%isc:self%iec,self%jsc:self%jec,self%npz))
+    allocate(ud(self%isc:self%iec  ,self%jsc:self%jec+1,self%npz))
+    allocate(vd(self%isc:self%iec+1,self%jsc:self%jec  ,self%npz))
+    call a_to_d(geom, ua, va, ud, vd)
+    call udvd_to_vortdivg(geom, ud, vd, vort, divg)
+    deallocate(ud, vd)
+    have_vort = .true.
+  endif
+  call node_done(node_vort)
 endif
 
-
 ! Tropopause pressure
 ! -------------------
-have_tropprs = .false.
-if (trim(self%tropprs_method) == "gsi") then
-  if (have_vort .and. have_tv .and. have_pressures .and. have_o3) then
-    allocate(tprs(self%isc:self%iec,self%jsc:self%jec,1))
-    call tropprs(geom, ps, prs, tv, o3ppmv, vort, tprs)
-    have_tropprs = .true.
-  endif
-elseif (trim(self%tropprs_method) == "thompson") then
-  if (have_pressures .and. have_geoph .and. have_t) then
-    allocate(tprs(self%isc:self%iec,self%jsc:self%jec,1))
-    call tropprs_th(geom, prs, geoph, t, tprs)
-    have_tropprs = .true.
+if (need(node_tropprs)) then
+  if (trim(self%tropprs_method) == "gsi") then
+    if (have_vort .and. have_tv .and. have_pressures .and. have_o3) then
+      allocate(tprs(self%isc:self%iec,self%jsc:self%jec,1))
+      call tropprs(geom, ps, prs, tv, o3ppmv, vort, tprs)
+      have_tropprs = .true.
+    endif
+  elseif (trim(self%tropprs_method) == "thompson") then
+    if (have_pressures .and. have_geoph .and. have_t) then
+      allocate(tprs(self%isc:self%iec,self%jsc:self%jec,1))
+      call tropprs_th(geom, prs, geoph, t, tprs)
+      have_tropprs = .true.
+    endif
   endif
+  call node_done(node_tropprs)
 endif
 
-! Loop over the fields not found in the input state and work through cases
-! ------------------------------------------------------------------------
+! Every intermediate has been released by its last consumer
+! ---------------------------------------------------------
+deallocate(fields_to_do)
+
+contains
+
+! --------------------------------------------------------------------------------------------------
+
+!> Fill the GeoVaLs provided by a node that has run and free the intermediates it was the last
+!> consumer of
+subroutine node_done(node)
+
+integer, intent(in) :: node
+
+integer :: n
+
+call fill_outputs(node)
+
+do n = 1, node
+  if (need(n) .and. last_use(n) == node) call release(n)
+enddo
+
+end subroutine node_done
+
+! --------------------------------------------------------------------------------------------------
+
+!> Copy the requested GeoVaLs that are provided by node to the output state
+subroutine fill_outputs(node)
+
+integer, intent(in) :: node
+
+integer :: f
+real(kind=kind_real), pointer :: field_ptr(:,:,:)
+
 do f = 1, size(fields_to_do)
 
+  if (output_node(fields_to_do(f)) /= node) cycle
+
   call xg%get_field(trim(fields_to_do(f)),  field_ptr)
 
   select case (trim(fields_to_do(f)))
@@ -1206,106 +1401,304 @@ do f = 1, size(fields_to_do)
 
 enddo
 
-if (associated(sheleg)) nullify(sheleg)
-if (associated(vtype)) nullify(vtype)
-if (associated(stype)) nullify(stype)
-if (associated(vfrac)) nullify(vfrac)
-if (allocated(soilt)) deallocate(soilt)
-if (allocated(soilm)) deallocate(soilm)
-if (associated(zorl)) nullify(zorl)
-if (associated(field_ptr)) nullify(field_ptr)
-if (associated(q)) nullify(q)
-if (associated(ud)) nullify(ud)
-if (associated(vd)) nullify(vd)
-if (associated(frocean)) nullify(frocean)
-if (associated(frlake)) nullify(frlake)
-if (associated(frseaice)) nullify(frseaice)
-if (associated(tskin)) nullify(tskin)
-if (associated(u_srf)) nullify(u_srf)
-if (associated(v_srf)) nullify(v_srf)
-if (associated(qils)) nullify(qils)
-if (associated(qlls)) nullify(qlls)
-if (associated(qrls)) nullify(qrls)
-if (associated(qsls)) nullify(qsls)
-if (associated(qicn)) nullify(qicn)
-if (associated(qlcn)) nullify(qlcn)
-if (associated(qrcn)) nullify(qrcn)
-if (associated(qscn)) nullify(qscn)
-
-if (allocated(fields_to_do)) deallocate(fields_to_do)
-if (allocated(qsat)) deallocate(qsat)
-if (allocated(rh)) deallocate(rh)
-if (allocated(t)) deallocate(t)
-if (allocated(tv)) deallocate(tv)
-if (allocated(ps)) deallocate(ps)
-if (allocated(delp)) deallocate(delp)
-if (allocated(prsi)) deallocate(prsi)
-if (allocated(prs)) deallocate(prs)
-if (allocated(pkz)) deallocate(pkz)
-if (allocated(phis)) deallocate(phis)
-if (allocated(geophi)) deallocate(geophi)
-if (allocated(geoph)) deallocate(geoph)
-if (allocated(suralt)) deallocate(suralt)
-if (allocated(delz)) deallocate(delz)
-if (allocated(o3mr)) deallocate(o3mr)
-if (allocated(o3ppmv)) deallocate(o3ppmv)
-if (allocated(ua)) deallocate(ua)
-if (allocated(va)) deallocate(va)
-if (allocated(slmsk)) deallocate(slmsk)
-if (allocated(sfc_rough)) deallocate(sfc_rough)
-if (allocated(f10m)) deallocate(f10m)
-if (allocated(observable_domain_mask)) deallocate(observable_domain_mask)
-if (allocated(ql)) deallocate(ql)
-if (allocated(qi)) deallocate(qi)
-if (allocated(qr)) deallocate(qr)
-if (allocated(qs)) deallocate(qs)
-if (allocated(qg)) deallocate(qg)
-if (allocated(qmr)) deallocate(qmr)
-if (allocated(nc)) deallocate(nc)
-if (allocated(ni)) deallocate(ni)
-if (allocated(nr)) deallocate(nr)
-if (allocated(co2)) deallocate(co2)
-if (allocated(ql_ade)) deallocate(ql_ade)
-if (allocated(qi_ade)) deallocate(qi_ade)
-if (allocated(qr_ade)) deallocate(qr_ade)
-if (allocated(qs_ade)) deallocate(qs_ade)
-if (allocated(qg_ade)) deallocate(qg_ade)
-if (allocated(ql_efr)) deallocate(ql_efr)
-if (allocated(qi_efr)) deallocate(qi_efr)
-if (allocated(qr_efr)) deallocate(qr_efr)
-if (allocated(qs_efr)) deallocate(qs_efr)
-if (allocated(qg_efr)) deallocate(qg_efr)
-if (allocated(watercov)) deallocate(watercov)
-if (allocated(sss)) deallocate(sss)
-if (allocated(land_type_index_npoess)) deallocate(land_type_index_npoess)
-if (allocated(land_type_index_igbp)) deallocate(land_type_index_igbp)
-if (allocated(vegetation_type_index)) deallocate(vegetation_type_index)
-if (allocated(soil_type)) deallocate(soil_type)
-if (allocated(water_area_fraction)) deallocate(water_area_fraction)
-if (allocated(land_area_fraction)) deallocate(land_area_fraction)
-if (allocated(ice_area_fraction)) deallocate(ice_area_fraction)
-if (allocated(surface_snow_area_fraction)) deallocate(surface_snow_area_fraction)
-if (allocated(leaf_area_index)) deallocate(leaf_area_index)
-if (allocated(skin_temperature_at_surface_where_sea)) deallocate(skin_temperature_at_surface_where_sea)
-if (allocated(skin_temperature_at_surface_where_land)) deallocate(skin_temperature_at_surface_where_land)
-if (allocated(skin_temperature_at_surface_where_ice)) deallocate(skin_temperature_at_surface_where_ice)
-if (allocated(skin_temperature_at_surface_where_snow)) deallocate(skin_temperature_at_surface_where_snow)
-if (allocated(volume_fraction_of_condensed_water_in_soil)) &
+end subroutine fill_outputs
+
+! --------------------------------------------------------------------------------------------------
+
+!> Free the intermediates owned by a node
+subroutine release(node)
+
+integer, intent(in) :: node
+
+select case (node)
+case (node_pressures)
+  if (allocated(ps)) deallocate(ps)
+  if (allocated(delp)) deallocate(delp)
+  if (allocated(prsi)) deallocate(prsi)
+  if (allocated(prs)) deallocate(prs)
+  if (allocated(pkz)) deallocate(pkz)
+case (node_t)
+  if (allocated(t)) deallocate(t)
+case (node_q)
+  if (associated(q)) nullify(q)
+case (node_qsat)
+  if (allocated(qsat)) deallocate(qsat)
+case (node_rh)
+  if (allocated(rh)) deallocate(rh)
+case (node_geoph)
+  if (allocated(phis)) deallocate(phis)
+  if (allocated(geophi)) deallocate(geophi)
+  if (allocated(geoph)) deallocate(geoph)
+  if (allocated(suralt)) deallocate(suralt)
+case (node_delz)
+  if (allocated(delz)) deallocate(delz)
+case (node_tv)
+  if (allocated(tv)) deallocate(tv)
+case (node_o3)
+  if (allocated(o3mr)) deallocate(o3mr)
+  if (allocated(o3ppmv)) deallocate(o3ppmv)
+case (node_winds)
+  if (allocated(ua)) deallocate(ua)
+  if (allocated(va)) deallocate(va)
+case (node_slmsk)
+  if (allocated(slmsk)) deallocate(slmsk)
+  if (associated(frocean)) nullify(frocean)
+  if (associated(frlake)) nullify(frlake)
+  if (associated(frseaice)) nullify(frseaice)
+  if (associated(tskin)) nullify(tskin)
+case (node_zorl)
+  if (allocated(sfc_rough)) deallocate(sfc_rough)
+  if (associated(zorl)) nullify(zorl)
+case (node_f10m)
+  if (allocated(f10m)) deallocate(f10m)
+  if (associated(u_srf)) nullify(u_srf)
+  if (associated(v_srf)) nullify(v_srf)
+case (node_domain_mask)
+  if (allocated(observable_domain_mask)) deallocate(observable_domain_mask)
+case (node_qmr)
+  if (allocated(qmr)) deallocate(qmr)
+case (node_co2)
+  if (allocated(co2)) deallocate(co2)
+case (node_hydrometeors)
+  if (allocated(ql)) deallocate(ql)
+  if (allocated(qi)) deallocate(qi)
+  if (allocated(qr)) deallocate(qr)
+  if (allocated(qs)) deallocate(qs)
+  if (allocated(qg)) deallocate(qg)
+  if (allocated(nc)) deallocate(nc)
+  if (allocated(ni)) deallocate(ni)
+  if (allocated(nr)) deallocate(nr)
+  if (associated(qils)) nullify(qils)
+  if (associated(qlls)) nullify(qlls)
+  if (associated(qrls)) nullify(qrls)
+  if (associated(qsls)) nullify(qsls)
+  if (associated(qicn)) nullify(qicn)
+  if (associated(qlcn)) nullify(qlcn)
+  if (associated(qrcn)) nullify(qrcn)
+  if (associated(qscn)) nullify(qscn)
+case (node_crtm_cld)
+  if (allocated(ql_ade)) deallocate(ql_ade)
+  if (allocated(qi_ade)) deallocate(qi_ade)
+  if (allocated(qr_ade)) deallocate(qr_ade)
+  if (allocated(qs_ade)) deallocate(qs_ade)
+  if (allocated(qg_ade)) deallocate(qg_ade)
+  if (allocated(ql_efr)) deallocate(ql_efr)
+  if (allocated(qi_efr)) deallocate(qi_efr)
+  if (allocated(qr_efr)) deallocate(qr_efr)
+  if (allocated(qs_efr)) deallocate(qs_efr)
+  if (allocated(qg_efr)) deallocate(qg_efr)
+  if (allocated(watercov)) deallocate(watercov)
+case (node_soil)
+  if (allocated(soilt)) deallocate(soilt)
+  if (allocated(soilm)) deallocate(soilm)
+  if (associated(soil_tmp)) nullify(soil_tmp)
+case (node_tskin)
+  if (allocated(skin_temperature_at_surface)) deallocate(skin_temperature_at_surface)
+case (node_crtm_sfc)
+  if (associated(sheleg)) nullify(sheleg)
+  if (associated(vtype)) nullify(vtype)
+  if (associated(stype)) nullify(stype)
+  if (associated(vfrac)) nullify(vfrac)
+  if (associated(tskin)) nullify(tskin)
+  if (associated(u_srf)) nullify(u_srf)
+  if (associated(v_srf)) nullify(v_srf)
+  if (allocated(sss)) deallocate(sss)
+  if (allocated(land_type_index_npoess)) deallocate(land_type_index_npoess)
+  if (allocated(land_type_index_igbp)) deallocate(land_type_index_igbp)
+  if (allocated(vegetation_type_index)) deallocate(vegetation_type_index)
+  if (allocated(soil_type)) deallocate(soil_type)
+  if (allocated(water_area_fraction)) deallocate(water_area_fraction)
+  if (allocated(land_area_fraction)) deallocate(land_area_fraction)
+  if (allocated(ice_area_fraction)) deallocate(ice_area_fraction)
+  if (allocated(surface_snow_area_fraction)) deallocate(surface_snow_area_fraction)
+  if (allocated(leaf_area_index)) deallocate(leaf_area_index)
+  if (allocated(skin_temperature_at_surface_where_sea)) &
+                                              deallocate(skin_temperature_at_surface_where_sea)
+  if (allocated(skin_temperature_at_surface_where_land)) &
+                                              deallocate(skin_temperature_at_surface_where_land)
+  if (allocated(skin_temperature_at_surface_where_ice)) &
+                                              deallocate(skin_temperature_at_surface_where_ice)
+  if (allocated(skin_temperature_at_surface_where_snow)) &
+                                              deallocate(skin_temperature_at_surface_where_snow)
+  if (allocated(volume_fraction_of_condensed_water_in_soil)) &
                                               deallocate(volume_fraction_of_condensed_water_in_soil)
-if (allocated(vegetation_area_fraction)) deallocate(vegetation_area_fraction)
-if (allocated(soil_temperature)) deallocate(soil_temperature)
-if (allocated(surface_snow_thickness)) deallocate(surface_snow_thickness)
-if (allocated(wind_speed_at_surface)) deallocate(wind_speed_at_surface)
-if (allocated(wind_from_direction_at_surface)) deallocate(wind_from_direction_at_surface)
-if (allocated(sea_surface_salinity)) deallocate(sea_surface_salinity)
-if (allocated(skin_temperature_at_surface)) deallocate(skin_temperature_at_surface)
-if (allocated(snwdph)) deallocate(snwdph)
-if (allocated(snwdph_meters)) deallocate(snwdph_meters)
-if (allocated(vort)) deallocate(vort)
-if (allocated(tprs)) deallocate(tprs)
+  if (allocated(vegetation_area_fraction)) deallocate(vegetation_area_fraction)
+  if (allocated(soil_temperature)) deallocate(soil_temperature)
+  if (allocated(surface_snow_thickness)) deallocate(surface_snow_thickness)
+  if (allocated(wind_speed_at_surface)) deallocate(wind_speed_at_surface)
+  if (allocated(wind_from_direction_at_surface)) deallocate(wind_from_direction_at_surface)
+  if (allocated(sea_surface_salinity)) deallocate(sea_surface_salinity)
+case (node_snwdph)
+  if (allocated(snwdph)) deallocate(snwdph)
+  if (allocated(snwdph_meters)) deallocate(snwdph_meters)
+case (node_vort)
+  if (allocated(vort)) deallocate(vort)
+  if (allocated(divg)) deallocate(divg)
+case (node_tropprs)
+  if (allocated(tprs)) deallocate(tprs)
+end select
+
+end subroutine release
+
+! --------------------------------------------------------------------------------------------------
 
 end subroutine changevar
 
 ! --------------------------------------------------------------------------------------------------
 
+!> Mark the nodes needed for the requested GeoVaLs and the node after which each can be released
+subroutine plan(self, fields_to_do, need, last_use)
+
+class(fv3jedi_vc_model2geovals), intent(in)  :: self
+character(len=field_clen),       intent(in)  :: fields_to_do(:)
+logical,                         intent(out) :: need(n_nodes)
+integer,                         intent(out) :: last_use(n_nodes)
+
+integer :: f, n, m
+
+! Nodes providing the requested GeoVaLs
+need = .false.
+do f = 1, size(fields_to_do)
+  n = output_node(fields_to_do(f))
+  if (n /= node_none) need(n) = .true.
+enddo
+
+! Nodes only depend on lower numbered nodes so one backward sweep adds all the prerequisites
+do n = n_nodes, 1, -1
+  if (need(n)) need = need .or. self%depends(n,:)
+enddo
+
+! Intermediates live until the last needed node consuming them has run
+do m = 1, n_nodes
+  last_use(m) = m
+  do n = m+1, n_nodes
+    if (need(n) .and. self%depends(n,m)) last_use(m) = n
+  enddo
+enddo
+
+end subroutine plan
+
+! --------------------------------------------------------------------------------------------------
+
+!> Whether a time-invariant input is in the state or was kept from an earlier state
+function has_time_invariant(self, xm, fieldname) result(have)
+
+class(fv3jedi_vc_model2geovals), intent(in) :: self
+type(fv3jedi_state),             intent(in) :: xm
+character(len=*),                intent(in) :: fieldname
+logical                                     :: have
+
+integer :: n
+
+have = xm%has_field(fieldname)
+do n = 1, size(self%time_invariant)
+  if (trim(self%time_invariant(n)%name) == trim(fieldname)) &
+    have = have .or. allocated(self%time_invariant(n)%array)
+enddo
+
+end function has_time_invariant
+
+! --------------------------------------------------------------------------------------------------
+
+!> Time-invariant input from the state, keeping a copy of the first one seen for later states, or
+!> the copy kept
+subroutine get_time_invariant(self, xm, fieldname, field)
+
+class(fv3jedi_vc_model2geovals), target, intent(inout) :: self
+type(fv3jedi_state),                     intent(in)    :: xm
+character(len=*),                        intent(in)    :: fieldname
+real(kind=kind_real), pointer,           intent(out)   :: field(:,:,:)
+
+integer :: n
+
+do n = 1, size(self%time_invariant)
+  if (trim(self%time_invariant(n)%name) == trim(fieldname)) exit
+enddo
+if (n > size(self%time_invariant)) &
+  call abor1_ftn("fv3jedi_vc_model2geovals_mod.get_time_invariant: "//trim(fieldname)// &
+                 " is not a time-invariant field")
+
+if (xm%has_field(fieldname)) then
+  call xm%get_field(fieldname, field)
+  if (.not. allocated(self%time_invariant(n)%array)) self%time_invariant(n)%array = field
+else
+  if (.not. allocated(self%time_invariant(n)%array)) call field_fail(fieldname)
+  field => self%time_invariant(n)%array
+endif
+
+end subroutine get_time_invariant
+
+! --------------------------------------------------------------------------------------------------
+
+!> Node of the derivation graph providing a GeoVaL
+function output_node(fieldname) result(node)
+
+character(len=*), intent(in) :: fieldname
+integer                      :: node
+
+select case (trim(fieldname))
+case ("ua", "va")
+  node = node_winds
+case ("q", "water_vapor_mixing_ratio_wrt_moist_air")
+  node = node_q
+case ("qsat", "saturation_water_vapor_mixing_ratio_wrt_moist_air")
+  node = node_qsat
+case ("rh")
+  node = node_rh
+case ("mole_fraction_of_ozone_in_air", "o3ppmv")
+  node = node_o3
+case ("geopotential_height_times_gravity_at_surface", "phis", "geopotential_height_at_surface", &
+      "geopotential_height", "geopotential_height_levels", &
+      "height_above_mean_sea_level_at_surface", "height_above_mean_sea_level")
+  node = node_geoph
+case ("layer_thickness", "delz")
+  node = node_delz
+case ("mole_fraction_of_carbon_dioxide_in_air", "co2")
+  node = node_co2
+case ("water_vapor_mixing_ratio_wrt_dry_air")
+  node = node_qmr
+case ("mass_content_of_cloud_liquid_water_in_atmosphere_layer", &
+      "mass_content_of_cloud_ice_in_atmosphere_layer", &
+      "mass_content_of_rain_in_atmosphere_layer", &
+      "mass_content_of_snow_in_atmosphere_layer", &
+      "mass_content_of_graupel_in_atmosphere_layer", &
+      "effective_radius_of_cloud_liquid_water_particle", &
+      "effective_radius_of_cloud_ice_particle", &
+      "effective_radius_of_rain_particle", &
+      "effective_radius_of_snow_particle", &
+      "effective_radius_of_graupel_particle")
+  node = node_crtm_cld
+case ("water_area_fraction", "land_area_fraction", "ice_area_fraction", &
+      "surface_snow_area_fraction", "sea_surface_salinity", &
+      "skin_temperature_at_surface_where_sea", "skin_temperature_at_surface_where_land", &
+      "skin_temperature_at_surface_where_ice", "skin_temperature_at_surface_where_snow", &
+      "surface_snow_thickness", "vegetation_area_fraction", "wind_speed_at_surface", &
+      "wind_from_direction_at_surface", "leaf_area_index", &
+      "volume_fraction_of_condensed_water_in_soil", "soil_temperature", &
+      "land_type_index_NPOESS", "land_type_index_IGBP", "vegetation_type_index", "soil_type", &
+      "average_surface_temperature_within_field_of_view")
+  node = node_crtm_sfc
+case ("skin_temperature_at_surface")
+  node = node_tskin
+case ("wind_reduction_factor_at_10m")
+  node = node_f10m
+case ("observable_domain_mask")
+  node = node_domain_mask
+case ("surface_roughness_length")
+  node = node_zorl
+case ("totalSnowDepth", "snwdph", "totalSnowDepthMeters", "snwdphMeters")
+  node = node_snwdph
+case ("air_upward_absolute_vorticity", "vort")
+  node = node_vort
+case ("tropopause_pressure")
+  node = node_tropprs
+case default
+  ! Constant fields, and unknown fields which fill_outputs reports
+  node = node_none
+end select
+
+end function output_node
+
+! --------------------------------------------------------------------------------------------------
+
 end module fv3jedi_vc_model2geovals_mod
@@ -0,0 +1,26 @@
+/*
+ * (C) Copyright 2024 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#pragma once
+
+namespace fv3jedi {
+  extern "C" {
+    // Geopotential height at mid layers and at interfaces of nx by ny columns of npz layers, arrays
+    // with the x index fastest and the levels slowest
+    void fv3jedi_geop_height_f90(const int &, const int &, const int &, const bool &,
+                                 const double *, const double *, const double *, const double *,
+                                 const double *, double *, double *);
+    // Tangent linear and adjoint of the mid layer height for the ideal gas form
+    void fv3jedi_geop_height_tl_f90(const int &, const int &, const int &,
+                                    const double *, const double *, const double *, const double *,
+                                    const double *, const double *, const double *, const double *,
+                                    double *);
+    void fv3jedi_geop_height_ad_f90(const int &, const int &, const int &,
+                                    const double *, const double *, const double *, const double *,
+                                    double *, double *, double *, double *, double *);
+  }  // extern "C"
+}  // namespace fv3jedi
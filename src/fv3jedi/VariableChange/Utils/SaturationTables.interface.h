@@ -0,0 +1,16 @@
+/*
+ * (C) Copyright 2024 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#pragma once
+
+namespace fv3jedi {
+  extern "C" {
+    // Saturation vapour pressure over water at n temperatures from the shared table and from the
+    // formula the table is built from
+    void fv3jedi_saturation_tables_es_water_f90(const int &, const double *, double *, double *);
+  }  // extern "C"
+}  // namespace fv3jedi
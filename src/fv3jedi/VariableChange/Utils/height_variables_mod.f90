@@ -34,9 +34,43 @@ real(kind_real),parameter ::  ef_gamma = 5.6e-7_kind_real
 
 public geop_height
 public geop_height_levels
+public geop_height_tl
+public geop_height_ad
+
+! Number of columns processed together by the height kernels
+integer, parameter :: height_block = 64
 
 contains
 
+! --------------------------------------------------------------------------------------------------
+! The height kernels integrate the hypsometric equation upwards from the surface over blocks of up
+! to height_block consecutive points along a row. Scratch space is a handful of block-length
+! vectors: virtual temperature and log(pressure) of the level below are carried from one level to
+! the next so each is evaluated once per level, and inner loops run along the contiguous i index.
+! --------------------------------------------------------------------------------------------------
+
+! Compressibility factor of moist air (eq A1.4 of Picard et al 2008) at temperature tkk, pressure
+! pak (hPa) and mixing ratio qmk
+elemental function compress_factor(tkk, pak, qmk, tice, rdry, rvap) result(cmpr)
+
+real(kind=kind_real), intent(in) :: tkk, pak, qmk, tice, rdry, rvap
+real(kind=kind_real) :: cmpr
+
+real(kind=kind_real) :: tc, prs_sv, ehn_fct, prs_v, x_v
+
+tc      = tkk - tice
+prs_sv  = exp(psv_a*tkk**2 + psv_b*tkk + psv_c + psv_d/tkk) ! Pvap sat, eq A1.1 (Pa)
+ehn_fct = ef_alpha + ef_beta*pak + ef_gamma*tc**2           ! enhancement factor (eq. A1.2)
+prs_v   = qmk*pak/(1.0+qmk*rdry/rvap)                       ! vapor pressure (Pa)
+x_v     = prs_v/prs_sv * ehn_fct * prs_sv/pak               ! molar fraction of water vapor (eq. A1.3)
+cmpr    = 1.0_kind_real - (pak/tkk) * (cpf_a0 + cpf_a1*tc + cpf_a2*tc**2 &
+            + (cpf_b0 + cpf_b1*tc)*x_v + (cpf_c0 + cpf_c1*tc)*x_v**2 ) &
+            + (pak**2/tkk**2) * (cpf_d + cpf_e*x_v**2)
+
+end function compress_factor
+
+! --------------------------------------------------------------------------------------------------
+
 subroutine geop_height(geom,prs,prsi,T,q,phis,use_compress,gph)
 
 implicit none
@@ -46,17 +80,16 @@ real(kind_real), intent(in ) :: prsi(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%
 real(kind_real), intent(in ) :: phis(geom%isc:geom%iec,geom%jsc:geom%jec)              !Surface geopotential (grav*Z_sfc)
 real(kind_real), intent(in ) :: T(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
 real(kind_real), intent(in ) :: q(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)     ! specific humidity
+logical,         intent(in ) :: use_compress
 real(kind_real), intent(out) :: gph(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)   !geopotential height (meters)
 
 !locals
-real(kind_real)       :: Tv(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
-real(kind_real)       :: qmr(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz) ! mixing ratio|kg/kg
-logical               :: use_compress
-integer               :: isc,iec,jsc,jec,npz,i,j,k
-real(kind=kind_real)  :: Tkk,Tvk,Tc, qmk,Pak,dpk,dz
-real(kind=kind_real)  :: prs_sv, prs_v
-real(kind=kind_real)  :: ehn_fct,x_v,cmpr
-real(kind=kind_real)  :: zvir, tice, rdry, rvap, grav
+integer              :: isc,iec,jsc,jec,npz,i,j,k,ib,ie,n
+real(kind=kind_real) :: zvir, tice, rdry, rvap, grav, rog
+real(kind=kind_real) :: tv_dn(height_block), tv_k(height_block)     !Virtual temperature below/at level k
+real(kind=kind_real) :: lnp_dn(height_block), lnp_k(height_block)   !Log of pressure (hPa) below/at level k
+real(kind=kind_real) :: qmk(height_block), tkk(height_block), tvk(height_block), pak(height_block)
+real(kind=kind_real) :: dz(height_block)
 
 isc = geom%isc
 iec = geom%iec
@@ -70,72 +103,70 @@ tice = constant('tice')
 rdry = constant('rdry')
 rvap = constant('rvap')
 grav = constant('grav')
-
-!get qmr--mixing ratio and virtual temeprature
-qmr(isc:iec,jsc:jec,:) = q(isc:iec,jsc:jec,:)/(1.0 - q(isc:iec,jsc:jec,:))
-Tv(isc:iec,jsc:jec,:)  = T(isc:iec,jsc:jec,:)*(1.0 + zvir*qmr(isc:iec,jsc:jec,:))
-
-if (use_compress) then
-
-!  Compute compressibility factor (Picard et al 2008) and geopotential heights at midpoint
-  do j = jsc,jec
-  do i = isc,iec
-
-     do k = geom%npz, 1, -1
-        if ( k == geom%npz) then
-           Tkk  = T(i,j,k)
-           Tvk  = Tv(i,j,k)
-           Pak  = exp(0.5_kind_real*(log(prsi(i,j,k+1)*0.01)+log(prs(i,j,k)*0.01)))
-           dpk  = prsi(i,j,k+1)/prs(i,j,k)
-        else
-           Tkk  = 0.5_kind_real * ( T(i,j,k+1) +  T(i,j,k) )
-           Tvk  = 0.5_kind_real * (Tv(i,j,k+1) + Tv(i,j,k) )
-           Pak  = exp(0.5_kind_real*(log(prs(i,j,k+1)*0.01)+log(prs(i,j,k)*0.01)))
-           dpk  = prs(i,j,k+1)/prs(i,j,k)
-        end if
-
-        Tc   = Tkk - tice
-        qmk  = qmr(i,j,k)
-        prs_sv  = exp(psv_a*Tkk**2 + psv_b*Tkk + psv_c + psv_d/Tkk ) ! Pvap sat, eq A1.1 (Pa)
-        ehn_fct = ef_alpha + ef_beta*Pak + ef_gamma*Tc**2 ! enhancement factor (eq. A1.2)
-        prs_v   = qmk* Pak/(1.0+qmk*rdry/rvap)            ! vapor pressure (Pa)
-        x_v     = prs_v/prs_sv * ehn_fct * prs_sv/Pak     ! molar fraction of water vapor (eq. A1.3)
-!       Compressibility factor (eq A1.4 from Picard et al 2008)
-        cmpr    = 1.0_kind_real - (Pak/Tkk) * (cpf_a0 + cpf_a1*Tc + cpf_a2*Tc**2 &
-                    + (cpf_b0 + cpf_b1*Tc)*x_v + (cpf_c0 + cpf_c1*Tc)*x_v**2 ) &
-                    + (Pak**2/Tkk**2) * (cpf_d + cpf_e*x_v**2)
-        dz      = rdry/grav * Tvk * cmpr * log(dpk)
-        if ( k == geom%npz) then
-          gph(i,j,k) = phis(i,j)/grav + dz
-        else
-          gph(i,j,k) = gph(i,j,k+1) + dz
-        end if
-      end do ! end k loop
-
-    end do ! end i loop
-    end do ! end j loop
-
-else  ! not use compressivity
-
-  do j = jsc,jec
-  do i = isc,iec
-
-     k  = geom%npz
-     dz         = rdry/grav * Tv(i,j,k) * log(prsi(i,j,k+1)/prs(i,j,k))
-     gph(i,j,k) = phis(i,j)/grav + dz
-
-     do k = geom%npz-1, 1, -1
-        dz         = rdry/grav * 0.5_kind_real * (Tv(i,j,k+1)+Tv(i,j,k)) * log(prs(i,j,k+1)/prs(i,j,k))
-        gph(i,j,k) = gph(i,j,k+1) + dz
-     end do
-
-   end do
-   end do
-
-end if
+rog  = rdry/grav
+
+!$omp parallel do num_threads(geom%nthreads) default(shared) collapse(2) &
+!$omp private(i,j,k,ib,ie,n,tv_dn,tv_k,lnp_dn,lnp_k,qmk,tkk,tvk,pak,dz)
+do j = jsc,jec
+  do ib = isc,iec,height_block
+
+    ie = min(ib+height_block-1,iec)
+    n = ie-ib+1
+
+    ! Lowest layer, integrated from the surface interface to the midpoint
+    k = npz
+    do i = ib,ie
+      qmk(i-ib+1) = q(i,j,k)/(1.0 - q(i,j,k))
+      tv_k(i-ib+1) = T(i,j,k)*(1.0 + zvir*qmk(i-ib+1))
+    enddo
+    if (use_compress) then
+      do i = ib,ie
+        lnp_k(i-ib+1) = log(prs(i,j,k)*0.01)
+        pak(i-ib+1) = exp(0.5_kind_real*(log(prsi(i,j,k+1)*0.01)+lnp_k(i-ib+1)))
+      enddo
+      dz(1:n) = rog * tv_k(1:n) * &
+                compress_factor(T(ib:ie,j,k), pak(1:n), qmk(1:n), tice, rdry, rvap) * &
+                log(prsi(ib:ie,j,k+1)/prs(ib:ie,j,k))
+    else
+      dz(1:n) = rog * tv_k(1:n) * log(prsi(ib:ie,j,k+1)/prs(ib:ie,j,k))
+    endif
+    gph(ib:ie,j,k) = phis(ib:ie,j)/grav + dz(1:n)
+
+    ! Remaining layers, integrated from the midpoint below
+    do k = npz-1,1,-1
+
+      tv_dn(1:n) = tv_k(1:n)
+      do i = ib,ie
+        qmk(i-ib+1) = q(i,j,k)/(1.0 - q(i,j,k))
+        tv_k(i-ib+1) = T(i,j,k)*(1.0 + zvir*qmk(i-ib+1))
+      enddo
+
+      if (use_compress) then
+        lnp_dn(1:n) = lnp_k(1:n)
+        do i = ib,ie
+          lnp_k(i-ib+1) = log(prs(i,j,k)*0.01)
+          pak(i-ib+1) = exp(0.5_kind_real*(lnp_dn(i-ib+1)+lnp_k(i-ib+1)))
+          tkk(i-ib+1) = 0.5_kind_real * ( T(i,j,k+1) +  T(i,j,k) )
+          tvk(i-ib+1) = 0.5_kind_real * (tv_dn(i-ib+1) + tv_k(i-ib+1))
+        enddo
+        dz(1:n) = rog * tvk(1:n) * compress_factor(tkk(1:n), pak(1:n), qmk(1:n), tice, rdry, rvap) * &
+                  log(prs(ib:ie,j,k+1)/prs(ib:ie,j,k))
+      else
+        dz(1:n) = rog * 0.5_kind_real * (tv_dn(1:n)+tv_k(1:n)) * log(prs(ib:ie,j,k+1)/prs(ib:ie,j,k))
+      endif
+
+      gph(ib:ie,j,k) = gph(ib:ie,j,k+1) + dz(1:n)
+
+    enddo
+
+  enddo
+enddo
+!$omp end parallel do
 
 end subroutine geop_height
 
+! --------------------------------------------------------------------------------------------------
+
 subroutine geop_height_levels(geom,prs,prsi,T,q,phis,use_compress,gphi)
 
 implicit none
@@ -146,18 +177,15 @@ real(kind_real), intent(in ) :: prsi(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%
 real(kind_real), intent(in ) :: phis(geom%isc:geom%iec,geom%jsc:geom%jec)              !Surface geopotential (grav*Z_sfc)
 real(kind_real), intent(in ) :: T(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
 real(kind_real), intent(in ) :: q(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)      !specific humidity
+logical,         intent(in ) :: use_compress
 real(kind_real), intent(out) :: gphi(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz+1) !geopotential height at interface levels (m)
 
 !locals
-real(kind_real)       :: Tv(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
-real(kind_real)       :: qmr(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz) ! mixing ratio|kg/kg
-logical               :: use_compress
-
-integer               :: isc,iec,jsc,jec,npz,i,j,k
-real(kind=kind_real)  :: Tkk,Tvk,Tc, qmk,Pak,dpk,dz
-real(kind=kind_real)  :: prs_sv, prs_v
-real(kind=kind_real)  :: ehn_fct,x_v,cmpr
-real(kind=kind_real)  :: zvir, tice, rdry, rvap, grav
+integer              :: isc,iec,jsc,jec,npz,i,j,k,ib,ie,n
+real(kind=kind_real) :: zvir, tice, rdry, rvap, grav, rog
+real(kind=kind_real) :: lnpi_dn(height_block), lnp_up(height_block)   !Log of pressure (hPa) at layer bottom/top
+real(kind=kind_real) :: qmk(height_block), tvk(height_block), pak(height_block), dz(height_block)
+real(kind=kind_real) :: cmpr(height_block)
 
 isc = geom%isc
 iec = geom%iec
@@ -171,65 +199,227 @@ tice = constant('tice')
 rdry = constant('rdry')
 rvap = constant('rvap')
 grav = constant('grav')
+rog  = rdry/grav
 
-!get qmr--mixing ratio and virtual temeprature
-qmr(isc:iec,jsc:jec,:) = q(isc:iec,jsc:jec,:)/(1.0 - q(isc:iec,jsc:jec,:))
-Tv(isc:iec,jsc:jec,:)  = T(isc:iec,jsc:jec,:)*(1.0 + zvir*qmr(isc:iec,jsc:jec,:))
+!$omp parallel do num_threads(geom%nthreads) default(shared) collapse(2) &
+!$omp private(i,j,k,ib,ie,n,lnpi_dn,lnp_up,qmk,tvk,pak,dz,cmpr)
+do j = jsc,jec
+  do ib = isc,iec,height_block
 
-if (use_compress) then
+    ie = min(ib+height_block-1,iec)
+    n = ie-ib+1
 
-!  Compute compressibility factor (Picard et al 2008) and geopotential heights at midpoint
-  do j = jsc,jec
-  do i = isc,iec
+    gphi(ib:ie,j,npz+1) = phis(ib:ie,j)/grav
+    if (use_compress) lnpi_dn(1:n) = log(prsi(ib:ie,j,npz+1)*0.01)
 
-     gphi(i,j,geom%npz+1) = phis(i,j)/grav !phis is gh? or gopoential
-     do k = geom%npz, 1, -1
-        if ( k == 1) then
-           Pak  = exp(0.5_kind_real*(log(prsi(i,j,k+1)*0.01)+log(prs(i,j,k)*0.01)))
-           dpk  = prsi(i,j,k+1)/prs(i,j,k)
-        else
-           Pak  = exp(0.5_kind_real*(log(prsi(i,j,k+1)*0.01)+log(prsi(i,j,k)*0.01)))
-           dpk  = prsi(i,j,k+1)/prsi(i,j,k)
-        end if
-        Tkk  = T(i,j,k)
-        Tvk  = Tv(i,j,k)
-        Tc   = Tkk - tice
-        qmk  = qmr(i,j,k)
-        prs_sv  = exp(psv_a*Tkk**2 + psv_b*Tkk + psv_c + psv_d/Tkk ) ! Pvap sat, eq A1.1 (Pa)
-        ehn_fct = ef_alpha + ef_beta*Pak + ef_gamma*Tc**2 ! enhancement factor (eq. A1.2)
-        prs_v   = qmk* Pak/(1.0+qmk*rdry/rvap)            ! vapor pressure (Pa)
-        x_v     = prs_v/prs_sv * ehn_fct * prs_sv/Pak     ! molar fraction of water vapor (eq. A1.3)
-!       Compressibility factor (eq A1.4 from Picard et al 2008)
-
-        cmpr    = 1.0_kind_real - (Pak/Tkk) * (cpf_a0 + cpf_a1*Tc + cpf_a2*Tc**2 &
-                    + (cpf_b0 + cpf_b1*Tc)*x_v + (cpf_c0 + cpf_c1*Tc)*x_v**2 ) &
-                    + (Pak**2/Tkk**2) * (cpf_d + cpf_e*x_v**2)
-        dz      = rdry/grav * Tvk * cmpr * log(dpk)
-        gphi(i,j,k) = gphi(i,j,k+1) + dz
-      end do ! end k loop
-
-  end do ! end i loop
-  end do ! end j loop
-
-else  ! not use compressivity
-  do j = jsc,jec
-  do i = isc,iec
-
-     gphi(i,j, geom%npz+1) = phis(i,j)/grav
-
-     do k = geom%npz, 1, -1
-        if(k ==1) then
-          dz         = rdry/grav * Tv(i,j,k) * log(prsi(i,j,k+1)/prs(i,j,k))
+    ! The top layer is integrated to the top midpoint rather than the model top
+    do k = npz,1,-1
+
+      do i = ib,ie
+        qmk(i-ib+1) = q(i,j,k)/(1.0 - q(i,j,k))
+        tvk(i-ib+1) = T(i,j,k)*(1.0 + zvir*qmk(i-ib+1))
+      enddo
+
+      if (use_compress) then
+        if (k == 1) then
+          lnp_up(1:n) = log(prs(ib:ie,j,k)*0.01)
         else
-          dz         = rdry/grav * Tv(i,j,k) * log(prsi(i,j,k+1)/prsi(i,j,k))
-        end if
-        gphi(i,j,k) = gphi(i,j,k+1) + dz
-     end do
+          lnp_up(1:n) = log(prsi(ib:ie,j,k)*0.01)
+        endif
+        pak(1:n) = exp(0.5_kind_real*(lnpi_dn(1:n)+lnp_up(1:n)))
+        cmpr(1:n) = compress_factor(T(ib:ie,j,k), pak(1:n), qmk(1:n), tice, rdry, rvap)
+        lnpi_dn(1:n) = lnp_up(1:n)
+      else
+        cmpr(1:n) = 1.0_kind_real
+      endif
+
+      if (k == 1) then
+        dz(1:n) = rog * tvk(1:n) * cmpr(1:n) * log(prsi(ib:ie,j,k+1)/prs(ib:ie,j,k))
+      else
+        dz(1:n) = rog * tvk(1:n) * cmpr(1:n) * log(prsi(ib:ie,j,k+1)/prsi(ib:ie,j,k))
+      endif
 
-   end do
-   end do
+      gphi(ib:ie,j,k) = gphi(ib:ie,j,k+1) + dz(1:n)
 
-end if
+    enddo
+
+  enddo
+enddo
+!$omp end parallel do
 
 end subroutine geop_height_levels
+
+! --------------------------------------------------------------------------------------------------
+! Tangent linear and adjoint of geop_height for the ideal gas form (use_compress = .false.), with
+! respect to temperature, specific humidity and the mid and interface pressures. The surface
+! geopotential is not perturbed.
+! --------------------------------------------------------------------------------------------------
+
+subroutine geop_height_tl(geom,prs,prsi,T,q,prs_tl,prsi_tl,T_tl,q_tl,gph_tl)
+
+implicit none
+type(fv3jedi_geom), intent(in ) :: geom
+real(kind_real),    intent(in ) :: prs    (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
+real(kind_real),    intent(in ) :: prsi   (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz+1)
+real(kind_real),    intent(in ) :: T      (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
+real(kind_real),    intent(in ) :: q      (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
+real(kind_real),    intent(in ) :: prs_tl (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
+real(kind_real),    intent(in ) :: prsi_tl(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz+1)
+real(kind_real),    intent(in ) :: T_tl   (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
+real(kind_real),    intent(in ) :: q_tl   (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
+real(kind_real),    intent(out) :: gph_tl (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
+
+!locals
+integer              :: isc,iec,jsc,jec,npz,i,j,k,ib,ie,n
+real(kind=kind_real) :: zvir, rog
+real(kind=kind_real) :: tv_dn(height_block), tv_k(height_block)
+real(kind=kind_real) :: tv_tl_dn(height_block), tv_tl_k(height_block)
+real(kind=kind_real) :: dz_tl(height_block)
+
+isc = geom%isc
+iec = geom%iec
+jsc = geom%jsc
+jec = geom%jec
+npz = geom%npz
+
+zvir = constant('zvir')
+rog  = constant('rdry')/constant('grav')
+
+!$omp parallel do num_threads(geom%nthreads) default(shared) collapse(2) &
+!$omp private(i,j,k,ib,ie,n,tv_dn,tv_k,tv_tl_dn,tv_tl_k,dz_tl)
+do j = jsc,jec
+  do ib = isc,iec,height_block
+
+    ie = min(ib+height_block-1,iec)
+    n = ie-ib+1
+
+    k = npz
+    call tv_and_tl(ib, ie, j, k, tv_k, tv_tl_k)
+    dz_tl(1:n) = rog * ( tv_tl_k(1:n) * log(prsi(ib:ie,j,k+1)/prs(ib:ie,j,k)) + &
+                         tv_k(1:n) * ( prsi_tl(ib:ie,j,k+1)/prsi(ib:ie,j,k+1) - &
+                                       prs_tl(ib:ie,j,k)/prs(ib:ie,j,k) ) )
+    gph_tl(ib:ie,j,k) = dz_tl(1:n)
+
+    do k = npz-1,1,-1
+      tv_dn(1:n) = tv_k(1:n)
+      tv_tl_dn(1:n) = tv_tl_k(1:n)
+      call tv_and_tl(ib, ie, j, k, tv_k, tv_tl_k)
+      dz_tl(1:n) = rog * 0.5_kind_real * &
+                   ( (tv_tl_dn(1:n)+tv_tl_k(1:n)) * log(prs(ib:ie,j,k+1)/prs(ib:ie,j,k)) + &
+                     (tv_dn(1:n)+tv_k(1:n)) * ( prs_tl(ib:ie,j,k+1)/prs(ib:ie,j,k+1) - &
+                                                prs_tl(ib:ie,j,k)/prs(ib:ie,j,k) ) )
+      gph_tl(ib:ie,j,k) = gph_tl(ib:ie,j,k+1) + dz_tl(1:n)
+    enddo
+
+  enddo
+enddo
+!$omp end parallel do
+
+contains
+
+  subroutine tv_and_tl(ib, ie, j, k, tv, tv_tl)
+    integer,              intent(in)  :: ib, ie, j, k
+    real(kind=kind_real), intent(out) :: tv(:), tv_tl(:)
+    integer :: i
+    real(kind=kind_real) :: qmr, qmr_tl
+    do i = ib,ie
+      qmr = q(i,j,k)/(1.0 - q(i,j,k))
+      qmr_tl = q_tl(i,j,k)/(1.0 - q(i,j,k))**2
+      tv(i-ib+1) = T(i,j,k)*(1.0 + zvir*qmr)
+      tv_tl(i-ib+1) = T_tl(i,j,k)*(1.0 + zvir*qmr) + T(i,j,k)*zvir*qmr_tl
+    enddo
+  end subroutine tv_and_tl
+
+end subroutine geop_height_tl
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine geop_height_ad(geom,prs,prsi,T,q,prs_ad,prsi_ad,T_ad,q_ad,gph_ad)
+
+implicit none
+type(fv3jedi_geom), intent(in   ) :: geom
+real(kind_real),    intent(in   ) :: prs    (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
+real(kind_real),    intent(in   ) :: prsi   (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz+1)
+real(kind_real),    intent(in   ) :: T      (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
+real(kind_real),    intent(in   ) :: q      (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
+real(kind_real),    intent(inout) :: prs_ad (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
+real(kind_real),    intent(inout) :: prsi_ad(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz+1)
+real(kind_real),    intent(inout) :: T_ad   (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
+real(kind_real),    intent(inout) :: q_ad   (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
+real(kind_real),    intent(inout) :: gph_ad (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
+
+!locals
+integer              :: isc,iec,jsc,jec,npz,i,j,k,ib,ie,n
+real(kind=kind_real) :: zvir, rog
+real(kind=kind_real) :: dz_ad(height_block)    !Running sum of gph_ad from the top down
+real(kind=kind_real) :: tv_ad_up(height_block) !Virtual temperature adjoint from the layer above
+real(kind=kind_real) :: tv_ad(height_block), tvav(height_block), rl(height_block)
+
+isc = geom%isc
+iec = geom%iec
+jsc = geom%jsc
+jec = geom%jec
+npz = geom%npz
+
+zvir = constant('zvir')
+rog  = constant('rdry')/constant('grav')
+
+!$omp parallel do num_threads(geom%nthreads) default(shared) collapse(2) &
+!$omp private(i,j,k,ib,ie,n,dz_ad,tv_ad_up,tv_ad,tvav,rl)
+do j = jsc,jec
+  do ib = isc,iec,height_block
+
+    ie = min(ib+height_block-1,iec)
+    n = ie-ib+1
+
+    dz_ad(1:n) = 0.0_kind_real
+    tv_ad_up(1:n) = 0.0_kind_real
+
+    do k = 1,npz
+
+      ! gph(k) is the sum of dz from level k down to the surface
+      dz_ad(1:n) = dz_ad(1:n) + gph_ad(ib:ie,j,k)
+      gph_ad(ib:ie,j,k) = 0.0_kind_real
+
+      if (k < npz) then
+        ! dz(k) = rog * 0.5 * (tv(k+1) + tv(k)) * log(prs(k+1)/prs(k))
+        tvav(1:n) = 0.5_kind_real * (tv_of(ib, ie, j, k+1) + tv_of(ib, ie, j, k))
+        rl(1:n) = rog * 0.5_kind_real * log(prs(ib:ie,j,k+1)/prs(ib:ie,j,k)) * dz_ad(1:n)
+        prs_ad(ib:ie,j,k+1) = prs_ad(ib:ie,j,k+1) + rog * tvav(1:n) / prs(ib:ie,j,k+1) * dz_ad(1:n)
+        prs_ad(ib:ie,j,k  ) = prs_ad(ib:ie,j,k  ) - rog * tvav(1:n) / prs(ib:ie,j,k  ) * dz_ad(1:n)
+        tv_ad(1:n) = tv_ad_up(1:n) + rl(1:n)
+        tv_ad_up(1:n) = rl(1:n)
+      else
+        ! dz(npz) = rog * tv(npz) * log(prsi(npz+1)/prs(npz))
+        tvav(1:n) = tv_of(ib, ie, j, k)
+        rl(1:n) = rog * log(prsi(ib:ie,j,k+1)/prs(ib:ie,j,k)) * dz_ad(1:n)
+        prsi_ad(ib:ie,j,k+1) = prsi_ad(ib:ie,j,k+1) + rog * tvav(1:n) / prsi(ib:ie,j,k+1) * dz_ad(1:n)
+        prs_ad (ib:ie,j,k  ) = prs_ad (ib:ie,j,k  ) - rog * tvav(1:n) / prs (ib:ie,j,k  ) * dz_ad(1:n)
+        tv_ad(1:n) = tv_ad_up(1:n) + rl(1:n)
+      endif
+
+      ! tv = T * (1 + zvir * q/(1-q))
+      do i = ib,ie
+        T_ad(i,j,k) = T_ad(i,j,k) + tv_ad(i-ib+1) * (1.0 + zvir*q(i,j,k)/(1.0 - q(i,j,k)))
+        q_ad(i,j,k) = q_ad(i,j,k) + tv_ad(i-ib+1) * T(i,j,k)*zvir/(1.0 - q(i,j,k))**2
+      enddo
+
+    enddo
+
+  enddo
+enddo
+!$omp end parallel do
+
+contains
+
+  function tv_of(ib, ie, j, k) result(tv)
+    integer, intent(in)  :: ib, ie, j, k
+    real(kind=kind_real) :: tv(ie-ib+1)
+    tv = T(ib:ie,j,k)*(1.0 + zvir*q(ib:ie,j,k)/(1.0 - q(ib:ie,j,k)))
+  end function tv_of
+
+end subroutine geop_height_ad
+
+! --------------------------------------------------------------------------------------------------
+
 end module height_vt_mod
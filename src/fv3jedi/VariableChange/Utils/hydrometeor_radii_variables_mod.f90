@@ -37,13 +37,18 @@ module radii_vt_mod
       !..Any hydrometeor with less than min_qx is ignored as zero cloud/precip.
       real(kind=kind_real), parameter :: min_qx = 1.0E-8_kind_real
 
+      !..Effective radii methods
+      integer, parameter :: method_none = 0
+      integer, parameter :: method_thompson = 1
+      integer, parameter :: method_gfdl = 2
+      integer, parameter :: method_gsi = 3
+
       !..A user can override the spherical water drops using
       !.. auxillary variables that are optionally passed into functions
       !.. where they are called a_mass, b_mass, and mu_x.
       real, parameter, private:: am_x = PI * 1000./6.   ! Spherical water drops
       real, parameter, private:: bm_x = 3.
       integer, parameter, private:: nu_x = 0            ! Inverse exponential
-      double precision:: intercept, lambda
 
       !..A pretty good approximation of ice crystal size as a function of
       !.. temperature from -94 to 0C by Jon Egill Kristjansson and coauthors.
@@ -111,15 +116,12 @@ character(len=*):: method              ! Method for radii calculation (thompson,
 character(len=*), optional:: use_mask  ! Set to land or sea to mask either one, otherwise no mask
 
 !Locals
-integer :: isc,iec,jsc,jec,npz,i,j,k
-logical, allocatable :: seamask(:,:,:)
-real(kind=kind_real) :: tem1, tem2, kgkg_to_kgm2, xqq
+integer :: isc,iec,jsc,jec,npz,j,k
+integer :: imethod
+logical :: seamask(geom%isc:geom%iec)
 logical :: have_qr, have_qs, have_qg, have_nc, have_ni, have_nr, have_ns, have_ng
 logical :: mask_land, mask_sea
-real :: tempK, wcontent, nconc, answer, ygra1, zans1
-integer :: mu, idx_rei
-real(kind=kind_real), allocatable :: rho_air(:,:,:)
-real, allocatable :: nnc(:,:,:), nnr(:,:,:), nng(:,:,:)
+real(kind=kind_real) :: rho_air(geom%isc:geom%iec)
 real(kind=kind_real) :: rdry, grav, tice, zvir
 !+---+
 
@@ -178,66 +180,82 @@ jsc = geom%jsc
 jec = geom%jec
 npz = geom%npz
 
-! Allocate some convenient arrays
-! -------------------------------
-allocate(seamask(isc:iec,jsc:jec,1:npz))  ! 2-D really, but 3-D is convenient for where statement
-allocate(rho_air(isc:iec,jsc:jec,1:npz))
-
-
-! Set outputs to zero
-! -------------------
-ql_ade = 0.0_kind_real
-qi_ade = 0.0_kind_real
-ql_efr = 0.0_kind_real
-qi_efr = 0.0_kind_real
-if(have_qr) then
-  qr_ade = 0.0_kind_real
-  qr_efr = 0.0_kind_real
-endif
-if(have_qs) then
-  qs_ade = 0.0_kind_real
-  qs_efr = 0.0_kind_real
-endif
-if(have_qg) then
-  qg_ade = 0.0_kind_real
-  qg_efr = 0.0_kind_real
+! Method, fixed for the whole call
+! --------------------------------
+if (method .eq. 'thompson') then
+  imethod = method_thompson
+  if (geom%f_comm%rank() == 0 ) then
+    debug_msg = 'DEBUG,  using Thompson method for radii calculations'
+    call fckit_log%debug(debug_msg)
+  endif
+elseif (method .eq. 'gfdl') then
+  imethod = method_gfdl
+  if (geom%f_comm%rank() == 0 ) then
+    debug_msg = 'DEBUG,  using GFDL method for radii calculations'
+    call fckit_log%debug(debug_msg)
+  endif
+elseif (method .eq. 'gsi') then
+  imethod = method_gsi
+  if (geom%f_comm%rank() == 0 ) then
+    debug_msg = 'DEBUG,  using GSI method for radii calculations'
+    call fckit_log%debug(debug_msg)
+  endif
+else
+  imethod = method_none
+  if (geom%f_comm%rank() == 0 ) then
+    debug_msg = 'WARNING, hydrometeor effective radii method must be one of: gfdl, thompson, gsi'
+    call fckit_log%debug(debug_msg)
+  endif
 endif
 
-! Sea mask
-! --------
-seamask = .false.
-do j = jsc,jec
-  do i = isc,iec
-     seamask(i,j,:) = min(max(0.0_kind_real,sea_frac(i,j)),1.0_kind_real)  >= 0.99_kind_real
-  enddo
-enddo
-
-! Calculate air density
-! ---------------------
+! Rows of points at one level are independent. Air density and the sea mask are only ever needed
+! for the current row so the scratch space is two row-length vectors per thread.
+! ------------------------------------------------------------------------------------------------
+!$omp parallel do num_threads(geom%nthreads) default(shared) collapse(2) private(j,k,rho_air,seamask)
 do k = 1,npz
-   do j = jsc,jec
-     do i = isc,iec
-        rho_air(i,j,k) = p(i,j,k)/(rdry*t(i,j,k)* (1.0_kind_real + zvir * max(q(i,j,k),0.0_kind_real)))
-     enddo
-   enddo
+  do j = jsc,jec
+
+    ! Air density and sea mask
+    rho_air = p(:,j,k)/(rdry*t(:,j,k)* (1.0_kind_real + zvir * max(q(:,j,k),0.0_kind_real)))
+    seamask = min(max(0.0_kind_real,sea_frac(:,j)),1.0_kind_real) >= 0.99_kind_real
+
+    ! Hydrometeor mixing ratio to liquid/ice water path (kg/kg to kg/m^2)
+    ql_ade(:,j,k) = water_path(ql(:,j,k), delp(:,j,k), grav)
+    qi_ade(:,j,k) = water_path(qi(:,j,k), delp(:,j,k), grav)
+    if (have_qr) qr_ade(:,j,k) = water_path(qr(:,j,k), delp(:,j,k), grav)
+    if (have_qs) qs_ade(:,j,k) = water_path(qs(:,j,k), delp(:,j,k), grav)
+    if (have_qg) qg_ade(:,j,k) = water_path(qg(:,j,k), delp(:,j,k), grav)
+
+    ! Effective radii
+    select case (imethod)
+    case (method_thompson)
+      call thompson_row(j, k, rho_air, seamask)
+    case (method_gfdl)
+      call gfdl_row(j, k, rho_air)
+    case (method_gsi)
+      call gsi_row(j, k, rho_air)
+    case default
+      ql_efr(:,j,k) = 0.0_kind_real
+      qi_efr(:,j,k) = 0.0_kind_real
+      if (have_qr) qr_efr(:,j,k) = 0.0_kind_real
+      if (have_qs) qs_efr(:,j,k) = 0.0_kind_real
+      if (have_qg) qg_efr(:,j,k) = 0.0_kind_real
+    end select
+
+    ! If a land/sea mask is desired, just zero out water/ice path variables.
+    if (mask_land) then
+      call zero_where(.not. seamask, j, k)
+    elseif (mask_sea) then
+      call zero_where(seamask, j, k)
+    endif
+
+  enddo
 enddo
+!$omp end parallel do
 
-! Convert hydrometeor mixing ratio to liquid/ice water path (kg/kg to kg/m^2)
-! ---------------------------------------------------------------------------
-call hydro_mixr_to_wpath(geom,ql,delp,ql_ade)
-call hydro_mixr_to_wpath(geom,qi,delp,qi_ade)
-if( have_qr ) then
-  call hydro_mixr_to_wpath(geom,qr,delp,qr_ade)
-endif
-if( have_qs ) then
-  call hydro_mixr_to_wpath(geom,qs,delp,qs_ade)
-endif
-if( have_qg ) then
-  call hydro_mixr_to_wpath(geom,qg,delp,qg_ade)
-endif
+contains
 
-! Compute effective radius using various methods.
-! -----------------------------------------------
+! --------------------------------------------------------------------------------------------------
 
 !..The Thompson method follows Thompson and Eidhammer (2014), Thompson et al (2008, 2004).
 !.. This method is based on Slingo (1989) that relates the radiative effective radius
@@ -249,137 +267,99 @@ endif
 !.. variables, it is not true to the scheme, but we make a few assumptions to estimate
 !.. particle number before computing size.
 
-if (method .eq. 'thompson') then
-  if (geom%f_comm%rank() == 0 ) then
-    debug_msg = 'DEBUG,  using Thompson method for radii calculations'
-    call fckit_log%debug(debug_msg)
-  endif
-  allocate(nnc(isc:iec,jsc:jec,1:npz))
-  if (.not. have_nc) then
-    where (seamask)
-      nnc = 75.E6        ! 75 drops per cc over ocean
-    elsewhere
-      nnc = 250.E6       ! 250 drops per cc over land
-    end where
+subroutine thompson_row(j, k, rho_air, seamask)
+
+integer,              intent(in) :: j, k
+real(kind=kind_real), intent(in) :: rho_air(isc:iec)
+logical,              intent(in) :: seamask(isc:iec)
+
+integer :: i, mu, idx_rei
+real :: wcontent, nconc, nnx, answer, ygra1, zans1
+
+ql_efr(:,j,k) = 0.0_kind_real
+do i = isc,iec
+  if (ql(i,j,k) .lt. min_qx) CYCLE
+  if (have_nc) then
+    nnx = nc(i,j,k)
+  elseif (seamask(i)) then
+    nnx = 75.E6        ! 75 drops per cc over ocean
   else
-    nnc = nc
+    nnx = 250.E6       ! 250 drops per cc over land
   endif
-  do k = 1,npz
-    do j = jsc,jec
-      do i = isc,iec
-        if (ql(i,j,k) .lt. min_qx) CYCLE
-        wcontent = ql(i,j,k)*rho_air(i,j,k)
-        nconc    = nnc(i,j,k)*rho_air(i,j,k)
-        mu = MAX(2, MIN((NINT(1000.E6/nconc) + 2), 15))
-        answer = effectiveRadius(rx=wcontent, nx=nconc, mu=mu)
-        ql_efr(i,j,k) = max(2.0_kind_real, min(answer*1.0E6_kind_real, 25.0_kind_real))
-      enddo
-    enddo
+  wcontent = ql(i,j,k)*rho_air(i)
+  nconc    = nnx*rho_air(i)
+  mu = MAX(2, MIN((NINT(1000.E6/nconc) + 2), 15))
+  answer = effectiveRadius(rx=wcontent, nx=nconc, mu=mu)
+  ql_efr(i,j,k) = max(2.0_kind_real, min(answer*1.0E6_kind_real, 25.0_kind_real))
+enddo
+
+if (.not. have_ni) then
+  do i = isc,iec
+    idx_rei = min(max(int(t(i,j,k)-179._kind_real),1),94)
+    qi_efr(i,j,k) = merge(retab(idx_rei)*1.0_kind_real, 0.0_kind_real, qi(i,j,k) >= min_qx)
   enddo
-  deallocate(nnc)
-
-  if (.not. have_ni) then
-    do k = 1,npz
-      do j = jsc,jec
-        do i = isc,iec
-          if (qi(i,j,k) .lt. min_qx) CYCLE
-          idx_rei = int(t(i,j,k)-179._kind_real)
-          idx_rei = min(max(idx_rei,1),94)
-          qi_efr(i,j,k) = retab(idx_rei)*1.0_kind_real
-        enddo
-      enddo
-    enddo
-  else
-    do k = 1,npz
-      do j = jsc,jec
-        do i = isc,iec
-          if (qi(i,j,k) .lt. min_qx) CYCLE
-          wcontent = qi(i,j,k)*rho_air(i,j,k)
-          nconc    = ni(i,j,k)*rho_air(i,j,k)
-          answer = effectiveRadius(rx=wcontent, nx=nconc)
-          qi_efr(i,j,k) = max(2.5_kind_real, min(answer*1.0E6_kind_real, 250.0_kind_real))
-        enddo
-      enddo
-    enddo
-  endif
+else
+  qi_efr(:,j,k) = 0.0_kind_real
+  do i = isc,iec
+    if (qi(i,j,k) .lt. min_qx) CYCLE
+    wcontent = qi(i,j,k)*rho_air(i)
+    nconc    = ni(i,j,k)*rho_air(i)
+    answer = effectiveRadius(rx=wcontent, nx=nconc)
+    qi_efr(i,j,k) = max(2.5_kind_real, min(answer*1.0E6_kind_real, 250.0_kind_real))
+  enddo
+endif
 
-  if (have_qr) then
-    allocate(nnr(isc:iec,jsc:jec,1:npz))
-    if (.not. have_nr) then
-      do k = 1,npz
-        do j = jsc,jec
-          do i = isc,iec
-            if (qr(i,j,k) .lt. min_qx) CYCLE
-            wcontent = qr(i,j,k)*rho_air(i,j,k)
-            nnr(i,j,k) = calculateNumber(rx=wcontent, N0_exp=8.E6)/rho_air(i,j,k)
-          enddo
-        enddo
-      enddo
+if (have_qr) then
+  qr_efr(:,j,k) = 0.0_kind_real
+  do i = isc,iec
+    if (qr(i,j,k) .lt. min_qx) CYCLE
+    wcontent = qr(i,j,k)*rho_air(i)
+    if (have_nr) then
+      nnx = nr(i,j,k)
     else
-      nnr = nr
+      nnx = calculateNumber(rx=wcontent, N0_exp=8.E6)/rho_air(i)
     endif
-    do k = 1,npz
-      do j = jsc,jec
-        do i = isc,iec
-          if (qr(i,j,k) .lt. min_qx) CYCLE
-          wcontent = qr(i,j,k)*rho_air(i,j,k)
-          nconc    = nnr(i,j,k)*rho_air(i,j,k)
-          answer = effectiveRadius(rx=wcontent, nx=nconc)
-          qr_efr(i,j,k) = max(50.0_kind_real, min(answer*1.0E6_kind_real, 1000.0_kind_real))
-        enddo
-      enddo
-    enddo
-    if (assume_microwave) qr_efr = qr_efr*2.0_kind_real
-    deallocate(nnr)
-  endif
+    nconc    = nnx*rho_air(i)
+    answer = effectiveRadius(rx=wcontent, nx=nconc)
+    qr_efr(i,j,k) = max(50.0_kind_real, min(answer*1.0E6_kind_real, 1000.0_kind_real))
+  enddo
+  if (assume_microwave) qr_efr(:,j,k) = qr_efr(:,j,k)*2.0_kind_real
+endif
 
-  if (have_qs) then
-    do k = 1,npz
-      do j = jsc,jec
-        do i = isc,iec
-          if (qs(i,j,k) .lt. min_qx) CYCLE
-          wcontent = qs(i,j,k)*rho_air(i,j,k)
-          tempK = t(i,j,k)
-          answer = thompson08_snow(rs=wcontent, temp=tempK)
-          qs_efr(i,j,k) = max(5.0_kind_real, min(answer*1.0E6_kind_real, 5000.0_kind_real))
-        enddo
-      enddo
-    enddo
-    if (assume_microwave) qs_efr = qs_efr*2.0_kind_real
-  endif
+if (have_qs) then
+  qs_efr(:,j,k) = 0.0_kind_real
+  do i = isc,iec
+    if (qs(i,j,k) .lt. min_qx) CYCLE
+    wcontent = qs(i,j,k)*rho_air(i)
+    answer = thompson08_snow(rs=wcontent, temp=real(t(i,j,k)))
+    qs_efr(i,j,k) = max(5.0_kind_real, min(answer*1.0E6_kind_real, 5000.0_kind_real))
+  enddo
+  if (assume_microwave) qs_efr(:,j,k) = qs_efr(:,j,k)*2.0_kind_real
+endif
 
-  if (have_qg) then
-    allocate(nng(isc:iec,jsc:jec,1:npz))
-    if (.not. have_ng) then
-      do k = 1,npz
-        do j = jsc,jec
-          do i = isc,iec
-            if (qg(i,j,k) .lt. min_qx) CYCLE
-            wcontent = qg(i,j,k)*rho_air(i,j,k)
-            ygra1 = alog10(max(1.E-9, wcontent))
-            zans1 = (3.4 + 2./7. * (ygra1+8.))
-            zans1 = MAX(2., MIN(zans1, 7.))
-            nng(i,j,k) = calculateNumber(rx=wcontent, N0_exp=10.**(zans1))/rho_air(i,j,k)
-          enddo
-        enddo
-      enddo
+if (have_qg) then
+  qg_efr(:,j,k) = 0.0_kind_real
+  do i = isc,iec
+    if (qg(i,j,k) .lt. min_qx) CYCLE
+    wcontent = qg(i,j,k)*rho_air(i)
+    if (have_ng) then
+      nnx = ng(i,j,k)
     else
-      nng = ng
+      ygra1 = alog10(max(1.E-9, wcontent))
+      zans1 = (3.4 + 2./7. * (ygra1+8.))
+      zans1 = MAX(2., MIN(zans1, 7.))
+      nnx = calculateNumber(rx=wcontent, N0_exp=10.**(zans1))/rho_air(i)
     endif
-    do k = 1,npz
-      do j = jsc,jec
-        do i = isc,iec
-          if (qg(i,j,k) .lt. min_qx) CYCLE
-          wcontent = qg(i,j,k)*rho_air(i,j,k)
-          nconc    = nng(i,j,k)*rho_air(i,j,k)
-          answer = effectiveRadius(rx=wcontent, nx=nconc)
-          qg_efr(i,j,k) = max(150.0_kind_real, min(answer*1.0E6_kind_real, 5000.0_kind_real))
-        enddo
-      enddo
-    enddo
-    if (assume_microwave) qg_efr = qg_efr*2.0_kind_real
-    deallocate(nng)
-  endif
+    nconc    = nnx*rho_air(i)
+    answer = effectiveRadius(rx=wcontent, nx=nconc)
+    qg_efr(i,j,k) = max(150.0_kind_real, min(answer*1.0E6_kind_real, 5000.0_kind_real))
+  enddo
+  if (assume_microwave) qg_efr(:,j,k) = qg_efr(:,j,k)*2.0_kind_real
+endif
+
+end subroutine thompson_row
+
+! --------------------------------------------------------------------------------------------------
 
 !..GFDL basically has one-moment rain, snow, and graupel with constant intercept
 !.. parameters. Their final calculator of size involves strange factors that
@@ -392,221 +372,209 @@ if (method .eq. 'thompson') then
 !.  e) cloud ice: completely lacking traditional 3rd/2nd moment calculator and
 !.   is based on temperature and ice mixing ratio only.
 
-elseif (method .eq. 'gfdl') then
+subroutine gfdl_row(j, k, rho_air)
 
-  if (geom%f_comm%rank() == 0 ) then
-    debug_msg = 'DEBUG,  using GFDL method for radii calculations'
-    call fckit_log%debug(debug_msg)
-  endif
-  do k = 1,npz
-    do j = jsc,jec
-      do i = isc,iec
-        if (ql(i,j,k) .lt. min_qx) CYCLE
-        wcontent = ql(i,j,k)*rho_air(i,j,k)
-        nconc    = 100.E6
-        answer = exp(1./3. * log((3*wcontent)/(4.*PI*1000.*nconc)))
-        ql_efr(i,j,k) = max(2.0_kind_real, min(answer*1.0E6_kind_real, 25.0_kind_real))
-      enddo
-    enddo
+integer,              intent(in) :: j, k
+real(kind=kind_real), intent(in) :: rho_air(isc:iec)
+
+integer :: i
+real :: wcontent, nconc, answer
+
+! Cloud water and ice are closed form so are evaluated for the whole row and masked
+ql_efr(:,j,k) = merge(gfdl_ql_efr(ql(:,j,k), rho_air), 0.0_kind_real, ql(:,j,k) >= min_qx)
+qi_efr(:,j,k) = merge(gfdl_qi_efr(qi(:,j,k), rho_air, t(:,j,k)-tice), 0.0_kind_real, &
+                      qi(:,j,k) >= min_qx)
+
+if (have_qr) then
+  qr_efr(:,j,k) = 0.0_kind_real
+  do i = isc,iec
+    if (qr(i,j,k) .lt. min_qx) CYCLE
+    wcontent = qr(i,j,k)*rho_air(i)
+    nconc = calculateNumber(rx=wcontent, N0_exp=8.E6)
+    answer = effectiveRadius(rx=wcontent, nx=nconc)
+    answer = 3.9038/3.0 * answer    ! Adjust for exact match to GFDL scheme.
+    qr_efr(i,j,k) = max(50.0_kind_real, min(answer*1.0E6_kind_real, 1000.0_kind_real))
   enddo
+endif
 
-  do k = 1,npz
-    do j = jsc,jec
-      do i = isc,iec
-        if (qi(i,j,k) .lt. min_qx) CYCLE
-        wcontent = qi(i,j,k)*rho_air(i,j,k)
-        if (t(i,j,k)-tice .lt. -50) then
-          answer  = 1.22/9.917 * exp((1 - 0.891) * log(1.0e3*wcontent))*1.0e-3
-        elseif (t(i,j,k)-tice .lt. -40) then
-          answer  = 1.22/9.337 * exp((1 - 0.920) * log(1.0e3*wcontent))*1.0e-3
-        elseif (t(i,j,k)-tice .lt. -30) then
-          answer  = 1.22/9.208 * exp((1 - 0.945) * log(1.0e3*wcontent))*1.0e-3
-        else
-          answer  = 1.22/9.387 * exp((1 - 0.969) * log(1.0e3*wcontent))*1.0e-3
-        endif
-        qi_efr(i,j,k) = max(2.0_kind_real, min(answer*1.0E6_kind_real, 250.0_kind_real))
-      enddo
-    enddo
+if (have_qs) then
+  qs_efr(:,j,k) = 0.0_kind_real
+  do i = isc,iec
+    if (qs(i,j,k) .lt. min_qx) CYCLE
+    wcontent = qs(i,j,k)*rho_air(i)
+    nconc =  calculateNumber(rx=wcontent, N0_exp=2.E6)
+    answer = effectiveRadius(rx=wcontent, nx=nconc, a=PI*100./6., b=3.0)
+    answer = 3.6356/3.0 * answer    ! Adjust for exact match to GFDL scheme.
+    qs_efr(i,j,k) = max(10.0_kind_real, min(answer*1.0E6_kind_real, 2000.0_kind_real))
   enddo
+endif
 
-  if (have_qr) then
-    do k = 1,npz
-      do j = jsc,jec
-        do i = isc,iec
-          if (qr(i,j,k) .lt. min_qx) CYCLE
-          wcontent = qr(i,j,k)*rho_air(i,j,k)
-          nconc = calculateNumber(rx=wcontent, N0_exp=8.E6)
-          answer = effectiveRadius(rx=wcontent, nx=nconc)
-          answer = 3.9038/3.0 * answer    ! Adjust for exact match to GFDL scheme.
-          qr_efr(i,j,k) = max(50.0_kind_real, min(answer*1.0E6_kind_real, 1000.0_kind_real))
-        enddo
-      enddo
-    enddo
-  endif
+if (have_qg) then
+  qg_efr(:,j,k) = 0.0_kind_real
+  do i = isc,iec
+    if (qg(i,j,k) .lt. min_qx) CYCLE
+    wcontent = qg(i,j,k)*rho_air(i)
+    nconc =  calculateNumber(rx=wcontent, N0_exp=4.E6)
+    answer = effectiveRadius(rx=wcontent, nx=nconc, a=PI*500./6., b=3.0)
+    answer = 3.7583/3.0 * answer    ! Adjust for exact match to GFDL scheme.
+    qg_efr(i,j,k) = max(50.0_kind_real, min(answer*1.0E6_kind_real, 5000.0_kind_real))
+  enddo
+endif
 
-  if (have_qs) then
-    do k = 1,npz
-      do j = jsc,jec
-        do i = isc,iec
-          if (qs(i,j,k) .lt. min_qx) CYCLE
-          wcontent = qs(i,j,k)*rho_air(i,j,k)
-          nconc =  calculateNumber(rx=wcontent, N0_exp=2.E6)
-          answer = effectiveRadius(rx=wcontent, nx=nconc, a=PI*100./6., b=3.0)
-          answer = 3.6356/3.0 * answer    ! Adjust for exact match to GFDL scheme.
-          qs_efr(i,j,k) = max(10.0_kind_real, min(answer*1.0E6_kind_real, 2000.0_kind_real))
-        enddo
-      enddo
-    enddo
-  endif
+end subroutine gfdl_row
 
-  if (have_qg) then
-    do k = 1,npz
-      do j = jsc,jec
-        do i = isc,iec
-          if (qg(i,j,k) .lt. min_qx) CYCLE
-          wcontent = qg(i,j,k)*rho_air(i,j,k)
-          nconc =  calculateNumber(rx=wcontent, N0_exp=4.E6)
-          answer = effectiveRadius(rx=wcontent, nx=nconc, a=PI*500./6., b=3.0)
-          answer = 3.7583/3.0 * answer    ! Adjust for exact match to GFDL scheme.
-          qg_efr(i,j,k) = max(50.0_kind_real, min(answer*1.0E6_kind_real, 5000.0_kind_real))
-        enddo
-      enddo
-    enddo
-  endif
+! --------------------------------------------------------------------------------------------------
 
-elseif (method .eq. 'gsi') then
+subroutine gsi_row(j, k, rho_air)
 
-  if (geom%f_comm%rank() == 0 ) then
-    debug_msg = 'DEBUG,  using GSI method for radii calculations'
-    call fckit_log%debug(debug_msg)
-  endif
-  ! Cloud liquid water effective radius
-  ! -----------------------------------
-  do k = 1,npz
-    do j = jsc,jec
-      do i = isc,iec
-        if (ql(i,j,k) .lt. min_qx) CYCLE
-        tem1 = (tice-t(i,j,k))*0.05_kind_real
-        ql_efr(i,j,k) = 5.0_kind_real + 5.0_kind_real * min(1.0_kind_real, tem1)
-        ql_efr(i,j,k) = max(1.0_kind_real,ql_efr(i,j,k))
-      enddo
-    enddo
-  enddo
+integer,              intent(in) :: j, k
+real(kind=kind_real), intent(in) :: rho_air(isc:iec)
 
-  ! Cloud ice water effective radius
-  ! ---------------------------------
-  do k = 1,npz
-    do j = jsc,jec
-      do i = isc,iec
-        if (qi(i,j,k) .lt. min_qx) CYCLE
-        tem2 = t(i,j,k) - tice
-        wcontent = qi(i,j,k)*rho_air(i,j,k)
-        if (tem2 < -50.0_kind_real ) then
-           qi_efr(i,j,k) =  (1250._kind_real/9.917_kind_real)*wcontent**0.109_kind_real
-        elseif (tem2 < -40.0_kind_real ) then
-           qi_efr(i,j,k) =  (1250._kind_real/9.337_kind_real)*wcontent**0.08_kind_real
-        elseif (tem2 < -30.0_kind_real ) then
-           qi_efr(i,j,k) =  (1250._kind_real/9.208_kind_real)*wcontent**0.055_kind_real
-        else
-           qi_efr(i,j,k) =  (1250._kind_real/9.387_kind_real)*wcontent**0.031_kind_real
-        endif
-        qi_efr(i,j,k) = max(5.0_kind_real,qi_efr(i,j,k))
-      enddo
-    enddo
-  enddo
+! Cloud liquid water and cloud ice effective radius
+ql_efr(:,j,k) = merge(gsi_ql_efr(t(:,j,k)-tice), 0.0_kind_real, ql(:,j,k) >= min_qx)
+qi_efr(:,j,k) = merge(gsi_qi_efr(qi(:,j,k), rho_air, t(:,j,k)-tice), 0.0_kind_real, &
+                      qi(:,j,k) >= min_qx)
 
-  ! Rain water effective radius (Taken from set_crtm_cloudmod.f90 in GSI for GEOS qr & qs .)
-  ! ---------------------------------
-  if( have_qr ) then
-    do k = 1,npz
-      do j = jsc,jec
-        do i = isc,iec
-          if (qr(i,j,k) .lt. min_qx) CYCLE
-          wcontent = 1000.0_kind_real * qr(i,j,k)*rho_air(i,j,k)
-          xqq = log10(wcontent)
-          qr_efr(i,j,k) = 7.934_kind_real*xqq*xqq*xqq + 90.858_kind_real*xqq*xqq &
-                        + 387.807_kind_real*xqq + 679.939_kind_real
-          qr_efr(i,j,k) = max(qr_efr(i,j,k), 100.0_kind_real)
-        enddo
-      enddo
-    enddo
-  endif
+! Rain and snow effective radius (Taken from set_crtm_cloudmod.f90 in GSI for GEOS qr & qs.)
+if (have_qr) qr_efr(:,j,k) = merge(gsi_precip_efr(qr(:,j,k), rho_air, &
+                                                  7.934_kind_real, 90.858_kind_real, &
+                                                  387.807_kind_real, 679.939_kind_real), &
+                                   0.0_kind_real, qr(:,j,k) >= min_qx)
+if (have_qs) qs_efr(:,j,k) = merge(gsi_precip_efr(qs(:,j,k), rho_air, &
+                                                  9.33_kind_real, 84.779_kind_real, &
+                                                  351.1345_kind_real, 691.391_kind_real), & !Liu DDA_type5
+                                   0.0_kind_real, qs(:,j,k) >= min_qx)
+if (have_qg) qg_efr(:,j,k) = 0.0_kind_real
 
-  ! Snow water effective radius (Taken from set_crtm_cloudmod.f90 in GSI for GEOS qr & qs.)
-  ! ---------------------------------
-  if( have_qs ) then
-    do k = 1,npz
-      do j = jsc,jec
-        do i = isc,iec
-          if (qs(i,j,k) .lt. min_qx) CYCLE
-          wcontent = 1000.0_kind_real * qs(i,j,k)*rho_air(i,j,k)
-          xqq = log10(wcontent)
-          qs_efr(i,j,k) = 9.33_kind_real*xqq*xqq*xqq +  84.779_kind_real*xqq*xqq &
-                        + 351.1345_kind_real*xqq + 691.391_kind_real !Liu DDA_type5
-          qs_efr(i,j,k) = max(qs_efr(i,j,k), 100.0_kind_real)
-        enddo
-      enddo
-    enddo
-  endif
+end subroutine gsi_row
 
-else
+! --------------------------------------------------------------------------------------------------
 
-  if (geom%f_comm%rank() == 0 ) then
-    debug_msg = 'WARNING, hydrometeor effective radii method must be one of: gfdl, thompson, gsi'
-    call fckit_log%debug(debug_msg)
-  endif
+subroutine zero_where(mask, j, k)
 
-endif
+logical, intent(in) :: mask(isc:iec)
+integer, intent(in) :: j, k
 
-! If a land/sea mask is desired, just zero out water/ice path variables.
-! ----------------------------------------------------------------------
-if (mask_land) then
-   where (.not. seamask)
-      ql_ade = 0.0_kind_real
-      qi_ade = 0.0_kind_real
-   end where
-   if (have_qr) then
-      where (.not. seamask)
-         qr_ade = 0.0_kind_real
-      end where
-   endif
-   if (have_qs) then
-      where (.not. seamask)
-         qs_ade = 0.0_kind_real
-      end where
-   endif
-   if (have_qg) then
-      where (.not. seamask)
-         qg_ade = 0.0_kind_real
-      end where
-   endif
-elseif (mask_sea) then
-   where (seamask)
-      ql_ade = 0.0_kind_real
-      qi_ade = 0.0_kind_real
-   end where
-   if (have_qr) then
-      where (seamask)
-         qr_ade = 0.0_kind_real
-      end where
-   endif
-   if (have_qs) then
-      where (seamask)
-         qs_ade = 0.0_kind_real
-      end where
-   endif
-   if (have_qg) then
-      where (seamask)
-         qg_ade = 0.0_kind_real
-      end where
-   endif
+where (mask)
+  ql_ade(:,j,k) = 0.0_kind_real
+  qi_ade(:,j,k) = 0.0_kind_real
+end where
+if (have_qr) then
+  where (mask) qr_ade(:,j,k) = 0.0_kind_real
 endif
+if (have_qs) then
+  where (mask) qs_ade(:,j,k) = 0.0_kind_real
+endif
+if (have_qg) then
+  where (mask) qg_ade(:,j,k) = 0.0_kind_real
+endif
+
+end subroutine zero_where
 
-deallocate(seamask)
-deallocate(rho_air)
+! --------------------------------------------------------------------------------------------------
 
 end subroutine crtm_ade_efr
 
+! --------------------------------------------------------------------------------------------------
+! Closed form per-point kernels. Arguments are clamped to min_qx so that points later masked out
+! by the caller never take the log of a non-positive number. The GFDL and GSI formulae keep the
+! default real intermediates of the schemes they reproduce.
+! --------------------------------------------------------------------------------------------------
+
+elemental function water_path(qmx, delp, grav) result(qwp)
+
+real(kind=kind_real), intent(in) :: qmx, delp, grav
+real(kind=kind_real) :: qwp
+
+qwp = merge(qmx * (delp / grav), 0.0_kind_real, qmx >= min_qx)
+
+end function water_path
+
+! --------------------------------------------------------------------------------------------------
+
+elemental function gfdl_ql_efr(ql, rho_air) result(efr)
+
+real(kind=kind_real), intent(in) :: ql, rho_air
+real(kind=kind_real) :: efr
+
+real :: wcontent, nconc, answer
+
+wcontent = max(ql, min_qx)*rho_air
+nconc    = 100.E6
+answer = exp(1./3. * log((3*wcontent)/(4.*PI*1000.*nconc)))
+efr = max(2.0_kind_real, min(answer*1.0E6_kind_real, 25.0_kind_real))
+
+end function gfdl_ql_efr
+
+! --------------------------------------------------------------------------------------------------
+
+elemental function gfdl_qi_efr(qi, rho_air, tc) result(efr)
+
+real(kind=kind_real), intent(in) :: qi, rho_air, tc
+real(kind=kind_real) :: efr
+
+real :: wcontent, answer, a, b
+
+wcontent = max(qi, min_qx)*rho_air
+a = merge(9.917, merge(9.337, merge(9.208, 9.387, tc .lt. -30), tc .lt. -40), tc .lt. -50)
+b = merge(0.891, merge(0.920, merge(0.945, 0.969, tc .lt. -30), tc .lt. -40), tc .lt. -50)
+answer  = 1.22/a * exp((1 - b) * log(1.0e3*wcontent))*1.0e-3
+efr = max(2.0_kind_real, min(answer*1.0E6_kind_real, 250.0_kind_real))
+
+end function gfdl_qi_efr
+
+! --------------------------------------------------------------------------------------------------
+
+elemental function gsi_ql_efr(tc) result(efr)
+
+real(kind=kind_real), intent(in) :: tc
+real(kind=kind_real) :: efr
+
+real(kind=kind_real) :: tem1
+
+tem1 = (-tc)*0.05_kind_real
+efr = 5.0_kind_real + 5.0_kind_real * min(1.0_kind_real, tem1)
+efr = max(1.0_kind_real, efr)
+
+end function gsi_ql_efr
+
+! --------------------------------------------------------------------------------------------------
+
+elemental function gsi_qi_efr(qi, rho_air, tc) result(efr)
+
+real(kind=kind_real), intent(in) :: qi, rho_air, tc
+real(kind=kind_real) :: efr
+
+real :: wcontent
+real(kind=kind_real) :: a, b
+
+wcontent = max(qi, min_qx)*rho_air
+a = merge(9.917_kind_real, merge(9.337_kind_real, merge(9.208_kind_real, 9.387_kind_real, &
+          tc < -30.0_kind_real), tc < -40.0_kind_real), tc < -50.0_kind_real)
+b = merge(0.109_kind_real, merge(0.08_kind_real, merge(0.055_kind_real, 0.031_kind_real, &
+          tc < -30.0_kind_real), tc < -40.0_kind_real), tc < -50.0_kind_real)
+efr = (1250._kind_real/a)*wcontent**b
+efr = max(5.0_kind_real, efr)
+
+end function gsi_qi_efr
+
+! --------------------------------------------------------------------------------------------------
+
+elemental function gsi_precip_efr(qx, rho_air, c3, c2, c1, c0) result(efr)
+
+real(kind=kind_real), intent(in) :: qx, rho_air, c3, c2, c1, c0
+real(kind=kind_real) :: efr
+
+real :: wcontent
+real(kind=kind_real) :: xqq
+
+wcontent = 1000.0_kind_real * max(qx, min_qx)*rho_air
+xqq = log10(wcontent)
+efr = c3*xqq*xqq*xqq + c2*xqq*xqq + c1*xqq + c0
+efr = max(efr, 100.0_kind_real)
+
+end function gsi_precip_efr
+
 !+---+-----------------------------------------------------------------+
 
       real function effectiveRadius(rx, nx, a, b, mu)
@@ -616,6 +584,7 @@ end subroutine crtm_ade_efr
       integer, optional, intent(in):: mu
       real:: obmx, xcontent, xnumber
       real:: a_mass, b_mass
+      double precision:: lambda
       integer:: mu_x, n
       real, dimension(0:15):: g_rat
 
@@ -660,14 +629,14 @@ end subroutine crtm_ade_efr
       real, optional, intent(in):: a, b
       integer, optional, intent(in):: mu
       real:: obmx
-      double precision:: lam_exp
+      double precision:: lam_exp, lambda
       integer:: n
       real:: a_mass, b_mass
       integer:: mu_x
-      !..Variables to hold exponents and gamma values.
+      !..Variables to hold exponents and gamma values (recomputed every call, kept local so
+      !.. the function can be called from threaded loops)
       real, dimension(3,0:15):: ce, cg
       real, dimension(0:15)::  ocg1, ocg2, ocg3
-      save ce, cg, ocg1, ocg2, ocg3
 
       if (present(a)) then
          a_mass = a
@@ -795,14 +764,10 @@ real(kind=kind_real), intent(in)  ::  qmx(geom%isc:geom%iec,geom%jsc:geom%jec, 1
 real(kind=kind_real), intent(in)  :: delp(geom%isc:geom%iec,geom%jsc:geom%jec, 1:geom%npz) !Pressure thickness (Pa)
 real(kind=kind_real), intent(out) ::  qwp(geom%isc:geom%iec,geom%jsc:geom%jec, 1:geom%npz) !Water path (kg/m^2)
 
-real(kind=kind_real) :: kgkg_to_kgm2
 real(kind=kind_real) :: grav
 
-!..Any hydrometeor with less than min_qx is ignored as zero cloud/precip.
-real(kind=kind_real), parameter :: min_qx = 1.0E-8_kind_real
-
 integer :: isc,iec,jsc,jec,npz
-integer :: i,j,k
+integer :: j,k
 
 grav = constant('grav')
 
@@ -816,15 +781,13 @@ npz = geom%npz
 
 ! Convert hydrometeor mixing ratio to water path (kg/kg to kg/m^2)
 ! ----------------------------------------------------------------
+!$omp parallel do num_threads(geom%nthreads) default(shared) private(j,k)
 do k = 1,npz
   do j = jsc,jec
-    do i = isc,iec
-         if (qmx(i,j,k) .lt. min_qx) CYCLE
-         kgkg_to_kgm2 = delp(i,j,k) / grav
-         qwp(i,j,k) = qmx(i,j,k) * kgkg_to_kgm2
-    enddo
+    qwp(:,j,k) = water_path(qmx(:,j,k), delp(:,j,k), grav)
   enddo
 enddo
+!$omp end parallel do
 
 end subroutine hydro_mixr_to_wpath
 
@@ -857,6 +820,7 @@ npz = geom%npz
 
 ! Convert hydrometeor mixing ratio to water path (kg/kg to kg/m^2)
 ! ----------------------------------------------------------------
+!$omp parallel do num_threads(geom%nthreads) default(shared) private(i,j,k,kgkg_to_kgm2)
 do k = 1,npz
   do j = jsc,jec
     do i = isc,iec
@@ -869,6 +833,7 @@ do k = 1,npz
     enddo
   enddo
 enddo
+!$omp end parallel do
 
 end subroutine hydro_mixr_to_wpath_tl
 
@@ -901,6 +866,7 @@ npz = geom%npz
 
 ! Convert hydrometeor mixing ratio to water path (kg/kg to kg/m^2)
 ! ----------------------------------------------------------------
+!$omp parallel do num_threads(geom%nthreads) default(shared) private(i,j,k,kgkg_to_kgm2)
 do k = 1,npz
   do j = jsc,jec
     do i = isc,iec
@@ -913,6 +879,7 @@ do k = 1,npz
     enddo
   enddo
 enddo
+!$omp end parallel do
 
 end subroutine hydro_mixr_to_wpath_ad
 
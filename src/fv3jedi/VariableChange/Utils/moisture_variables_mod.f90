@@ -9,7 +9,7 @@ use fv3jedi_kinds_mod, only: kind_real
 use fv3jedi_geom_mod, only: fv3jedi_geom
 use fv3jedi_constants_mod, only: constant
 
-use pressure_vt_mod, only: delp_to_pe_p_logp
+use saturation_tables_mod, only: saturation_tables_init, es_water
 
 implicit none
 private
@@ -61,6 +61,7 @@ npz = geom%npz
 ! Remove negative values
 ! ----------------------
 q_pos = q
+!$omp parallel do num_threads(geom%nthreads) default(shared) private(i,j,k)
 do k = 1,npz
   do j = jsc,jec
     do i = isc,iec
@@ -70,6 +71,7 @@ do k = 1,npz
     enddo
   enddo
 enddo
+!$omp end parallel do
 
 
 ! Convert specific humidity
@@ -113,6 +115,7 @@ npz = geom%npz
 ! ----------------------
 q_pos = q
 q_tl_pos = q_tl
+!$omp parallel do num_threads(geom%nthreads) default(shared) private(i,j,k)
 do k = 1,npz
   do j = jsc,jec
     do i = isc,iec
@@ -123,6 +126,7 @@ do k = 1,npz
     enddo
   enddo
 enddo
+!$omp end parallel do
 
 
 ! Convert specific humidity
@@ -166,6 +170,7 @@ npz = geom%npz
 ! Remove negative values
 ! ----------------------
 q_pos = q
+!$omp parallel do num_threads(geom%nthreads) default(shared) private(i,j,k)
 do k = 1,npz
   do j = jsc,jec
     do i = isc,iec
@@ -175,6 +180,7 @@ do k = 1,npz
     enddo
   enddo
 enddo
+!$omp end parallel do
 
 
 ! Convert specific humidity
@@ -187,6 +193,7 @@ qmr_ad = 0.0_kind_real
 
 ! Remove negative values adjoint
 ! ------------------------------
+!$omp parallel do num_threads(geom%nthreads) default(shared) private(i,j,k)
 do k = 1,npz
   do j = jsc,jec
     do i = isc,iec
@@ -196,6 +203,7 @@ do k = 1,npz
     enddo
   enddo
 enddo
+!$omp end parallel do
 
 q_ad = q_ad + q_ad_pos
 
@@ -349,6 +357,9 @@ end subroutine q_to_rh_ad
 
 subroutine get_qsat(geom,delp,t,q,qsat)
 
+  ! Midpoint pressure is built one row at a time alongside qsat (same arithmetic as
+  ! delp_to_pe_p_logp) so no full-size pressure arrays are needed
+
   implicit none
   type(fv3jedi_geom),   intent(in)  :: geom
   real(kind=kind_real), intent(in)  :: delp(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
@@ -356,101 +367,52 @@ subroutine get_qsat(geom,delp,t,q,qsat)
   real(kind=kind_real), intent(in)  ::    q(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
   real(kind=kind_real), intent(out) :: qsat(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
 
-  integer :: i,j
-  real(kind=kind_real), allocatable :: pe(:,:,:)
-  real(kind=kind_real), allocatable :: pm(:,:,:)
-
-  allocate(pe(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz+1))
-  allocate(pm(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz  ))
-
-  call delp_to_pe_p_logp(geom,delp,pe,pm)
-
-  call qsmith(geom,t,q,pm,qsat)
-
-  deallocate(pm)
-  deallocate(pe)
-
-end subroutine get_qsat
+  integer :: i,j,k
+  real(kind=kind_real) :: kap1, kapr, zvir
+  real(kind=kind_real) :: pe_up(geom%isc:geom%iec), pe_dn(geom%isc:geom%iec)
+  real(kind=kind_real) :: pk1_up(geom%isc:geom%iec), pk1_dn(geom%isc:geom%iec)
+  real(kind=kind_real) :: pm(geom%isc:geom%iec)
 
-!----------------------------------------------------------------------------
-
-subroutine qsmith(geom,t,sphum,pl,qs)
-
-  implicit none
-  type(fv3jedi_geom), intent(in)  :: geom
-  real(kind_real),    intent(in)  ::     t(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
-  real(kind_real),    intent(in)  :: sphum(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
-  real(kind_real),    intent(in)  ::    pl(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
-  real(kind_real),    intent(out) ::    qs(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
-
-  real(kind_real), parameter :: esl = 0.621971831
-  real(kind_real), allocatable :: table(:), des(:)
+  call saturation_tables_init()
 
-  real(kind_real) :: es, tice,zvir
-  real(kind_real) :: ap1, eps10
-  integer :: i, j, k, it
-  integer, parameter :: length=2621
-
-  ! Constants
-  tice = constant('tice')
+  kap1 = constant('kappa') + 1.0_kind_real
+  kapr = 1.0_kind_real/constant('kappa')
   zvir = constant('zvir')
 
-  eps10  = 10.0_kind_real*esl
-
-  allocate ( table(length) )
-  call qs_table(length,table)
-
-  allocate (  des (length) )
-  do k=1,length-1
-    des(k) = table(k+1) - table(k)
-  enddo
-  des(length) = des(length-1)
-
-  do k=1,geom%npz
-    do j = geom%jsc,geom%jec
+  !$omp parallel do num_threads(geom%nthreads) default(shared) &
+  !$omp private(i,j,k,pe_up,pe_dn,pk1_up,pk1_dn,pm)
+  do j = geom%jsc,geom%jec
+    pe_up = geom%ptop
+    pk1_up = pe_up**kap1
+    do k = 1,geom%npz
       do i = geom%isc,geom%iec
-        ap1 = 10.0_kind_real*dim(t(i,j,k), tice-160.0_kind_real) + 1.0_kind_real
-        ap1 = min(2621.0_kind_real, ap1)
-        it = int(ap1)
-        es = table(it) + (ap1-it)*des(it)
-        qs(i,j,k) = esl*es*(1.0_kind_real+zvir*sphum(i,j,k))/(pl(i,j,k))
+        pe_dn(i) = pe_up(i) + delp(i,j,k)
+        pk1_dn(i) = pe_dn(i)**kap1
+        pm(i) = ((pk1_dn(i) - pk1_up(i))/(kap1*(pe_dn(i) - pe_up(i))))**kapr
       enddo
+      qsat(:,j,k) = qsat_water(t(:,j,k), q(:,j,k), pm, zvir)
+      pe_up = pe_dn
+      pk1_up = pk1_dn
     enddo
   enddo
+  !$omp end parallel do
 
-  deallocate(table,des)
-
-end subroutine qsmith
+end subroutine get_qsat
 
 !----------------------------------------------------------------------------
 
-subroutine qs_table(n,table)
+elemental function qsat_water(t, sphum, pl, zvir) result(qs)
 
-  implicit none
+  ! Saturation specific humidity with respect to water from the tabulated vapour pressure
 
-  integer,              intent(in)    :: n
-  real(kind=kind_real), intent(inout) :: table(n)
-
-  real(kind=kind_real) :: tem, aa, b, c, d, e
-  integer :: i
-  real(kind=kind_real), parameter :: dt=0.1_kind_real
-  real(kind=kind_real), parameter :: esbasw = 1013246.0_kind_real
-  real(kind=kind_real), parameter :: tbasw = 373.16_kind_real
-  real(kind=kind_real), parameter :: tbasi = 273.16_kind_real
-  real(kind=kind_real), parameter :: Tmin = tbasi - 160.0_kind_real
-
-  ! Compute es over water, see smithsonian meteorological tables page 350.
-  do  i=1,n
-     tem = tmin+dt*real(i-1)
-     aa  = -7.90298_kind_real*(tbasw/tem-1)
-     b   =  5.02808_kind_real*log10(tbasw/tem)
-     c   = -1.3816e-07_kind_real*(10.0_kind_real**((1.0_kind_real-tem/tbasw)*11.344_kind_real)-1.0_kind_real)
-     d   =  8.1328e-03_kind_real*(10.0_kind_real**((tbasw/tem-1.0_kind_real)*(-3.49149_kind_real))-1.0_kind_real)
-     e   =  log10(esbasw)
-     table(i)  = 0.1_kind_real*10.0_kind_real**(aa+b+c+d+e)
-  enddo
+  real(kind_real), intent(in) :: t, sphum, pl, zvir
+  real(kind_real) :: qs
+
+  real(kind_real), parameter :: esl = 0.621971831
+
+  qs = esl*es_water(t)*(1.0_kind_real+zvir*sphum)/pl
 
-end subroutine qs_table
+end function qsat_water
 
 !----------------------------------------------------------------------------
 
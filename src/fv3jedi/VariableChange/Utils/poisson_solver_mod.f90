@@ -0,0 +1,247 @@
+! (C) Copyright 2024 UCAR
+!
+! This software is licensed under the terms of the Apache Licence Version 2.0
+! which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+
+module poisson_solver_mod
+
+! Poisson equation on the native cubed-sphere decomposition. The Laplacian is the five point finite
+! volume operator on cell centres built from the D- and C-grid lengths, which is exactly the
+! vorticity that udvd_to_vortdivg computes from the rotational winds of psichi_to_udvd. Only a one
+! point halo is needed. The inverse is a Jacobi preconditioned conjugate gradient in which all levels
+! iterate together, so an iteration costs one halo exchange and two level-length reductions however
+! many levels there are.
+
+use fckit_log_module,  only: fckit_log
+use fckit_mpi_module,  only: fckit_mpi_sum
+use mpp_domains_mod,   only: mpp_update_domains
+
+use fv3jedi_geom_mod,  only: fv3jedi_geom
+use fv3jedi_kinds_mod, only: kind_real
+
+implicit none
+private
+
+public laplacian
+public inverse_laplacian
+
+! --------------------------------------------------------------------------------------------------
+
+contains
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine laplacian(geom, nlev, x, lapx)
+
+type(fv3jedi_geom),   intent(in)  :: geom
+integer,              intent(in)  :: nlev
+real(kind=kind_real), intent(in)  ::    x(geom%isc:geom%iec,geom%jsc:geom%jec,nlev)
+real(kind=kind_real), intent(out) :: lapx(geom%isc:geom%iec,geom%jsc:geom%jec,nlev)
+
+integer :: k
+real(kind=kind_real) :: xh(geom%isd:geom%ied,geom%jsd:geom%jed,nlev)
+real(kind=kind_real) :: cx(geom%isc:geom%iec+1,geom%jsc:geom%jec)
+real(kind=kind_real) :: cy(geom%isc:geom%iec,geom%jsc:geom%jec+1)
+
+call check_domain(geom)
+call face_coefficients(geom, cx, cy)
+
+xh = 0.0_kind_real
+xh(geom%isc:geom%iec,geom%jsc:geom%jec,:) = x
+call mpp_update_domains(xh, geom%domain, complete=.true.)
+
+! Negative area integrated operator, divided back by the area
+call apply_operator(geom, nlev, cx, cy, xh, lapx)
+do k = 1, nlev
+  lapx(:,:,k) = -geom%rarea(geom%isc:geom%iec,geom%jsc:geom%jec)*lapx(:,:,k)
+enddo
+
+end subroutine laplacian
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine inverse_laplacian(geom, nlev, rhs, x, max_iterations, tolerance)
+
+type(fv3jedi_geom),   intent(in)  :: geom
+integer,              intent(in)  :: nlev
+real(kind=kind_real), intent(in)  :: rhs(geom%isc:geom%iec,geom%jsc:geom%jec,nlev)  !Laplacian of x
+real(kind=kind_real), intent(out) ::   x(geom%isc:geom%iec,geom%jsc:geom%jec,nlev)  !Zero mean solution
+integer,              intent(in)  :: max_iterations
+real(kind=kind_real), intent(in)  :: tolerance     !Residual reduction relative to the right hand side
+
+integer :: isc, iec, jsc, jec, k, iter
+logical :: active(nlev)
+real(kind=kind_real) :: cx(geom%isc:geom%iec+1,geom%jsc:geom%jec)
+real(kind=kind_real) :: cy(geom%isc:geom%iec,geom%jsc:geom%jec+1)
+real(kind=kind_real) :: rdiag(geom%isc:geom%iec,geom%jsc:geom%jec)
+real(kind=kind_real) :: area(geom%isc:geom%iec,geom%jsc:geom%jec)
+real(kind=kind_real) :: p(geom%isd:geom%ied,geom%jsd:geom%jed,nlev)
+real(kind=kind_real), dimension(geom%isc:geom%iec,geom%jsc:geom%jec,nlev) :: r, z, q
+real(kind=kind_real) :: loc(2*nlev+1), glb(2*nlev+1)
+real(kind=kind_real) :: total_area, mean(nlev), bnorm(nlev), rnorm(nlev)
+real(kind=kind_real) :: rz(nlev), rz_new(nlev), pq(nlev), alpha(nlev), beta(nlev)
+character(len=256) :: msg
+
+call check_domain(geom)
+
+isc = geom%isc
+iec = geom%iec
+jsc = geom%jsc
+jec = geom%jec
+
+call face_coefficients(geom, cx, cy)
+rdiag = 1.0_kind_real / (cx(isc:iec,:) + cx(isc+1:iec+1,:) + cy(:,jsc:jec) + cy(:,jsc+1:jec+1))
+area = geom%area(isc:iec,jsc:jec)
+
+! Symmetric positive semi-definite form: minus the area integrated Laplacian. Its null space is the
+! constants, so the area weighted mean of the right hand side is removed to make it consistent.
+! -------------------------------------------------------------------------------------------------
+do k = 1, nlev
+  r(:,:,k) = -area*rhs(:,:,k)
+  loc(k) = sum(r(:,:,k))
+enddo
+loc(nlev+1) = sum(area)
+call geom%f_comm%allreduce(loc(1:nlev+1), glb(1:nlev+1), fckit_mpi_sum())
+total_area = glb(nlev+1)
+mean = glb(1:nlev) / total_area
+
+do k = 1, nlev
+  r(:,:,k) = r(:,:,k) - mean(k)*area
+  z(:,:,k) = rdiag*r(:,:,k)
+  loc(k) = sum(r(:,:,k)*z(:,:,k))
+  loc(nlev+k) = sum(r(:,:,k)*r(:,:,k))
+enddo
+call geom%f_comm%allreduce(loc(1:2*nlev), glb(1:2*nlev), fckit_mpi_sum())
+rz = glb(1:nlev)
+bnorm = sqrt(glb(nlev+1:2*nlev))
+rnorm = bnorm
+active = bnorm > 0.0_kind_real
+
+x = 0.0_kind_real
+p = 0.0_kind_real
+p(isc:iec,jsc:jec,:) = z
+
+! Conjugate gradient, levels that have converged keep their solution
+! ------------------------------------------------------------------
+iter = 0
+do while (any(active) .and. iter < max_iterations)
+
+  iter = iter + 1
+
+  call mpp_update_domains(p, geom%domain, complete=.true.)
+  call apply_operator(geom, nlev, cx, cy, p, q)
+
+  do k = 1, nlev
+    loc(k) = sum(p(isc:iec,jsc:jec,k)*q(:,:,k))
+  enddo
+  call geom%f_comm%allreduce(loc(1:nlev), glb(1:nlev), fckit_mpi_sum())
+  pq = glb(1:nlev)
+  alpha = 0.0_kind_real
+  where (active) alpha = rz / pq
+
+  do k = 1, nlev
+    x(:,:,k) = x(:,:,k) + alpha(k)*p(isc:iec,jsc:jec,k)
+    r(:,:,k) = r(:,:,k) - alpha(k)*q(:,:,k)
+    z(:,:,k) = rdiag*r(:,:,k)
+    loc(k) = sum(r(:,:,k)*z(:,:,k))
+    loc(nlev+k) = sum(r(:,:,k)*r(:,:,k))
+  enddo
+  call geom%f_comm%allreduce(loc(1:2*nlev), glb(1:2*nlev), fckit_mpi_sum())
+  rz_new = glb(1:nlev)
+  where (active) rnorm = sqrt(glb(nlev+1:2*nlev))
+  active = active .and. rnorm > tolerance*bnorm
+
+  beta = 0.0_kind_real
+  where (active) beta = rz_new / rz
+  do k = 1, nlev
+    if (active(k)) p(isc:iec,jsc:jec,k) = z(:,:,k) + beta(k)*p(isc:iec,jsc:jec,k)
+  enddo
+  where (active) rz = rz_new
+
+enddo
+
+! Fix the free constant by giving each level zero area weighted mean
+! ------------------------------------------------------------------
+do k = 1, nlev
+  loc(k) = sum(area*x(:,:,k))
+enddo
+call geom%f_comm%allreduce(loc(1:nlev), glb(1:nlev), fckit_mpi_sum())
+do k = 1, nlev
+  x(:,:,k) = x(:,:,k) - glb(k)/total_area
+enddo
+
+if (geom%f_comm%rank() == 0) then
+  write(msg,'(A,I6,A,ES12.4)') 'inverse_laplacian: iterations ', iter, &
+                               ', largest relative residual ', &
+                               maxval(rnorm/max(bnorm, tiny(1.0_kind_real)))
+  call fckit_log%info(msg)
+  if (any(active)) then
+    write(msg,'(A,I4,A)') 'inverse_laplacian: WARNING ', count(active), &
+                          ' levels did not reach the requested tolerance'
+    call fckit_log%info(msg)
+  endif
+endif
+
+end subroutine inverse_laplacian
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine check_domain(geom)
+
+type(fv3jedi_geom), intent(in) :: geom
+
+if (geom%bounded_domain) &
+  call abor1_ftn("poisson_solver_mod: the Poisson solver needs a global cubed-sphere geometry")
+
+end subroutine check_domain
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine face_coefficients(geom, cx, cy)
+
+type(fv3jedi_geom),   intent(in)  :: geom
+real(kind=kind_real), intent(out) :: cx(geom%isc:geom%iec+1,geom%jsc:geom%jec)  !Faces normal to x
+real(kind=kind_real), intent(out) :: cy(geom%isc:geom%iec,geom%jsc:geom%jec+1)  !Faces normal to y
+
+integer :: isc, iec, jsc, jec
+
+isc = geom%isc
+iec = geom%iec
+jsc = geom%jsc
+jec = geom%jec
+
+! Face length over the distance between the cell centres either side of it
+cx = geom%dy(isc:iec+1,jsc:jec) / geom%dxc(isc:iec+1,jsc:jec)
+cy = geom%dx(isc:iec,jsc:jec+1) / geom%dyc(isc:iec,jsc:jec+1)
+
+end subroutine face_coefficients
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine apply_operator(geom, nlev, cx, cy, x, ax)
+
+type(fv3jedi_geom),   intent(in)  :: geom
+integer,              intent(in)  :: nlev
+real(kind=kind_real), intent(in)  :: cx(geom%isc:geom%iec+1,geom%jsc:geom%jec)
+real(kind=kind_real), intent(in)  :: cy(geom%isc:geom%iec,geom%jsc:geom%jec+1)
+real(kind=kind_real), intent(in)  ::  x(geom%isd:geom%ied,geom%jsd:geom%jed,nlev)  !Halo filled
+real(kind=kind_real), intent(out) :: ax(geom%isc:geom%iec,geom%jsc:geom%jec,nlev)
+
+integer :: i, j, k
+
+!$omp parallel do num_threads(geom%nthreads) default(shared) private(i,j,k)
+do k = 1, nlev
+  do j = geom%jsc, geom%jec
+    do i = geom%isc, geom%iec
+      ax(i,j,k) = cx(i  ,j)*(x(i,j,k) - x(i-1,j,k)) - cx(i+1,j)*(x(i+1,j,k) - x(i,j,k)) &
+                + cy(i,j  )*(x(i,j,k) - x(i,j-1,k)) - cy(i,j+1)*(x(i,j+1,k) - x(i,j,k))
+    enddo
+  enddo
+enddo
+!$omp end parallel do
+
+end subroutine apply_operator
+
+! --------------------------------------------------------------------------------------------------
+
+end module poisson_solver_mod
@@ -6,7 +6,7 @@
 module pressure_vt_mod
 
 use fv3jedi_constants_mod, only: constant
-use fv3jedi_geom_mod, only: fv3jedi_geom, pedges2pmidlayer
+use fv3jedi_geom_mod, only: fv3jedi_geom
 use fv3jedi_kinds_mod, only: kind_real
 
 implicit none
@@ -19,12 +19,20 @@ public ps_to_delp_ad
 public tropprs
 public tropprs_th
 
+! Number of columns processed together by the fused pressure kernel
+integer, parameter :: pressure_block = 64
+
 contains
 
 !----------------------------------------------------------------------------
 ! Pressure thickness to pressure (edge), pressure (mid) and log p (mid) -----
 !----------------------------------------------------------------------------
 
+! All the requested pressure quantities are produced in a single pass over blocks of columns. A
+! block is up to pressure_block consecutive points along a row; levels are walked top to bottom
+! keeping the values at the upper edge of the current layer, so the only scratch space is a few
+! block-length vectors and every inner loop runs along the contiguous i index.
+
 subroutine delp_to_pe_p_logp(geom,delp,pe,p,logp,logpe,pkz)
 
  type(fv3jedi_geom)  , intent(in ) :: geom !Geometry for the model
@@ -36,44 +44,95 @@ subroutine delp_to_pe_p_logp(geom,delp,pe,p,logp,logpe,pkz)
  real(kind=kind_real), optional, intent(out) :: pkz(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)    !Log of pressure mid point
 
  !Locals
- integer :: isc,iec,jsc,jec,i,j,k
- real(kind=kind_real) :: peln(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz+1)
- real(kind=kind_real) ::   pk(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz+1)
- real(kind=kind_real) :: kappa
+ integer :: isc,iec,jsc,jec,npz,i,j,k,ib,ie
+ logical :: do_logp, do_logpe, do_pkz
+ real(kind=kind_real) :: kappa, kap1, kapr
+ real(kind=kind_real) :: pe_up(pressure_block), pe_dn(pressure_block)     !Edge pressure above/below
+ real(kind=kind_real) :: pk1_up(pressure_block), pk1_dn(pressure_block)   !Edge pressure**(kappa+1)
+ real(kind=kind_real) :: ln_up(pressure_block), ln_dn(pressure_block)     !Log of edge pressure
+ real(kind=kind_real) :: pk_up(pressure_block), pk_dn(pressure_block)     !Edge pressure**kappa
 
  isc = geom%isc
  iec = geom%iec
  jsc = geom%jsc
  jec = geom%jec
+ npz = geom%npz
 
  kappa = constant('kappa')
+ kap1 = kappa + 1.0_kind_real
+ kapr = 1.0_kind_real/kappa
 
- !Pressure at layer edge
- pe(isc:iec,jsc:jec,1) = geom%ptop
- do k = 2,geom%npz+1
-   pe(isc:iec,jsc:jec,k) = pe(isc:iec,jsc:jec,k-1) + delp(isc:iec,jsc:jec,k-1)
- enddo
+ do_logp  = present(logp)
+ do_logpe = present(logpe)
+ do_pkz   = present(pkz)
+
+ !$omp parallel do num_threads(geom%nthreads) default(shared) collapse(2) &
+ !$omp private(i,j,k,ib,ie,pe_up,pe_dn,pk1_up,pk1_dn,ln_up,ln_dn,pk_up,pk_dn)
+ do j = jsc,jec
+   do ib = isc,iec,pressure_block
+
+     ie = min(ib+pressure_block-1,iec)
+
+     !Model top
+     do i = ib,ie
+       pe_up(i-ib+1) = geom%ptop
+       pe(i,j,1) = pe_up(i-ib+1)
+       pk1_up(i-ib+1) = pe_up(i-ib+1)**kap1
+     enddo
+     if (do_logpe .or. do_pkz) then
+       do i = ib,ie
+         ln_up(i-ib+1) = log(pe_up(i-ib+1))
+       enddo
+       if (do_logpe) logpe(ib:ie,j,1) = ln_up(1:ie-ib+1)
+     endif
+     if (do_pkz) then
+       do i = ib,ie
+         pk_up(i-ib+1) = exp(kappa*ln_up(i-ib+1))
+       enddo
+     endif
+
+     !Walk down the layers
+     do k = 1,npz
+
+       !Pressure at lower edge and Philips midpoint pressure
+       do i = ib,ie
+         pe_dn(i-ib+1) = pe_up(i-ib+1) + delp(i,j,k)
+         pe(i,j,k+1) = pe_dn(i-ib+1)
+         pk1_dn(i-ib+1) = pe_dn(i-ib+1)**kap1
+         p(i,j,k) = ((pk1_dn(i-ib+1) - pk1_up(i-ib+1))/(kap1*(pe_dn(i-ib+1) - pe_up(i-ib+1))))**kapr
+       enddo
+
+       if (do_logp) then
+         do i = ib,ie
+           logp(i,j,k) = log(p(i,j,k))
+         enddo
+       endif
+
+       if (do_logpe .or. do_pkz) then
+         do i = ib,ie
+           ln_dn(i-ib+1) = log(pe_dn(i-ib+1))
+         enddo
+         if (do_logpe) logpe(ib:ie,j,k+1) = ln_dn(1:ie-ib+1)
+       endif
+
+       if (do_pkz) then
+         do i = ib,ie
+           pk_dn(i-ib+1) = exp(kappa*ln_dn(i-ib+1))
+           pkz(i,j,k) = (pk_dn(i-ib+1)-pk_up(i-ib+1)) / (kappa*(ln_dn(i-ib+1)-ln_up(i-ib+1)))
+         enddo
+         pk_up = pk_dn
+       endif
+
+       !Lower edge becomes the upper edge of the next layer
+       pe_up = pe_dn
+       pk1_up = pk1_dn
+       if (do_logpe .or. do_pkz) ln_up = ln_dn
+
+     enddo
 
- !Midpoint pressure
- do i = isc,iec
-   do j = jsc,jec
-       call pedges2pmidlayer(geom%npz,'Philips',pe(i,j,:),kappa,p(i,j,:))
    enddo
  enddo
-
- if (present(logp)) then
-   !Log pressure
-   logp(isc:iec,jsc:jec,:) = log(p(isc:iec,jsc:jec,:))
-   logpe(isc:iec,jsc:jec,:) = log(pe(isc:iec,jsc:jec,:))
- endif
-
- if (present(pkz)) then
-  peln = log(pe)
-  pk = exp(kappa*peln)
-  do k=1,geom%npz
-    pkz(:,:,k) = (pk(:,:,k+1)-pk(:,:,k)) / (kappa*(peln(:,:,k+1)-peln(:,:,k)))
-  enddo
-endif
+ !$omp end parallel do
 
 end subroutine delp_to_pe_p_logp
 
@@ -92,6 +151,7 @@ subroutine ps_to_delp(geom,ps,delp)
  jsc = geom%jsc
  jec = geom%jec
 
+ !$omp parallel do num_threads(geom%nthreads) default(shared) private(i,j,k)
  do k = 1,geom%npz
    do j = jsc,jec
      do i = isc,iec
@@ -99,6 +159,7 @@ subroutine ps_to_delp(geom,ps,delp)
      enddo
    enddo
  enddo
+ !$omp end parallel do
 
 endsubroutine ps_to_delp
 
@@ -116,6 +177,7 @@ subroutine ps_to_delp_tl(geom,ps_tl,delp_tl)
  jec = geom%jec
 
  delp_tl = 0.0_kind_real
+ !$omp parallel do num_threads(geom%nthreads) default(shared) private(i,j,k)
  do k = 1,geom%npz
    do j = jsc,jec
      do i = isc,iec
@@ -123,6 +185,7 @@ subroutine ps_to_delp_tl(geom,ps_tl,delp_tl)
      enddo
    enddo
  enddo
+ !$omp end parallel do
 
 endsubroutine ps_to_delp_tl
 
@@ -141,13 +204,16 @@ subroutine ps_to_delp_ad(geom,ps_ad,delp_ad)
 
  ps_ad = 0.0_kind_real
 
- do k = geom%npz,1,-1
-   do j = jec,jsc,-1
+ ! Threaded over rows so each ps_ad(i,j) still accumulates levels in the serial order
+ !$omp parallel do num_threads(geom%nthreads) default(shared) private(i,j,k)
+ do j = jec,jsc,-1
+   do k = geom%npz,1,-1
      do i = iec,isc,-1
        ps_ad(i,j) = ps_ad(i,j) + (geom%bk(k+1) - geom%bk(k))*delp_ad(i,j,k)
      enddo
    enddo
  enddo
+ !$omp end parallel do
 
 endsubroutine ps_to_delp_ad
 
@@ -195,6 +261,9 @@ subroutine tropprs(geom, ps, prs, tv, o3, vort, tprs)
  kappa = constant('kappa')
  grav = constant('grav')
  ! Loop through locations
+ !$omp parallel do num_threads(geom%nthreads) default(shared) &
+ !$omp private(i,j,k,itrop_k,ifound_pv,ifound_oz,itrp_pv,itrp_oz,pm1,pp1,thetam1,thetap1,pv,psi, &
+ !$omp         prsl,pvort,o3mr,lat,wgt)
  do j = jsc, jec
    do i = isc, iec
 
@@ -267,6 +336,7 @@ subroutine tropprs(geom, ps, prs, tv, o3, vort, tprs)
 
    enddo
  enddo
+ !$omp end parallel do
 
 end subroutine tropprs
 
@@ -304,6 +374,7 @@ jec = geom%jec
 npz = geom%npz
 
 ! Flip to index increasing upwards
+!$omp parallel do num_threads(geom%nthreads) default(shared) private(i,j,k)
 do k = 1, npz
   do j = jsc, jec
     do i = isc, iec
@@ -313,8 +384,11 @@ do k = 1, npz
     enddo
   enddo
 enddo
+!$omp end parallel do
 
 ! Compute tropopause pressure
+!$omp parallel do num_threads(geom%nthreads) default(shared) &
+!$omp private(i,j,k,k1,k2,k_p50,k_p150,k_tropo)
 do j = jsc, jec
   do i = isc, iec
     k_p150 = 0
@@ -337,6 +411,7 @@ do j = jsc, jec
     tprs(i,j,1) = p2(i,j,k_tropo)
   enddo
 enddo
+!$omp end parallel do
 
 end subroutine tropprs_th
 
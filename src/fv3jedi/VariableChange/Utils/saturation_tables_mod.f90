@@ -0,0 +1,144 @@
+! (C) Copyright 2024 UCAR
+!
+! This software is licensed under the terms of the Apache Licence Version 2.0
+! which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+
+module saturation_tables_mod
+
+! Process-wide lookup table of saturation vapour pressure over water, tabulated every 0.1 K from
+! 160 K below the triple point. The table is built on first use and shared by every caller
+! afterwards. The lookup is elemental, branch free and read-only so it can be used from vectorised
+! and threaded loops once saturation_tables_init has returned on the calling thread.
+
+use fv3jedi_constants_mod, only: constant
+use fv3jedi_kinds_mod, only: kind_real
+
+implicit none
+private
+
+public saturation_tables_init
+public es_water
+public es_water_direct
+
+! --------------------------------------------------------------------------------------------------
+
+integer, parameter :: table_length = 2621
+
+logical, save :: tables_ready = .false.
+real(kind=kind_real), save :: tmin                        !Temperature of the first entry (K)
+real(kind=kind_real), save :: table_w(table_length)       !Saturation vapour pressure over water (Pa)
+real(kind=kind_real), save :: dtable_w(table_length)      !Increment to the next water entry
+
+! --------------------------------------------------------------------------------------------------
+
+contains
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine saturation_tables_init()
+
+! Double-checked initialisation: the flag is read atomically and only published, atomically, once
+! the table has been flushed, so a thread that sees it set also sees the table.
+
+logical :: ready
+
+!$omp atomic read
+ready = tables_ready
+
+if (.not. ready) then
+  !$omp critical (saturation_tables_build)
+  !$omp atomic read
+  ready = tables_ready
+  if (.not. ready) then
+    tmin = constant('tice') - 160.0_kind_real
+    call es_water_table(table_length, table_w)
+    call table_increments(table_length, table_w, dtable_w)
+    !$omp flush
+    !$omp atomic write
+    tables_ready = .true.
+  endif
+  !$omp end critical (saturation_tables_build)
+endif
+
+!$omp flush
+
+end subroutine saturation_tables_init
+
+! --------------------------------------------------------------------------------------------------
+! Lookup, linear in temperature between table entries and clamped to the table range
+
+elemental function es_water(t) result(es)
+
+real(kind=kind_real), intent(in) :: t   !Temperature (K)
+real(kind=kind_real) :: es              !Saturation vapour pressure over water (Pa)
+
+real(kind=kind_real) :: ap1
+integer :: it
+
+ap1 = min(real(table_length, kind_real), 10.0_kind_real*dim(t, tmin) + 1.0_kind_real)
+it = int(ap1)
+es = table_w(it) + (ap1-it)*dtable_w(it)
+
+end function es_water
+
+! --------------------------------------------------------------------------------------------------
+! Saturation vapour pressure over water evaluated directly, see smithsonian meteorological tables
+! page 350. This is the formula the table is built from.
+
+elemental function es_water_direct(tem) result(es)
+
+real(kind=kind_real), intent(in) :: tem !Temperature (K)
+real(kind=kind_real) :: es              !Saturation vapour pressure over water (Pa)
+
+real(kind=kind_real) :: aa, b, c, d, e
+real(kind=kind_real), parameter :: esbasw = 1013246.0_kind_real
+real(kind=kind_real), parameter :: tbasw = 373.16_kind_real
+
+aa  = -7.90298_kind_real*(tbasw/tem-1)
+b   =  5.02808_kind_real*log10(tbasw/tem)
+c   = -1.3816e-07_kind_real*(10.0_kind_real**((1.0_kind_real-tem/tbasw)*11.344_kind_real)-1.0_kind_real)
+d   =  8.1328e-03_kind_real*(10.0_kind_real**((tbasw/tem-1.0_kind_real)*(-3.49149_kind_real))-1.0_kind_real)
+e   =  log10(esbasw)
+es  = 0.1_kind_real*10.0_kind_real**(aa+b+c+d+e)
+
+end function es_water_direct
+
+! --------------------------------------------------------------------------------------------------
+! Table construction
+
+subroutine es_water_table(n,table)
+
+integer,              intent(in)  :: n
+real(kind=kind_real), intent(out) :: table(n)
+
+integer :: i
+real(kind=kind_real), parameter :: dt=0.1_kind_real
+real(kind=kind_real), parameter :: tbasi = 273.16_kind_real
+real(kind=kind_real), parameter :: Tmin = tbasi - 160.0_kind_real
+
+do  i=1,n
+   table(i) = es_water_direct(tmin+dt*real(i-1))
+enddo
+
+end subroutine es_water_table
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine table_increments(n,table,dtable)
+
+integer,              intent(in)  :: n
+real(kind=kind_real), intent(in)  :: table(n)
+real(kind=kind_real), intent(out) :: dtable(n)
+
+integer :: i
+
+do i=1,n-1
+  dtable(i) = table(i+1) - table(i)
+enddo
+dtable(n) = dtable(n-1)
+
+end subroutine table_increments
+
+! --------------------------------------------------------------------------------------------------
+
+end module saturation_tables_mod
@@ -31,7 +31,16 @@ subroutine t_to_tv(geom,t,q,tv)
  real(kind=kind_real), intent(in ) :: q (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)  !Specific humidity (kg/kg)
  real(kind=kind_real), intent(out) :: tv(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)  !Virtual temperature (K)
 
- tv = t*(1.0_kind_real + constant('epsilon')*q)
+ integer :: k
+ real(kind=kind_real) :: eps
+
+ eps = constant('epsilon')
+
+ !$omp parallel do num_threads(geom%nthreads) default(shared) private(k)
+ do k = 1,geom%npz
+   tv(:,:,k) = t(:,:,k)*(1.0_kind_real + eps*q(:,:,k))
+ enddo
+ !$omp end parallel do
 
 end subroutine t_to_tv
 
@@ -47,7 +56,16 @@ subroutine t_to_tv_tl(geom,t,t_tl,q,q_tl,tv_tl)
  real(kind=kind_real), intent(in ) :: q_tl(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
  real(kind=kind_real), intent(out) :: tv_tl(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
 
- tv_tl = t_tl*(1.0_kind_real + constant('epsilon')*q) + t*constant('epsilon')*q_tl
+ integer :: k
+ real(kind=kind_real) :: eps
+
+ eps = constant('epsilon')
+
+ !$omp parallel do num_threads(geom%nthreads) default(shared) private(k)
+ do k = 1,geom%npz
+   tv_tl(:,:,k) = t_tl(:,:,k)*(1.0_kind_real + eps*q(:,:,k)) + t(:,:,k)*eps*q_tl(:,:,k)
+ enddo
+ !$omp end parallel do
 
 end subroutine t_to_tv_tl
 
@@ -63,9 +81,18 @@ subroutine t_to_tv_ad(geom,t,t_ad,q,q_ad,tv_ad)
  real(kind=kind_real), intent(inout) :: q_ad (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
  real(kind=kind_real), intent(inout) :: tv_ad(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
 
- t_ad = t_ad + tv_ad * (1.0_kind_real + constant('epsilon')*q)
- q_ad = q_ad + tv_ad *                  constant('epsilon')*t
- tv_ad = 0.0_kind_real
+ integer :: k
+ real(kind=kind_real) :: eps
+
+ eps = constant('epsilon')
+
+ !$omp parallel do num_threads(geom%nthreads) default(shared) private(k)
+ do k = 1,geom%npz
+   t_ad(:,:,k) = t_ad(:,:,k) + tv_ad(:,:,k) * (1.0_kind_real + eps*q(:,:,k))
+   q_ad(:,:,k) = q_ad(:,:,k) + tv_ad(:,:,k) *                  eps*t(:,:,k)
+   tv_ad(:,:,k) = 0.0_kind_real
+ enddo
+ !$omp end parallel do
 
 end subroutine t_to_tv_ad
 
@@ -83,7 +110,17 @@ subroutine tv_to_t_tl(geom,tv,tv_tl,q,q_tl,t_tl)
  real(kind=kind_real), intent(in   ) :: q_tl (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
  real(kind=kind_real), intent(inout) :: t_tl (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
 
- t_tl = (tv_tl*(1.0_kind_real+constant('epsilon')*q)-tv*constant('epsilon')*q_tl)/(1.0_kind_real+constant('epsilon')*q)**2
+ integer :: k
+ real(kind=kind_real) :: eps
+
+ eps = constant('epsilon')
+
+ !$omp parallel do num_threads(geom%nthreads) default(shared) private(k)
+ do k = 1,geom%npz
+   t_tl(:,:,k) = (tv_tl(:,:,k)*(1.0_kind_real+eps*q(:,:,k))-tv(:,:,k)*eps*q_tl(:,:,k)) / &
+                 (1.0_kind_real+eps*q(:,:,k))**2
+ enddo
+ !$omp end parallel do
 
 end subroutine tv_to_t_tl
 
@@ -99,13 +136,21 @@ subroutine tv_to_t_ad(geom,tv,tv_ad,q,q_ad,t_ad)
  real(kind=kind_real), intent(inout) :: q_ad (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
  real(kind=kind_real), intent(inout) :: t_ad (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
 
- real(kind=kind_real) :: temp(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
+ integer :: k
+ real(kind=kind_real) :: eps
+ real(kind=kind_real) :: temp(geom%isc:geom%iec,geom%jsc:geom%jec)
+
+ eps = constant('epsilon')
 
- temp = t_ad/(constant('epsilon')*q+1.0_kind_real)
+ !$omp parallel do num_threads(geom%nthreads) default(shared) private(k,temp)
+ do k = 1,geom%npz
+   temp = t_ad(:,:,k)/(eps*q(:,:,k)+1.0_kind_real)
 
- tv_ad = tv_ad + temp
- q_ad  = q_ad  - tv*constant('epsilon')*temp/(constant('epsilon')*q+1.0_kind_real)
- t_ad = 0.0_kind_real
+   tv_ad(:,:,k) = tv_ad(:,:,k) + temp
+   q_ad(:,:,k)  = q_ad(:,:,k)  - tv(:,:,k)*eps*temp/(eps*q(:,:,k)+1.0_kind_real)
+   t_ad(:,:,k) = 0.0_kind_real
+ enddo
+ !$omp end parallel do
 
 end subroutine tv_to_t_ad
 
@@ -123,7 +168,13 @@ subroutine pt_to_t_tl(geom,pkz,pkz_tl,pt,pt_tl,t_tl)
  real(kind=kind_real), intent(in   ) :: pt_tl (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
  real(kind=kind_real), intent(inout) :: t_tl  (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
 
- t_tl = pt_tl*pkz + pt*pkz_tl
+ integer :: k
+
+ !$omp parallel do num_threads(geom%nthreads) default(shared) private(k)
+ do k = 1,geom%npz
+   t_tl(:,:,k) = pt_tl(:,:,k)*pkz(:,:,k) + pt(:,:,k)*pkz_tl(:,:,k)
+ enddo
+ !$omp end parallel do
 
 end subroutine pt_to_t_tl
 
@@ -139,9 +190,15 @@ subroutine pt_to_t_ad(geom,pkz,pkz_ad,pt,pt_ad,t_ad)
  real(kind=kind_real), intent(inout) :: pt_ad (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
  real(kind=kind_real), intent(inout) :: t_ad  (geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
 
- pt_ad = pt_ad + pkz*t_ad
- pkz_ad = pkz_ad + pt*t_ad
- t_ad = 0.0
+ integer :: k
+
+ !$omp parallel do num_threads(geom%nthreads) default(shared) private(k)
+ do k = 1,geom%npz
+   pt_ad(:,:,k) = pt_ad(:,:,k) + pkz(:,:,k)*t_ad(:,:,k)
+   pkz_ad(:,:,k) = pkz_ad(:,:,k) + pt(:,:,k)*t_ad(:,:,k)
+   t_ad(:,:,k) = 0.0
+ enddo
+ !$omp end parallel do
 
 end subroutine pt_to_t_ad
 
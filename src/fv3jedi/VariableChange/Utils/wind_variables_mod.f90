@@ -18,6 +18,7 @@ use fv3jedi_netcdf_utils_mod, only: nccheck
 use fv_mp_mod, only: fill_corners
 use fv_mp_adm_mod, only: mpp_update_domains_adm
 use mpp_domains_mod, only: mpp_update_domains, dgrid_ne
+use mpp_domains_mod, only: mpp_start_update_domains, mpp_complete_update_domains
 use mpp_domains_mod, only: mpp_get_boundary, mpp_get_boundary_ad
 use mpp_parameter_mod, only: CGRID_NE
 
@@ -26,6 +27,8 @@ use femps_grid_mod, only: fempsgrid
 use femps_operators_mod, only: fempsoprs
 use femps_solve_mod, only: laplace, inverselaplace
 
+use poisson_solver_mod, only: laplacian, inverse_laplacian
+
 implicit none
 private
 
@@ -41,6 +44,10 @@ public vortdivg_to_psichi
 ! Steam function and velocity potentail to voriticty and divergence (Laplacian)
 public psichi_to_vortdivg
 
+! As above but solved on the native decomposition without gathering levels
+public vortdivg_to_psichi_native
+public psichi_to_vortdivg_native
+
 ! Wind to vorticity and divergence
 public udvd_to_vortdivg
 
@@ -58,6 +65,10 @@ public d_to_a_to_c
 ! C to D grid winds (A is cubed sphere)
 public c_to_a_to_d
 
+! Parts of the compute domain for transforms that overlap computation with the halo exchange
+integer, parameter :: interior_points = 1  ! Stencil reaches only compute domain values
+integer, parameter :: boundary_points = 2  ! Everything else, needs the halo
+
 contains
 
 ! --------------------------------------------------------------------------------------------------
@@ -601,6 +612,50 @@ end subroutine psichi_to_vortdivg
 
 ! --------------------------------------------------------------------------------------------------
 
+subroutine vortdivg_to_psichi_native(geom, vort, divg, psi, chi, max_iterations, tolerance)
+
+type(fv3jedi_geom),   intent(in)  :: geom
+real(kind=kind_real), intent(in)  :: vort(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
+real(kind=kind_real), intent(in)  :: divg(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
+real(kind=kind_real), intent(out) ::  psi(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
+real(kind=kind_real), intent(out) ::  chi(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz)
+integer,              intent(in)  :: max_iterations
+real(kind=kind_real), intent(in)  :: tolerance
+
+integer :: npz
+real(kind=kind_real) :: rhs(geom%isc:geom%iec,geom%jsc:geom%jec,2*geom%npz)
+real(kind=kind_real) :: sol(geom%isc:geom%iec,geom%jsc:geom%jec,2*geom%npz)
+
+npz = geom%npz
+
+! Both Poisson problems share the iterations (\psi=\nabla^{-2}\zeta, \chi=\nabla^{-2}D)
+rhs(:,:,    1:  npz) = vort
+rhs(:,:,npz+1:2*npz) = divg
+
+call inverse_laplacian(geom, 2*npz, rhs, sol, max_iterations, tolerance)
+
+psi = sol(:,:,    1:  npz)
+chi = sol(:,:,npz+1:2*npz)
+
+end subroutine vortdivg_to_psichi_native
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine psichi_to_vortdivg_native(geom, psi, chi, vor, div)
+
+type(fv3jedi_geom),   intent(in)  :: geom
+real(kind=kind_real), intent(in)  :: psi(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz) !Stream function
+real(kind=kind_real), intent(in)  :: chi(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz) !Velocity potential
+real(kind=kind_real), intent(out) :: vor(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz) !Vorticity
+real(kind=kind_real), intent(out) :: div(geom%isc:geom%iec,geom%jsc:geom%jec,1:geom%npz) !Divergence
+
+call laplacian(geom, geom%npz, psi, vor)
+call laplacian(geom, geom%npz, chi, div)
+
+end subroutine psichi_to_vortdivg_native
+
+! --------------------------------------------------------------------------------------------------
+
 subroutine udvd_to_vortdivg(geom, ud_in, vd_in, vort, divg)
 
 type(fv3jedi_geom),   intent(in)  :: geom
@@ -1131,11 +1186,11 @@ real(kind=kind_real), intent(out) :: vd(geom%isc:geom%iec+1,geom%jsc:geom%jec,
 integer :: is ,ie , js ,je
 integer :: npx, npy, npz
 integer :: i,j,k, im2,jm2
+integer :: id_update
 
-real(kind=kind_real) :: uatemp(geom%isd:geom%ied,geom%jsd:geom%jed,geom%npz)
-real(kind=kind_real) :: vatemp(geom%isd:geom%ied,geom%jsd:geom%jed,geom%npz)
+real(kind=kind_real) :: uva(geom%isd:geom%ied,geom%jsd:geom%jed,2*geom%npz)
 
-real(kind=kind_real) :: v3(geom%isc-1:geom%iec+1,geom%jsc-1:geom%jec+1,3)
+real(kind=kind_real) :: v3(geom%isc-1:geom%iec+1,geom%jsc-1:geom%jec+1,3,geom%npz)
 real(kind=kind_real) :: ue(geom%isc-1:geom%iec+1,geom%jsc  :geom%jec+1,3)    ! 3D winds at edges
 real(kind=kind_real) :: ve(geom%isc  :geom%iec+1,geom%jsc-1:geom%jec+1,3)    ! 3D winds at edges
 real(kind=kind_real), dimension(geom%isc:geom%iec):: ut1, ut2, ut3
@@ -1151,38 +1206,43 @@ je  = geom%jec
 im2 = (npx-1)/2
 jm2 = (npy-1)/2
 
-uatemp(:,:,:) = 0.0
-vatemp(:,:,:) = 0.0
+! Both components share one halo buffer (u in levels 1:npz, v in npz+1:2*npz) so a single
+! exchange moves every level of both
+uva(:,:,:) = 0.0
 
-uatemp(is:ie,js:je,:) = ua
-vatemp(is:ie,js:je,:) = va
+uva(is:ie,js:je,    1:  npz) = ua
+uva(is:ie,js:je,npz+1:2*npz) = va
 
-call mpp_update_domains(uatemp, geom%domain, complete=.true.)
-call mpp_update_domains(vatemp, geom%domain, complete=.true.)
+id_update = mpp_start_update_domains(uva, geom%domain)
 
+! Cartesian winds on the compute domain do not need the halo so are formed while it is in flight
 do k=1, npz
+  call agrid_to_cartesian(geom, uva(:,:,k), uva(:,:,npz+k), is, ie, js, je, v3(:,:,:,k))
+enddo
 
-  do j=js-1,je+1
-    do i=is-1,ie+1
-      v3(i,j,1) = uatemp(i,j,k)*geom%vlon(i,j,1) + vatemp(i,j,k)*geom%vlat(i,j,1)
-      v3(i,j,2) = uatemp(i,j,k)*geom%vlon(i,j,2) + vatemp(i,j,k)*geom%vlat(i,j,2)
-      v3(i,j,3) = uatemp(i,j,k)*geom%vlon(i,j,3) + vatemp(i,j,k)*geom%vlat(i,j,3)
-    enddo
-  enddo
+call mpp_complete_update_domains(id_update, uva, geom%domain)
+
+do k=1, npz
+
+  ! Cartesian winds on the ring of halo points
+  call agrid_to_cartesian(geom, uva(:,:,k), uva(:,:,npz+k), is-1, ie+1, js-1, js-1, v3(:,:,:,k))
+  call agrid_to_cartesian(geom, uva(:,:,k), uva(:,:,npz+k), is-1, ie+1, je+1, je+1, v3(:,:,:,k))
+  call agrid_to_cartesian(geom, uva(:,:,k), uva(:,:,npz+k), is-1, is-1, js  , je  , v3(:,:,:,k))
+  call agrid_to_cartesian(geom, uva(:,:,k), uva(:,:,npz+k), ie+1, ie+1, js  , je  , v3(:,:,:,k))
 
   do j=js,je+1
     do i=is-1,ie+1
-      ue(i,j,1) = v3(i,j-1,1) + v3(i,j,1)
-      ue(i,j,2) = v3(i,j-1,2) + v3(i,j,2)
-      ue(i,j,3) = v3(i,j-1,3) + v3(i,j,3)
+      ue(i,j,1) = v3(i,j-1,1,k) + v3(i,j,1,k)
+      ue(i,j,2) = v3(i,j-1,2,k) + v3(i,j,2,k)
+      ue(i,j,3) = v3(i,j-1,3,k) + v3(i,j,3,k)
     enddo
   enddo
 
   do j=js-1,je+1
     do i=is,ie+1
-      ve(i,j,1) = v3(i-1,j,1) + v3(i,j,1)
-      ve(i,j,2) = v3(i-1,j,2) + v3(i,j,2)
-      ve(i,j,3) = v3(i-1,j,3) + v3(i,j,3)
+      ve(i,j,1) = v3(i-1,j,1,k) + v3(i,j,1,k)
+      ve(i,j,2) = v3(i-1,j,2,k) + v3(i,j,2,k)
+      ve(i,j,3) = v3(i-1,j,3,k) + v3(i,j,3,k)
     enddo
   enddo
  if (.not. geom%bounded_domain) then
@@ -1290,6 +1350,28 @@ end subroutine a_to_d
 
 ! --------------------------------------------------------------------------------------------------
 
+subroutine agrid_to_cartesian(geom, ua, va, i1, i2, j1, j2, v3)
+
+type(fv3jedi_geom),   intent(in)    :: geom
+real(kind=kind_real), intent(in)    :: ua(geom%isd:geom%ied,geom%jsd:geom%jed)
+real(kind=kind_real), intent(in)    :: va(geom%isd:geom%ied,geom%jsd:geom%jed)
+integer,              intent(in)    :: i1, i2, j1, j2
+real(kind=kind_real), intent(inout) :: v3(geom%isc-1:geom%iec+1,geom%jsc-1:geom%jec+1,3)
+
+integer :: i, j
+
+do j=j1,j2
+  do i=i1,i2
+    v3(i,j,1) = ua(i,j)*geom%vlon(i,j,1) + va(i,j)*geom%vlat(i,j,1)
+    v3(i,j,2) = ua(i,j)*geom%vlon(i,j,2) + va(i,j)*geom%vlat(i,j,2)
+    v3(i,j,3) = ua(i,j)*geom%vlon(i,j,3) + va(i,j)*geom%vlat(i,j,3)
+  enddo
+enddo
+
+end subroutine agrid_to_cartesian
+
+! --------------------------------------------------------------------------------------------------
+
 subroutine a_to_d_ad(geom, ua_ad, va_ad, ud_ad, vd_ad)
 
 type(fv3jedi_geom), intent(in)      :: geom
@@ -1302,11 +1384,8 @@ integer :: is, ie, js, je
 integer :: npx, npy, npz
 integer :: i, j, k, im2, jm2
 
-real(kind=kind_real) :: uatemp(geom%isd:geom%ied, geom%jsd:geom%jed, geom%npz)
-real(kind=kind_real) :: vatemp(geom%isd:geom%ied, geom%jsd:geom%jed, geom%npz)
-
-real(kind=kind_real) :: uatemp_ad(geom%isd:geom%ied, geom%jsd:geom%jed, geom%npz)
-real(kind=kind_real) :: vatemp_ad(geom%isd:geom%ied, geom%jsd:geom%jed, geom%npz)
+real(kind=kind_real) :: uva(geom%isd:geom%ied, geom%jsd:geom%jed, 2*geom%npz)
+real(kind=kind_real) :: uva_ad(geom%isd:geom%ied, geom%jsd:geom%jed, 2*geom%npz)
 real(kind=kind_real) :: v3_ad(geom%isc-1:geom%iec+1, geom%jsc-1:geom%jec+1, 3)
 real(kind=kind_real) :: ue_ad(geom%isc-1:geom%iec+1, geom%jsc:geom%jec+1, 3)
 real(kind=kind_real) :: ve_ad(geom%isc:geom%iec+1, geom%jsc-1:geom%jec+1, 3)
@@ -1325,17 +1404,15 @@ je = geom%jec
 im2 = (npx-1)/2
 jm2 = (npy-1)/2
 
-uatemp(:, :, :) = 0.0
-vatemp(:, :, :) = 0.0
+uva(:, :, :) = 0.0
 
 v3_ad = 0.0_kind_real
-uatemp_ad = 0.0_kind_real
+uva_ad = 0.0_kind_real
 ue_ad = 0.0_kind_real
 vt1_ad = 0.0_kind_real
 vt2_ad = 0.0_kind_real
 vt3_ad = 0.0_kind_real
 ve_ad = 0.0_kind_real
-vatemp_ad = 0.0_kind_real
 ut1_ad = 0.0_kind_real
 ut2_ad = 0.0_kind_real
 ut3_ad = 0.0_kind_real
@@ -1529,24 +1606,24 @@ do k=npz,1,-1
 
   do j=je+1,js-1,-1
     do i=ie+1,is-1,-1
-      uatemp_ad(i, j, k) = uatemp_ad(i, j, k) + geom%vlon(i, j, 3)*v3_ad(i, j, 3)
-      vatemp_ad(i, j, k) = vatemp_ad(i, j, k) + geom%vlat(i, j, 3)*v3_ad(i, j, 3)
+      uva_ad(i, j, k) = uva_ad(i, j, k) + geom%vlon(i, j, 3)*v3_ad(i, j, 3)
+      uva_ad(i, j, npz+k) = uva_ad(i, j, npz+k) + geom%vlat(i, j, 3)*v3_ad(i, j, 3)
       v3_ad(i, j, 3) = 0.0_kind_real
-      uatemp_ad(i, j, k) = uatemp_ad(i, j, k) + geom%vlon(i, j, 2)*v3_ad(i, j, 2)
-      vatemp_ad(i, j, k) = vatemp_ad(i, j, k) + geom%vlat(i, j, 2)*v3_ad(i, j, 2)
+      uva_ad(i, j, k) = uva_ad(i, j, k) + geom%vlon(i, j, 2)*v3_ad(i, j, 2)
+      uva_ad(i, j, npz+k) = uva_ad(i, j, npz+k) + geom%vlat(i, j, 2)*v3_ad(i, j, 2)
       v3_ad(i, j, 2) = 0.0_kind_real
-      uatemp_ad(i, j, k) = uatemp_ad(i, j, k) + geom%vlon(i, j, 1)*v3_ad(i, j, 1)
-      vatemp_ad(i, j, k) = vatemp_ad(i, j, k) + geom%vlat(i, j, 1)*v3_ad(i, j, 1)
+      uva_ad(i, j, k) = uva_ad(i, j, k) + geom%vlon(i, j, 1)*v3_ad(i, j, 1)
+      uva_ad(i, j, npz+k) = uva_ad(i, j, npz+k) + geom%vlat(i, j, 1)*v3_ad(i, j, 1)
       v3_ad(i, j, 1) = 0.0_kind_real
     end do
   end do
 end do
 
-call mpp_update_domains_adm(vatemp, vatemp_ad, geom%domain, complete=.true.)
-call mpp_update_domains_adm(uatemp, uatemp_ad, geom%domain, complete=.true.)
+! Adjoint of the single halo exchange of both components
+call mpp_update_domains_adm(uva, uva_ad, geom%domain, complete=.true.)
 
-va_ad = va_ad + vatemp_ad(is:ie, js:je, :)
-ua_ad = ua_ad + uatemp_ad(is:ie, js:je, :)
+va_ad = va_ad + uva_ad(is:ie, js:je, npz+1:2*npz)
+ua_ad = ua_ad + uva_ad(is:ie, js:je, 1:npz)
 
 end subroutine a_to_d_ad
 
@@ -1560,11 +1637,9 @@ real(kind=kind_real), intent(in)  ::  vd_in(geom%isc:geom%iec+1,geom%jsc:geom%je
 real(kind=kind_real), intent(out) :: ua_out(geom%isc:geom%iec  ,geom%jsc:geom%jec  ,geom%npz)
 real(kind=kind_real), intent(out) :: va_out(geom%isc:geom%iec  ,geom%jsc:geom%jec  ,geom%npz)
 
-integer :: k
+integer :: k, id_update
 real(kind=kind_real) :: ud(geom%isd:geom%ied  ,geom%jsd:geom%jed+1,geom%npz)
 real(kind=kind_real) :: vd(geom%isd:geom%ied+1,geom%jsd:geom%jed  ,geom%npz)
-real(kind=kind_real) :: ua(geom%isd:geom%ied  ,geom%jsd:geom%jed  )
-real(kind=kind_real) :: va(geom%isd:geom%ied  ,geom%jsd:geom%jed  )
 
 !Fill compute part from input
 ud = 0.0_kind_real
@@ -1572,31 +1647,37 @@ vd = 0.0_kind_real
 ud(geom%isc:geom%iec  ,geom%jsc:geom%jec+1,:) = ud_in
 vd(geom%isc:geom%iec+1,geom%jsc:geom%jec  ,:) = vd_in
 
-call fill_dgrid_winds(geom, ud, vd, .true.)
+!Fill the shared edges, then start the halo exchange of both components for all levels
+call fill_dgrid_winds(geom, ud, vd)
+id_update = mpp_start_update_domains(ud, vd, geom%domain, gridtype=DGRID_NE)
 
+!Points that do not depend on the halo are computed while the exchange is in flight
 do k = 1,geom%npz
+  call d_to_a_domain_level(geom, ud(:,:,k), vd(:,:,k), ua_out(:,:,k), va_out(:,:,k), interior_points)
+enddo
 
-  call d_to_a_domain_level(geom, ud(:,:,k), vd(:,:,k), ua, va)
-
-  ua_out(:,:,k) = ua(geom%isc:geom%iec,geom%jsc:geom%jec)
-  va_out(:,:,k) = va(geom%isc:geom%iec,geom%jsc:geom%jec)
+call mpp_complete_update_domains(id_update, ud, vd, geom%domain, gridtype=DGRID_NE)
 
+do k = 1,geom%npz
+  call d_to_a_domain_level(geom, ud(:,:,k), vd(:,:,k), ua_out(:,:,k), va_out(:,:,k), boundary_points)
 enddo
 
 end subroutine d_to_a
 
 ! --------------------------------------------------------------------------------------------------
 
-subroutine d_to_a_domain_level(geom, u, v, ua, va)
+subroutine d_to_a_domain_level(geom, u, v, ua, va, part)
 
 type(fv3jedi_geom),   intent(in)    :: geom
 real(kind=kind_real), intent(in)    ::  u(geom%isd:geom%ied  ,geom%jsd:geom%jed+1)
 real(kind=kind_real), intent(in)    ::  v(geom%isd:geom%ied+1,geom%jsd:geom%jed  )
-real(kind=kind_real), intent(out)   :: ua(geom%isd:geom%ied  ,geom%jsd:geom%jed  )
-real(kind=kind_real), intent(out)   :: va(geom%isd:geom%ied  ,geom%jsd:geom%jed  )
+real(kind=kind_real), intent(inout) :: ua(geom%isc:geom%iec  ,geom%jsc:geom%jec  )
+real(kind=kind_real), intent(inout) :: va(geom%isc:geom%iec  ,geom%jsc:geom%jec  )
+integer,              intent(in)    :: part   !interior_points or boundary_points
 
 integer i, j, k
 integer :: is,  ie,  js,  je, npx, npy, npz
+integer :: gi1, gi2, gj1, gj2, bi1, bi2, bj1, bj2
 real(kind=kind_real) :: c1 =  1.125
 real(kind=kind_real) :: c2 = -0.125
 real(kind=kind_real) :: utmp(geom%isc:geom%iec,  geom%jsc:geom%jec+1)
@@ -1613,23 +1694,43 @@ npx = geom%npx
 npy = geom%npy
 npz = geom%npz
 
+!Points given by the fourth order stencil, the rest are tile edges
 if (geom%bounded_domain) then
+  gi1 = max(1,is)
+  gi2 = min(npx-1,ie)
+  gj1 = max(1,js)
+  gj2 = min(npy-1,je)
+else
+  gi1 = max(2,is)
+  gi2 = min(npx-2,ie)
+  gj1 = max(2,js)
+  gj2 = min(npy-2,je)
+endif
 
-  do j=max(1,js),min(npy-1,je)
-    do i=max(1,is),min(npx-1,ie)
-      utmp(i,j) = c2*(u(i,j-1)+u(i,j+2)) + c1*(u(i,j)+u(i,j+1))
-      vtmp(i,j) = c2*(v(i-1,j)+v(i+2,j)) + c1*(v(i,j)+v(i+1,j))
-    enddo
-  enddo
+!Stencil points that only reach compute domain values. When there are none the whole stencil
+!region is left to the boundary pass.
+bi1 = max(gi1,is+1)
+bi2 = min(gi2,ie-1)
+bj1 = max(gj1,js+1)
+bj2 = min(gj2,je-1)
+if (bi1 > bi2 .or. bj1 > bj2) then
+  bj1 = gj2+1
+  bj2 = gj2
+endif
 
-else
+if (part == interior_points) then
+  call stencil(bi1, bi2, bj1, bj2)
+  call rotate(bi1, bi2, bj1, bj2)
+  return
+endif
 
-  do j=max(2,js),min(npy-2,je)
-    do i=max(2,is),min(npx-2,ie)
-      utmp(i,j) = c2*(u(i,j-1)+u(i,j+2)) + c1*(u(i,j)+u(i,j+1))
-      vtmp(i,j) = c2*(v(i-1,j)+v(i+2,j)) + c1*(v(i,j)+v(i+1,j))
-    enddo
-  enddo
+!Remainder of the stencil region
+call stencil(gi1,   gi2,   gj1,   bj1-1)
+call stencil(gi1,   gi2,   bj2+1, gj2  )
+call stencil(gi1,   bi1-1, bj1,   bj2  )
+call stencil(bi2+1, gi2,   bj1,   bj2  )
+
+if (.not. geom%bounded_domain) then
 
   if ( js==1  ) then
     do i=is,ie+1
@@ -1684,13 +1785,34 @@ else
 
 endif
 
-!Transform local a-grid winds into latitude-longitude coordinates
-do j=js,je
-  do i=is,ie
-    ua(i,j) = geom%a11(i,j)*utmp(i,j) + geom%a12(i,j)*vtmp(i,j)
-    va(i,j) = geom%a21(i,j)*utmp(i,j) + geom%a22(i,j)*vtmp(i,j)
-  enddo
-enddo
+!Compute domain points outside the interior box
+call rotate(is,    ie,    js,    bj1-1)
+call rotate(is,    ie,    bj2+1, je   )
+call rotate(is,    bi1-1, bj1,   bj2  )
+call rotate(bi2+1, ie,    bj1,   bj2  )
+
+contains
+
+  subroutine stencil(i1, i2, j1, j2)
+    integer, intent(in) :: i1, i2, j1, j2
+    do j=j1,j2
+      do i=i1,i2
+        utmp(i,j) = c2*(u(i,j-1)+u(i,j+2)) + c1*(u(i,j)+u(i,j+1))
+        vtmp(i,j) = c2*(v(i-1,j)+v(i+2,j)) + c1*(v(i,j)+v(i+1,j))
+      enddo
+    enddo
+  end subroutine stencil
+
+  !Transform local a-grid winds into latitude-longitude coordinates
+  subroutine rotate(i1, i2, j1, j2)
+    integer, intent(in) :: i1, i2, j1, j2
+    do j=j1,j2
+      do i=i1,i2
+        ua(i,j) = geom%a11(i,j)*utmp(i,j) + geom%a12(i,j)*vtmp(i,j)
+        va(i,j) = geom%a21(i,j)*utmp(i,j) + geom%a22(i,j)*vtmp(i,j)
+      enddo
+    enddo
+  end subroutine rotate
 
 end subroutine d_to_a_domain_level
 
@@ -2479,8 +2601,13 @@ type(fv3jedi_geom),   intent(in)    :: geom
 real(kind=kind_real), intent(inout) :: ua(geom%isd:geom%ied,geom%jsd:geom%jed,1:geom%npz)
 real(kind=kind_real), intent(inout) :: va(geom%isd:geom%ied,geom%jsd:geom%jed,1:geom%npz)
 
-call mpp_update_domains(ua, geom%domain, complete=.true.)
-call mpp_update_domains(va, geom%domain, complete=.true.)
+integer :: id_update_u, id_update_v
+
+! Both exchanges are in flight together
+id_update_u = mpp_start_update_domains(ua, geom%domain)
+id_update_v = mpp_start_update_domains(va, geom%domain)
+call mpp_complete_update_domains(id_update_u, ua, geom%domain)
+call mpp_complete_update_domains(id_update_v, va, geom%domain)
 
 end subroutine fill_agrid_winds
 
@@ -83,15 +83,14 @@ void VariableChange::changeVar(State & x, const oops::Variables & vars_out) cons
   // Call Vader. On entry, varsVader holds the vars requested from Vader; on exit,
   // it holds the vars NOT fulfilled by Vader, i.e., the vars still to be requested elsewhere.
   // vader_->changeVar also returns the variables fulfilled by Vader. These variables are
-  // allocated and populated and added to the FieldSet (xfs).
-  if (run_vader_) {
+  // allocated and populated and added to the FieldSet (xfs). Only those are copied back.
+  if (run_vader_ && varsVader.size() > 0) {
     atlas::FieldSet xfs;
     x.toFieldSet(xfs);
     const oops::Variables varsVaderPopulated = vader_->changeVar(xfs, varsVader);
     if (varsVaderPopulated.size() > 0) {
       varsFilled += varsVaderPopulated;
-      x.updateFields(varsFilled);
-      x.fromFieldSet(xfs);
+      x.addDerivedFields(varsVaderPopulated, xfs);
     }
   }
 
@@ -111,11 +110,8 @@ void VariableChange::changeVar(State & x, const oops::Variables & vars_out) cons
     variableChange_->changeVar(x, xout);
   }
 
-  // Remove fields not in output
-  x.updateFields(vars);
-
-  // Copy data from temporary state
-  x = xout;
+  // Take ownership of the output fields; the input fields go with the temporary state
+  x.swapFields(xout);
 
   // Trace
   oops::Log::trace() << "VariableChange::changeVar done" << std::endl;
@@ -152,14 +148,15 @@ void VariableChange::changeVarInverse(State & x, const oops::Variables & vars_ou
   // Call Vader. On entry, varsVader holds the vars requested from Vader; on exit,
   // it holds the vars NOT fulfilled by Vader, i.e., the vars still to be requested elsewhere.
   // vader_->changeVar also returns the variables fulfilled by Vader. These variables are
-  // allocated and populated and added to the FieldSet (xfs).
-  atlas::FieldSet xfs;
-  x.toFieldSet(xfs);
-  const oops::Variables varsVaderPopulated = vader_->changeVar(xfs, varsVader);
-  if (varsVaderPopulated.size() > 0) {
-    varsFilled += varsVaderPopulated;
-    x.updateFields(varsFilled);
-    x.fromFieldSet(xfs);
+  // allocated and populated and added to the FieldSet (xfs). Only those are copied back.
+  if (varsVader.size() > 0) {
+    atlas::FieldSet xfs;
+    x.toFieldSet(xfs);
+    const oops::Variables varsVaderPopulated = vader_->changeVar(xfs, varsVader);
+    if (varsVaderPopulated.size() > 0) {
+      varsFilled += varsVaderPopulated;
+      x.addDerivedFields(varsVaderPopulated, xfs);
+    }
   }
 
   // The to/fromFieldSet above is for a var change, so we know it's just adding/removing fields,
@@ -176,11 +173,8 @@ void VariableChange::changeVarInverse(State & x, const oops::Variables & vars_ou
   // Call variable change
   variableChange_->changeVarInverse(x, xout);
 
-  // Remove fields not in output
-  x.updateFields(vars);
-
-  // Copy data from temporary state
-  x = xout;
+  // Take ownership of the output fields; the input fields go with the temporary state
+  x.swapFields(xout);
 
   // Trace
   oops::Log::trace() << "VariableChange::changeVarInverse done" << std::endl;
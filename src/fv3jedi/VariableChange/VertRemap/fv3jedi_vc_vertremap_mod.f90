@@ -12,12 +12,13 @@ use fckit_configuration_module, only: fckit_configuration
 use constants_mod,           only: grav
 use field_manager_mod,       only: MODEL_ATMOS
 use mpp_domains_mod,         only: mpp_update_domains
+use mpp_mod,                 only: input_nml_file
 use tracer_manager_mod,      only: get_number_tracers, get_tracer_names, get_tracer_index, NO_TRACER, &
                                    set_tracer_profile
 
 ! fv3
 use external_ic_mod,         only: remap_scalar, remap_dwinds
-use fv_arrays_mod,           only: fv_atmos_type, deallocate_fv_atmos_type, R_GRID
+use fv_arrays_mod,           only: fv_atmos_type, R_GRID
 use fv_grid_utils_mod,       only: mid_pt_sphere, get_unit_vect2, get_latlon_vector, inner_prod
 use test_cases_mod,          only: checker_tracers
 
@@ -36,8 +37,8 @@ private
 public :: fv3jedi_vc_vertremap
 
 type :: fv3jedi_vc_vertremap
- type(fv_atmos_type), allocatable :: Atm(:)
- logical, allocatable :: grids_on_this_pe(:)
+ type(fv_atmos_type), pointer :: Atm => null()
+ real(kind=kind_fv3), allocatable :: ak(:), bk(:)
  logical :: from_cold_start, checker_tr
  integer :: nt_checker
  contains
@@ -46,6 +47,18 @@ type :: fv3jedi_vc_vertremap
    procedure :: changevar
 end type fv3jedi_vc_vertremap
 
+! Building the Atm structure with fv_init initializes the whole dynamical core grid and dominates the
+! cost of a remap. The structures are kept for the life of the process, one for each distinct FMS
+! namelist, and shared by every instance. The ak/bk of an instance are set before each remap.
+type :: atm_context
+ character(len=:), allocatable :: namelist
+ type(fv_atmos_type), allocatable :: Atm(:)
+ logical, allocatable :: grids_on_this_pe(:)
+ type(atm_context), pointer :: next => null()
+end type atm_context
+
+type(atm_context), pointer, save :: atm_cache => null()
+
 ! --------------------------------------------------------------------------------------------------
 
 contains
@@ -58,7 +71,6 @@ class(fv3jedi_vc_vertremap), intent(inout) :: self
 type(fv3jedi_geom),          intent(in)    :: geom
 type(fckit_configuration),   intent(in)    :: conf
 
-integer :: gtile, p_split = 1, n
 logical :: checks_passed
 character(len=:), allocatable :: str
 type(fv3jedi_fmsnamelist) :: fmsnamelist
@@ -66,8 +78,8 @@ type(fv3jedi_fmsnamelist) :: fmsnamelist
 ! Prepare namelist
 call fmsnamelist%replace_namelist(conf)
 
-! Create Atm structure
-call fv_init(self%Atm, 300.0_kind_real, self%grids_on_this_pe, p_split, gtile, .true.)
+! Create or reuse the Atm structure
+call atm_context_get(self%Atm)
 
 ! Flag to use cold starts
 if( .not. conf%get('input is cold starts', self%from_cold_start) ) self%from_cold_start = .true.
@@ -81,29 +93,24 @@ if (.not. conf%get("source of inputs", str)) then
   str = 'FV3GFS GAUSSIAN NETCDF FILE'
 endif
 
-! Remapping needs nggps_ic to be true
-self%Atm(1)%flagstruct%nggps_ic = .true.
-
 ! ak/bk
-self%Atm(1)%ak = real(geom%ak,kind_fv3)
-self%Atm(1)%bk = real(geom%bk,kind_fv3)
-self%Atm%ptop = real(geom%ak(1),kind_fv3)
+allocate(self%ak(geom%npz+1))
+allocate(self%bk(geom%npz+1))
+self%ak = real(geom%ak,kind_fv3)
+self%bk = real(geom%bk,kind_fv3)
 
 ! Sanity checks
 checks_passed = .true.
-if (checks_passed) checks_passed = geom%npx == self%Atm(1)%npx
-if (checks_passed) checks_passed = geom%npy == self%Atm(1)%npy
-if (checks_passed) checks_passed = geom%npz == self%Atm(1)%npz
-if (checks_passed) checks_passed = geom%isd == self%Atm(1)%bd%isd
-if (checks_passed) checks_passed = geom%ied == self%Atm(1)%bd%ied
-if (checks_passed) checks_passed = geom%jsd == self%Atm(1)%bd%jsd
-if (checks_passed) checks_passed = geom%jed == self%Atm(1)%bd%jed
+if (checks_passed) checks_passed = geom%npx == self%Atm%npx
+if (checks_passed) checks_passed = geom%npy == self%Atm%npy
+if (checks_passed) checks_passed = geom%npz == self%Atm%npz
+if (checks_passed) checks_passed = geom%isd == self%Atm%bd%isd
+if (checks_passed) checks_passed = geom%ied == self%Atm%bd%ied
+if (checks_passed) checks_passed = geom%jsd == self%Atm%bd%jsd
+if (checks_passed) checks_passed = geom%jed == self%Atm%bd%jed
 if (.not.checks_passed) call abor1_ftn("fv3jedi_vc_vertremap_mod.field_fail: Geometry generated"// &
                                        " here does not match fv3-jedi geometry.")
 
-if (.not.size(self%Atm)==1) call abor1_ftn("fv3jedi_vc_vertremap_mod.field_fail: Atm strucutre"// &
-                                           " with size > 1 not supported.")
-
 ! Revert the fms namelist
 ! -----------------------
 call fmsnamelist%revert_namelist
@@ -116,15 +123,54 @@ subroutine delete(self)
 
 class(fv3jedi_vc_vertremap), intent(inout) :: self
 
-integer :: n
+! The Atm structure belongs to the process wide cache
+nullify(self%Atm)
+if (allocated(self%ak)) deallocate(self%ak)
+if (allocated(self%bk)) deallocate(self%bk)
+
+end subroutine delete
+
+! --------------------------------------------------------------------------------------------------
+
+subroutine atm_context_get(Atm)
 
-do n = 1,size(self%Atm)
-  call deallocate_fv_atmos_type(self%Atm(n))
+type(fv_atmos_type), pointer, intent(inout) :: Atm
+
+integer :: gtile, p_split = 1, n
+character(len=:), allocatable :: namelist
+type(atm_context), pointer :: context
+
+! The namelist read by fv_init identifies the Atm structure
+namelist = ''
+if (allocated(input_nml_file)) then
+  do n = 1, size(input_nml_file)
+    namelist = namelist//trim(input_nml_file(n))//new_line('a')
+  enddo
+endif
+
+! Reuse a structure built from the same namelist
+context => atm_cache
+do while (associated(context))
+  if (context%namelist == namelist) then
+    Atm => context%Atm(1)
+    return
+  endif
+  context => context%next
 enddo
-deallocate(self%Atm)
-deallocate(self%grids_on_this_pe)
 
-end subroutine delete
+! Create Atm structure
+allocate(context)
+context%namelist = namelist
+call fv_init(context%Atm, 300.0_kind_real, context%grids_on_this_pe, p_split, gtile, .true.)
+
+if (.not.size(context%Atm)==1) call abor1_ftn("fv3jedi_vc_vertremap_mod.field_fail: Atm strucutre"// &
+                                              " with size > 1 not supported.")
+
+context%next => atm_cache
+atm_cache => context
+Atm => context%Atm(1)
+
+end subroutine atm_context_get
 
 ! --------------------------------------------------------------------------------------------------
 
@@ -204,13 +250,21 @@ if ( xin%has_field(ps_fname) .and. xin%has_field(zh_fname) .and. &
      xin%has_field(ud_fname) .and. xin%has_field(vd_fname) ) then
 
   ! Shortcuts
-  Atm => self%Atm(1)
+  Atm => self%Atm
   isc = Atm%bd%is
   iec = Atm%bd%ie
   jsc = Atm%bd%js
   jec = Atm%bd%je
   npz = Atm%npz
 
+  ! Remapping needs nggps_ic to be true
+  Atm%flagstruct%nggps_ic = .true.
+
+  ! Target ak/bk, the Atm structure may be shared with instances on other levels
+  Atm%ak = self%ak
+  Atm%bk = self%bk
+  Atm%ptop = self%ak(1)
+
   ! Orography
   call xin%get_field('orog_filt', orog_filt)
   Atm%phis(isc:iec,jsc:jec) = real(orog_filt(isc:iec,jsc:jec,1),kind_fv3)*grav  ! Convert to phis
@@ -236,7 +290,6 @@ if ( xin%has_field(ps_fname) .and. xin%has_field(zh_fname) .and. &
   ! -------
   ! Number of tracers in Atm
   call get_number_tracers(MODEL_ATMOS, num_tracers=ntracers, num_prog=ntprog)
-  call get_number_tracers(MODEL_ATMOS, num_tracers=ntracers, num_prog=ntprog)
 
   ! initialize all tracers to default values prior to being input
   do nt = 1, ntprog
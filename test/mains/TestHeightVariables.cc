@@ -0,0 +1,223 @@
+/*
+ * (C) Copyright 2024 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "eckit/config/LocalConfiguration.h"
+#include "eckit/testing/Test.h"
+
+#include "oops/runs/Run.h"
+#include "oops/runs/Test.h"
+#include "oops/util/Logger.h"
+#include "test/TestEnvironment.h"
+
+#include "fv3jedi/VariableChange/Utils/HeightVariables.interface.h"
+
+namespace fv3jedi {
+namespace test {
+
+// -------------------------------------------------------------------------------------------------
+
+// Mid layer and interface pressures, temperature, specific humidity and surface geopotential of nx
+// by ny columns, varying smoothly between the columns. Arrays have the x index fastest and the
+// levels, from the top down, slowest.
+struct Columns {
+  int nx;
+  int ny;
+  int npz;
+  std::vector<double> prs;
+  std::vector<double> prsi;
+  std::vector<double> t;
+  std::vector<double> q;
+  std::vector<double> phis;
+};
+
+Columns makeColumns(const int nx, const int ny, const int npz) {
+  Columns cols{nx, ny, npz};
+  const size_t n2 = nx * ny;
+  cols.prs.resize(n2 * npz);
+  cols.prsi.resize(n2 * (npz + 1));
+  cols.t.resize(n2 * npz);
+  cols.q.resize(n2 * npz);
+  cols.phis.resize(n2);
+  for (int jj = 0; jj < ny; ++jj) {
+    for (int ji = 0; ji < nx; ++ji) {
+      const size_t ij = ji + nx * jj;
+      const double ps = 95000.0 + 3000.0 * std::sin(0.3 * ji + 0.7 * jj);
+      cols.phis[ij] = 9.80665 * 500.0 * (1.0 + std::cos(0.2 * ji - 0.5 * jj));
+      for (int jk = 0; jk <= npz; ++jk) {
+        const double sigma = static_cast<double>(jk) / npz;
+        cols.prsi[ij + n2 * jk] = 200.0 + (ps - 200.0) * std::pow(sigma, 1.5);
+      }
+      for (int jk = 0; jk < npz; ++jk) {
+        const double sigma = (jk + 0.5) / npz;
+        cols.prs[ij + n2 * jk] = 0.5 * (cols.prsi[ij + n2 * jk] + cols.prsi[ij + n2 * (jk + 1)]);
+        cols.t[ij + n2 * jk] = 210.0 + 85.0 * sigma
+                               + 2.0 * std::sin(0.1 * ji + 0.2 * jj + 0.3 * jk);
+        cols.q[ij + n2 * jk] = 1.0e-6 + 0.016 * std::pow(sigma, 3)
+                               * (1.0 + 0.1 * std::cos(0.4 * ji + jk));
+      }
+    }
+  }
+  return cols;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+// Deterministic values of amplitude scale that change sign from one point to the next
+std::vector<double> perturbation(const size_t size, const double scale, const double phase) {
+  std::vector<double> dx(size);
+  for (size_t jj = 0; jj < size; ++jj) {
+    dx[jj] = scale * std::sin(1.7 * jj + phase);
+  }
+  return dx;
+}
+
+double dot(const std::vector<double> & xx, const std::vector<double> & yy) {
+  double zz = 0.0;
+  for (size_t jj = 0; jj < xx.size(); ++jj) zz += xx[jj] * yy[jj];
+  return zz;
+}
+
+double sum(const std::vector<double> & xx) {
+  double zz = 0.0;
+  for (const double & val : xx) zz += val;
+  return zz;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void testAgainstReference() {
+  const eckit::LocalConfiguration config(::test::TestEnvironment::config(), "height variables");
+  const eckit::LocalConfiguration colsConfig(config, "columns");
+  const Columns cols = makeColumns(colsConfig.getInt("nx"), colsConfig.getInt("ny"),
+                                   colsConfig.getInt("levels"));
+  const double tolerance = config.getDouble("relative tolerance");
+  const size_t n2 = cols.nx * cols.ny;
+
+  // Sums of the heights computed by the column by column kernels before the block rewrite
+  for (const bool useCompress : {false, true}) {
+    const eckit::LocalConfiguration ref(config, useCompress ? "reference with compressibility"
+                                                             : "reference without compressibility");
+    std::vector<double> gph(n2 * cols.npz);
+    std::vector<double> gphi(n2 * (cols.npz + 1));
+    fv3jedi_geop_height_f90(cols.nx, cols.ny, cols.npz, useCompress, cols.prs.data(),
+                            cols.prsi.data(), cols.t.data(), cols.q.data(), cols.phis.data(),
+                            gph.data(), gphi.data());
+    const double gphSum = sum(gph);
+    const double gphiSum = sum(gphi);
+    oops::Log::test() << "Heights with compressibility " << useCompress << ": mid layer sum "
+                      << gphSum << ", interface sum " << gphiSum << std::endl;
+    EXPECT(std::abs(gphSum - ref.getDouble("mid layer sum"))
+           <= tolerance * std::abs(ref.getDouble("mid layer sum")));
+    EXPECT(std::abs(gphiSum - ref.getDouble("interface sum"))
+           <= tolerance * std::abs(ref.getDouble("interface sum")));
+    EXPECT(std::abs(gph[0] - ref.getDouble("first column top"))
+           <= tolerance * std::abs(ref.getDouble("first column top")));
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void testTangentLinearAndAdjoint() {
+  const eckit::LocalConfiguration config(::test::TestEnvironment::config(), "height variables");
+  const eckit::LocalConfiguration colsConfig(config, "columns");
+  const Columns cols = makeColumns(colsConfig.getInt("nx"), colsConfig.getInt("ny"),
+                                   colsConfig.getInt("levels"));
+  const size_t n2 = cols.nx * cols.ny;
+  const size_t n3 = n2 * cols.npz;
+
+  const std::vector<double> prsTl = perturbation(n3, 10.0, 0.1);
+  const std::vector<double> prsiTl = perturbation(n2 * (cols.npz + 1), 10.0, 0.2);
+  const std::vector<double> tTl = perturbation(n3, 1.0, 0.3);
+  const std::vector<double> qTl = perturbation(n3, 1.0e-4, 0.4);
+  std::vector<double> gphTl(n3);
+  fv3jedi_geop_height_tl_f90(cols.nx, cols.ny, cols.npz, cols.prs.data(), cols.prsi.data(),
+                             cols.t.data(), cols.q.data(), prsTl.data(), prsiTl.data(),
+                             tTl.data(), qTl.data(), gphTl.data());
+
+  // Tangent linear against centred finite differences of the nonlinear heights
+  const double eps = config.getDouble("finite difference step");
+  std::vector<Columns> moved(2, cols);
+  for (size_t jj = 0; jj < n3; ++jj) {
+    moved[0].prs[jj] += eps * prsTl[jj];
+    moved[0].t[jj] += eps * tTl[jj];
+    moved[0].q[jj] += eps * qTl[jj];
+    moved[1].prs[jj] -= eps * prsTl[jj];
+    moved[1].t[jj] -= eps * tTl[jj];
+    moved[1].q[jj] -= eps * qTl[jj];
+  }
+  for (size_t jj = 0; jj < prsiTl.size(); ++jj) {
+    moved[0].prsi[jj] += eps * prsiTl[jj];
+    moved[1].prsi[jj] -= eps * prsiTl[jj];
+  }
+  std::vector<std::vector<double>> gph(2, std::vector<double>(n3));
+  std::vector<double> gphi(n2 * (cols.npz + 1));
+  for (size_t jm = 0; jm < 2; ++jm) {
+    fv3jedi_geop_height_f90(cols.nx, cols.ny, cols.npz, false, moved[jm].prs.data(),
+                            moved[jm].prsi.data(), moved[jm].t.data(), moved[jm].q.data(),
+                            moved[jm].phis.data(), gph[jm].data(), gphi.data());
+  }
+  double diff2 = 0.0;
+  for (size_t jj = 0; jj < n3; ++jj) {
+    const double fd = (gph[0][jj] - gph[1][jj]) / (2.0 * eps);
+    diff2 += (fd - gphTl[jj]) * (fd - gphTl[jj]);
+  }
+  const double relDiff = std::sqrt(diff2 / dot(gphTl, gphTl));
+  oops::Log::test() << "Tangent linear against finite differences: " << relDiff << std::endl;
+  EXPECT(relDiff < config.getDouble("finite difference tolerance"));
+
+  // Adjoint test, <TL dx, dy> = <dx, AD dy>
+  const std::vector<double> dy = perturbation(n3, 1.0, 0.5);
+  std::vector<double> gphAd(dy);
+  std::vector<double> prsAd(n3, 0.0);
+  std::vector<double> prsiAd(prsiTl.size(), 0.0);
+  std::vector<double> tAd(n3, 0.0);
+  std::vector<double> qAd(n3, 0.0);
+  fv3jedi_geop_height_ad_f90(cols.nx, cols.ny, cols.npz, cols.prs.data(), cols.prsi.data(),
+                             cols.t.data(), cols.q.data(), prsAd.data(), prsiAd.data(),
+                             tAd.data(), qAd.data(), gphAd.data());
+  const double dot1 = dot(gphTl, dy);
+  const double dot2 = dot(prsTl, prsAd) + dot(prsiTl, prsiAd) + dot(tTl, tAd) + dot(qTl, qAd);
+  oops::Log::test() << "Adjoint test: <TL dx, dy> = " << dot1 << ", <dx, AD dy> = " << dot2
+                    << std::endl;
+  EXPECT(std::abs(dot1 - dot2) <= config.getDouble("dot product tolerance") * std::abs(dot1));
+}
+
+// -------------------------------------------------------------------------------------------------
+
+class HeightVariables : public oops::Test {
+ public:
+  HeightVariables() {}
+  virtual ~HeightVariables() {}
+
+ private:
+  std::string testid() const override {return "fv3jedi::test::HeightVariables";}
+
+  void register_tests() const override {
+    std::vector<eckit::testing::Test>& ts = eckit::testing::specification();
+    ts.emplace_back(CASE("fv3jedi/HeightVariables/testAgainstReference")
+      { testAgainstReference(); });
+    ts.emplace_back(CASE("fv3jedi/HeightVariables/testTangentLinearAndAdjoint")
+      { testTangentLinearAndAdjoint(); });
+  }
+
+  void clear() const override {}
+};
+
+// -------------------------------------------------------------------------------------------------
+
+}  // namespace test
+}  // namespace fv3jedi
+
+int main(int argc,  char ** argv) {
+  oops::Run run(argc, argv);
+  fv3jedi::test::HeightVariables tests;
+  return run.execute(tests);
+}
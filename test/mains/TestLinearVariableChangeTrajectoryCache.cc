@@ -0,0 +1,120 @@
+/*
+ * (C) Copyright 2024 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#include <string>
+#include <vector>
+
+#include "atlas/array.h"
+#include "atlas/field.h"
+
+#include "eckit/config/LocalConfiguration.h"
+#include "eckit/testing/Test.h"
+
+#include "oops/base/Variables.h"
+#include "oops/mpi/mpi.h"
+#include "oops/runs/Run.h"
+#include "oops/runs/Test.h"
+#include "test/TestEnvironment.h"
+
+#include "fv3jedi/Geometry/Geometry.h"
+#include "fv3jedi/LinearVariableChange/LinearVariableChange.h"
+#include "fv3jedi/State/State.h"
+
+namespace fv3jedi {
+namespace test {
+
+// -------------------------------------------------------------------------------------------------
+
+// Add delta to the first value of the first field of xx at a point owned by this task, or at a halo
+// point when halo is true
+void perturbState(const Geometry & geom, State & xx, const bool halo, const double delta) {
+  atlas::FieldSet fset;
+  xx.toFieldSet(fset);
+  const auto ghost = atlas::array::make_view<const int, 1>(geom.functionSpace().ghost());
+  auto view = atlas::array::make_view<double, 2>(fset[0]);
+  for (atlas::idx_t jnode = 0; jnode < view.shape(0); ++jnode) {
+    if (static_cast<bool>(ghost(jnode)) == halo) {
+      view(jnode, 0) += delta;
+      break;
+    }
+  }
+  xx.fromFieldSet(fset);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void testTrajectoryReuse() {
+  const eckit::LocalConfiguration config(::test::TestEnvironment::config());
+  const Geometry geom(eckit::LocalConfiguration(config, "geometry"), oops::mpi::world());
+  const eckit::LocalConfiguration lvcConfig(config, "linear variable change");
+  const oops::Variables vars(lvcConfig, "output variables");
+  State xx(geom, eckit::LocalConfiguration(config, "background"));
+
+  // The same background and settings share one trajectory
+  LinearVariableChange lvc1(geom, lvcConfig);
+  lvc1.changeVarTraj(xx, vars);
+  LinearVariableChange lvc2(geom, lvcConfig);
+  lvc2.changeVarTraj(xx, vars);
+  EXPECT(lvc1.sharesTrajectoryWith(lvc2));
+
+  // Values in the halo are not part of the background identity
+  State xxHalo(xx);
+  perturbState(geom, xxHalo, true, 1.0);
+  LinearVariableChange lvcHalo(geom, lvcConfig);
+  lvcHalo.changeVarTraj(xxHalo, vars);
+  EXPECT(lvcHalo.sharesTrajectoryWith(lvc1));
+
+  // A changed background gets its own trajectory
+  State xxChanged(xx);
+  perturbState(geom, xxChanged, false, 1.0);
+  LinearVariableChange lvcChanged(geom, lvcConfig);
+  lvcChanged.changeVarTraj(xxChanged, vars);
+  EXPECT(!lvcChanged.sharesTrajectoryWith(lvc1));
+
+  // Recomputing the trajectory of an instance replaces it
+  lvc2.changeVarTraj(xxChanged, vars);
+  EXPECT(lvc2.sharesTrajectoryWith(lvcChanged));
+  EXPECT(!lvc2.sharesTrajectoryWith(lvc1));
+
+  // Another Geometry instance does not share, even with the same content
+  const Geometry geomCopy(geom);
+  LinearVariableChange lvcCopy(geomCopy, lvcConfig);
+  lvcCopy.changeVarTraj(xx, vars);
+  EXPECT(!lvcCopy.sharesTrajectoryWith(lvc1));
+}
+
+// -------------------------------------------------------------------------------------------------
+
+class LinearVariableChangeTrajectoryCache : public oops::Test {
+ public:
+  LinearVariableChangeTrajectoryCache() {}
+  virtual ~LinearVariableChangeTrajectoryCache() {}
+
+ private:
+  std::string testid() const override {
+    return "fv3jedi::test::LinearVariableChangeTrajectoryCache";
+  }
+
+  void register_tests() const override {
+    std::vector<eckit::testing::Test>& ts = eckit::testing::specification();
+    ts.emplace_back(CASE("fv3jedi/LinearVariableChangeTrajectoryCache/testTrajectoryReuse")
+      { testTrajectoryReuse(); });
+  }
+
+  void clear() const override {}
+};
+
+// -------------------------------------------------------------------------------------------------
+
+}  // namespace test
+}  // namespace fv3jedi
+
+int main(int argc,  char ** argv) {
+  oops::Run run(argc, argv);
+  fv3jedi::test::LinearVariableChangeTrajectoryCache tests;
+  return run.execute(tests);
+}
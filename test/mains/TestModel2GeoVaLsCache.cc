@@ -0,0 +1,95 @@
+/*
+ * (C) Copyright 2024 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#include <string>
+#include <vector>
+
+#include "atlas/array.h"
+#include "atlas/field.h"
+
+#include "eckit/config/LocalConfiguration.h"
+#include "eckit/testing/Test.h"
+
+#include "oops/base/Variables.h"
+#include "oops/mpi/mpi.h"
+#include "oops/runs/Run.h"
+#include "oops/runs/Test.h"
+#include "test/TestEnvironment.h"
+
+#include "fv3jedi/Geometry/Geometry.h"
+#include "fv3jedi/State/State.h"
+#include "fv3jedi/VariableChange/Model2GeoVaLs/VarChaModel2GeoVaLs.h"
+
+namespace fv3jedi {
+namespace test {
+
+// -------------------------------------------------------------------------------------------------
+
+void testOutputReuse() {
+  const eckit::LocalConfiguration config(::test::TestEnvironment::config());
+  const Geometry geom(eckit::LocalConfiguration(config, "geometry"), oops::mpi::world());
+  const eckit::LocalConfiguration vcConfig(config, "variable change");
+  const oops::Variables vars(vcConfig, "output variables");
+  const State xx(geom, eckit::LocalConfiguration(config, "state"));
+  const VarChaModel2GeoVaLs vc(geom, vcConfig);
+
+  // First call computes the output
+  State xout1(geom, vars, xx.validTime());
+  vc.changeVar(xx, xout1);
+  EXPECT(vc.computations() == 1);
+
+  // A second call on the unchanged state, or on a copy of it, reuses the output
+  State xout2(geom, vars, xx.validTime());
+  vc.changeVar(xx, xout2);
+  EXPECT(vc.computations() == 1);
+  const State xcopy(xx);
+  State xout3(geom, vars, xx.validTime());
+  vc.changeVar(xcopy, xout3);
+  EXPECT(vc.computations() == 1);
+  EXPECT(xout3.norm() == xout1.norm());
+
+  // A call after the state has been modified computes the output again
+  State xmod(xx);
+  atlas::FieldSet fset;
+  xmod.toFieldSet(fset);
+  auto view = atlas::array::make_view<double, 2>(fset[0]);
+  view(0, 0) += 1.0;
+  xmod.fromFieldSet(fset);
+  State xout4(geom, vars, xx.validTime());
+  vc.changeVar(xmod, xout4);
+  EXPECT(vc.computations() == 2);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+class Model2GeoVaLsCache : public oops::Test {
+ public:
+  Model2GeoVaLsCache() {}
+  virtual ~Model2GeoVaLsCache() {}
+
+ private:
+  std::string testid() const override {return "fv3jedi::test::Model2GeoVaLsCache";}
+
+  void register_tests() const override {
+    std::vector<eckit::testing::Test>& ts = eckit::testing::specification();
+    ts.emplace_back(CASE("fv3jedi/Model2GeoVaLsCache/testOutputReuse")
+      { testOutputReuse(); });
+  }
+
+  void clear() const override {}
+};
+
+// -------------------------------------------------------------------------------------------------
+
+}  // namespace test
+}  // namespace fv3jedi
+
+int main(int argc,  char ** argv) {
+  oops::Run run(argc, argv);
+  fv3jedi::test::Model2GeoVaLsCache tests;
+  return run.execute(tests);
+}
@@ -0,0 +1,91 @@
+/*
+ * (C) Copyright 2024 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "eckit/config/LocalConfiguration.h"
+#include "eckit/testing/Test.h"
+
+#include "oops/runs/Run.h"
+#include "oops/runs/Test.h"
+#include "oops/util/Logger.h"
+#include "test/TestEnvironment.h"
+
+#include "fv3jedi/Utilities/Constants.h"
+#include "fv3jedi/VariableChange/Utils/SaturationTables.interface.h"
+
+namespace fv3jedi {
+namespace test {
+
+// -------------------------------------------------------------------------------------------------
+
+void testTableAgainstFormula() {
+  const eckit::LocalConfiguration config(::test::TestEnvironment::config(), "saturation tables");
+  const double tmin = config.getDouble("minimum temperature");
+  const double tmax = config.getDouble("maximum temperature");
+  const int n = config.getInt("number of temperatures");
+  const double tolerance = config.getDouble("relative tolerance");
+
+  // Temperatures spread over the range, most of them between table entries
+  std::vector<double> temperature(n);
+  for (int jj = 0; jj < n; ++jj) {
+    temperature[jj] = tmin + (tmax - tmin) * jj / (n - 1);
+  }
+  std::vector<double> esTable(n);
+  std::vector<double> esDirect(n);
+  fv3jedi_saturation_tables_es_water_f90(n, temperature.data(), esTable.data(), esDirect.data());
+
+  double maxRelDiff = 0.0;
+  for (int jj = 0; jj < n; ++jj) {
+    EXPECT(esDirect[jj] > 0.0);
+    maxRelDiff = std::max(maxRelDiff, std::abs(esTable[jj] - esDirect[jj]) / esDirect[jj]);
+  }
+  oops::Log::test() << "Maximum relative difference of tabulated es_water: " << maxRelDiff
+                    << std::endl;
+  EXPECT(maxRelDiff < tolerance);
+
+  // Below the first entry the lookup is clamped to the first entry
+  const double tFirst = getConstant("tice") - 160.0;
+  const std::vector<double> tBelow{tFirst - 10.0, tFirst};
+  std::vector<double> esBelow(2);
+  std::vector<double> esBelowDirect(2);
+  fv3jedi_saturation_tables_es_water_f90(2, tBelow.data(), esBelow.data(), esBelowDirect.data());
+  EXPECT(esBelow[0] == esBelow[1]);
+  EXPECT(std::abs(esBelow[1] - esBelowDirect[1]) <= tolerance * esBelowDirect[1]);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+class SaturationTables : public oops::Test {
+ public:
+  SaturationTables() {}
+  virtual ~SaturationTables() {}
+
+ private:
+  std::string testid() const override {return "fv3jedi::test::SaturationTables";}
+
+  void register_tests() const override {
+    std::vector<eckit::testing::Test>& ts = eckit::testing::specification();
+    ts.emplace_back(CASE("fv3jedi/SaturationTables/testTableAgainstFormula")
+      { testTableAgainstFormula(); });
+  }
+
+  void clear() const override {}
+};
+
+// -------------------------------------------------------------------------------------------------
+
+}  // namespace test
+}  // namespace fv3jedi
+
+int main(int argc,  char ** argv) {
+  oops::Run run(argc, argv);
+  fv3jedi::test::SaturationTables tests;
+  return run.execute(tests);
+}
@@ -0,0 +1,139 @@
+/*
+ * (C) Copyright 2024 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "atlas/field.h"
+
+#include "eckit/config/LocalConfiguration.h"
+#include "eckit/testing/Test.h"
+
+#include "oops/mpi/mpi.h"
+#include "oops/runs/Run.h"
+#include "oops/runs/Test.h"
+#include "test/TestEnvironment.h"
+
+#include "fv3jedi/Geometry/Geometry.h"
+#include "fv3jedi/Geometry/TimeInvariantFieldsHelpers.h"
+
+namespace fv3jedi {
+namespace test {
+
+// -------------------------------------------------------------------------------------------------
+
+// Cache file written by this task
+std::string cacheFileOfTask(const std::string & directory, const int rank) {
+  std::ostringstream suffix;
+  suffix << "_" << std::setw(6) << std::setfill('0') << rank << ".bin";
+  std::vector<std::string> files;
+  for (const auto & entry : std::filesystem::directory_iterator(directory)) {
+    const std::string name = entry.path().filename().string();
+    if (name.rfind("fv3jedi_time_invariant_", 0) == 0 && name.size() > suffix.str().size()
+        && name.compare(name.size() - suffix.str().size(), std::string::npos, suffix.str()) == 0) {
+      files.push_back(entry.path().string());
+    }
+  }
+  EXPECT(files.size() == 1);
+  return files.front();
+}
+
+// -------------------------------------------------------------------------------------------------
+
+// Fields of ref and their values, halos included, are found in fset
+void expectSameFields(const atlas::FieldSet & ref, const atlas::FieldSet & fset) {
+  for (const auto & field : ref) {
+    EXPECT(fset.has(field.name()));
+    const auto refView = atlas::array::make_view<const double, 2>(field);
+    const auto view = atlas::array::make_view<const double, 2>(fset.field(field.name()));
+    EXPECT(view.size() == refView.size());
+    for (size_t jj = 0; jj < refView.size(); ++jj) {
+      EXPECT(view.data()[jj] == refView.data()[jj]);
+    }
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void testWriteThenRead() {
+  const eckit::LocalConfiguration geomConfig(::test::TestEnvironment::config(), "geometry");
+  const eckit::LocalConfiguration timeInvConfig(geomConfig, "time invariant fields");
+  const std::string directory = timeInvConfig.getString("cache directory");
+  const eckit::mpi::Comm & comm = oops::mpi::world();
+
+  // Start without a cache
+  if (comm.rank() == 0) {
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+  }
+  comm.barrier();
+
+  // Fields computed from the inputs, the cache is written
+  const Geometry computed(geomConfig, comm);
+  const std::string filename = cacheFileOfTask(directory, comm.rank());
+
+  // The cache holds the time-invariant fields with their halos, which are clean
+  atlas::FieldSet cached;
+  EXPECT(readTimeInvariantFieldsCache(filename, computed.functionSpace(), cached));
+  EXPECT(cached.has("nominal_surface_pressure"));
+  expectSameFields(cached, computed.fields());
+  for (const auto & field : cached) {
+    EXPECT(!field.dirty());
+  }
+
+  // A Geometry constructed again reads the cache and has the same fields
+  const Geometry restored(geomConfig, comm);
+  expectSameFields(cached, restored.fields());
+
+  // A truncated cache is ignored
+  const std::string truncated = filename + ".truncated";
+  {
+    std::ifstream in(filename, std::ios::binary);
+    std::vector<char> bytes(std::filesystem::file_size(filename) / 2);
+    in.read(bytes.data(), bytes.size());
+    std::ofstream out(truncated, std::ios::binary);
+    out.write(bytes.data(), bytes.size());
+  }
+  atlas::FieldSet partial;
+  EXPECT(!readTimeInvariantFieldsCache(truncated, computed.functionSpace(), partial));
+  EXPECT(partial.size() == 0);
+  std::filesystem::remove(truncated);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+class TimeInvariantFieldsCache : public oops::Test {
+ public:
+  TimeInvariantFieldsCache() {}
+  virtual ~TimeInvariantFieldsCache() {}
+
+ private:
+  std::string testid() const override {return "fv3jedi::test::TimeInvariantFieldsCache";}
+
+  void register_tests() const override {
+    std::vector<eckit::testing::Test>& ts = eckit::testing::specification();
+    ts.emplace_back(CASE("fv3jedi/TimeInvariantFieldsCache/testWriteThenRead")
+      { testWriteThenRead(); });
+  }
+
+  void clear() const override {}
+};
+
+// -------------------------------------------------------------------------------------------------
+
+}  // namespace test
+}  // namespace fv3jedi
+
+int main(int argc,  char ** argv) {
+  oops::Run run(argc, argv);
+  fv3jedi::test::TimeInvariantFieldsCache tests;
+  return run.execute(tests);
+}
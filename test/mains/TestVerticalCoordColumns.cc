@@ -0,0 +1,98 @@
+/*
+ * (C) Copyright 2024 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "eckit/config/LocalConfiguration.h"
+#include "eckit/testing/Test.h"
+
+#include "oops/mpi/mpi.h"
+#include "oops/runs/Run.h"
+#include "oops/runs/Test.h"
+#include "test/TestEnvironment.h"
+
+#include "fv3jedi/Geometry/Geometry.h"
+#include "fv3jedi/State/State.h"
+
+namespace fv3jedi {
+namespace test {
+
+// -------------------------------------------------------------------------------------------------
+
+void testColumnsOfState() {
+  const eckit::LocalConfiguration geomConfig(::test::TestEnvironment::config(), "geometry");
+  const eckit::LocalConfiguration stateConfig(::test::TestEnvironment::config(), "state");
+  const Geometry geom(geomConfig, oops::mpi::world());
+  const State xx(geom, stateConfig);
+
+  const std::vector<int> indices = geom.get_indices();
+  const size_t npz = indices[6];
+  const size_t ncol = (indices[1] - indices[0] + 1) * (indices[3] - indices[2] + 1);
+
+  // Pressure of every column increases downwards
+  const std::vector<double> pressure = geom.verticalCoordColumns(xx, "pressure");
+  EXPECT(pressure.size() == npz * ncol);
+  for (size_t jcol = 0; jcol < ncol; ++jcol) {
+    EXPECT(pressure[jcol * npz] > 0.0);
+    for (size_t jlev = 1; jlev < npz; ++jlev) {
+      EXPECT(pressure[jcol * npz + jlev] > pressure[jcol * npz + jlev - 1]);
+    }
+  }
+
+  // Log-pressure of the same columns
+  const std::vector<double> logp = geom.verticalCoordColumns(xx, "logp");
+  for (size_t jj = 0; jj < pressure.size(); ++jj) {
+    EXPECT(std::abs(logp[jj] + std::log(pressure[jj])) <= 1.0e-12 * std::abs(logp[jj]));
+  }
+
+  // A copy has the version of its source and the same columns
+  const State copy(xx);
+  EXPECT(copy.version() == xx.version());
+  EXPECT(geom.verticalCoordColumns(copy, "pressure") == pressure);
+
+  // Writing the fields changes the version, the columns follow the new surface pressure
+  State half(xx);
+  half.zero();
+  half.accumul(0.5, xx);
+  EXPECT(half.version() != xx.version());
+  const std::vector<double> & halfPressure = geom.verticalCoordColumns(half, "pressure");
+  for (size_t jcol = 0; jcol < ncol; ++jcol) {
+    EXPECT(halfPressure[(jcol + 1) * npz - 1] < pressure[(jcol + 1) * npz - 1]);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+class VerticalCoordColumns : public oops::Test {
+ public:
+  VerticalCoordColumns() {}
+  virtual ~VerticalCoordColumns() {}
+
+ private:
+  std::string testid() const override {return "fv3jedi::test::VerticalCoordColumns";}
+
+  void register_tests() const override {
+    std::vector<eckit::testing::Test>& ts = eckit::testing::specification();
+    ts.emplace_back(CASE("fv3jedi/VerticalCoordColumns/testColumnsOfState")
+      { testColumnsOfState(); });
+  }
+
+  void clear() const override {}
+};
+
+// -------------------------------------------------------------------------------------------------
+
+}  // namespace test
+}  // namespace fv3jedi
+
+int main(int argc,  char ** argv) {
+  oops::Run run(argc, argv);
+  fv3jedi::test::VerticalCoordColumns tests;
+  return run.execute(tests);
+}